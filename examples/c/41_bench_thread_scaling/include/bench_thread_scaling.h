@@ -0,0 +1,16 @@
+#ifndef BENCH_THREAD_SCALING_H
+#define BENCH_THREAD_SCALING_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_thread_scaling/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,115 @@
+#include <bench_thread_scaling.h>
+#include <math.h>
+
+#define ENTITY_COUNT (100000)
+#define WARMUP_FRAMES (10)
+#define MEASURE_FRAMES (100)
+#define MAX_THREADS (64)
+
+/* Component types */
+typedef struct Vector2D {
+    float x;
+    float y;
+} Vector2D;
+
+typedef Vector2D Position;
+typedef Vector2D Velocity;
+typedef float Mass;
+
+/* Cheap system, runs on all entities */
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x += v[i].x * rows->delta_time;
+        p[i].y += v[i].y * rows->delta_time;
+    }
+}
+
+/* Expensive system, only matches a subset of the tables. Without balancing,
+ * the threads that are assigned these tables finish last. */
+void Gravity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Velocity, v, 1);
+    ECS_COLUMN(rows, Mass, m, 2);
+
+    int i, j;
+    for (i = 0; i < rows->count; i ++) {
+        float f = 0;
+        for (j = 1; j < 64; j ++) {
+            f += sqrtf(m[i] * j) / j;
+        }
+        v[i].y -= f * rows->delta_time;
+    }
+}
+
+static
+double run(
+    int argc,
+    char *argv[],
+    uint32_t threads)
+{
+    ecs_world_t *world = ecs_init_w_args(argc, argv);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+    ECS_TAG(world, TagC);
+    ECS_TYPE(world, Body, Position, Velocity);
+    ECS_TYPE(world, HeavyBody, Position, Velocity, Mass);
+    ECS_TYPE(world, BodyA, Position, Velocity, TagA);
+    ECS_TYPE(world, BodyB, Position, Velocity, TagB);
+    ECS_TYPE(world, HeavyBodyC, Position, Velocity, Mass, TagC);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, Velocity);
+    ECS_SYSTEM(world, Gravity, EcsOnUpdate, Velocity, Mass);
+
+    /* Create tables of different sizes, with the expensive entities in only
+     * two of them */
+    ecs_new_w_count(world, Body, ENTITY_COUNT / 2);
+    ecs_new_w_count(world, BodyA, ENTITY_COUNT / 4);
+    ecs_new_w_count(world, BodyB, ENTITY_COUNT / 8);
+    ecs_new_w_count(world, HeavyBody, ENTITY_COUNT / 16);
+    ecs_new_w_count(world, HeavyBodyC, ENTITY_COUNT / 100);
+
+    ecs_set_threads(world, threads);
+
+    int i;
+    for (i = 0; i < WARMUP_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    ecs_time_t start;
+    ecs_time_measure(&start);
+
+    for (i = 0; i < MEASURE_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    double t = ecs_time_measure(&start);
+
+    ecs_fini(world);
+
+    return t / MEASURE_FRAMES;
+}
+
+int main(int argc, char *argv[]) {
+    double base = 0;
+    uint32_t threads;
+
+    printf("threads   ms/frame   speedup\n");
+
+    for (threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        double t = run(argc, argv, threads);
+        if (threads == 1) {
+            base = t;
+        }
+
+        printf("%7u   %8.3f   %7.2f\n", threads, t * 1000, base / t);
+    }
+
+    return 0;
+}
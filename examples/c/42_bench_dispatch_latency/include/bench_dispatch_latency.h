@@ -0,0 +1,16 @@
+#ifndef BENCH_DISPATCH_LATENCY_H
+#define BENCH_DISPATCH_LATENCY_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_dispatch_latency/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,77 @@
+#include <bench_dispatch_latency.h>
+
+#define ENTITY_COUNT (1000)
+#define WARMUP_FRAMES (100)
+#define MEASURE_FRAMES (10000)
+#define MULTI_THREADED_PHASES (4)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+/* System does very little work, so that frame time is dominated by the time it
+ * takes to wake up worker threads and wait for them to finish */
+void Touch(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+double run(
+    uint32_t threads,
+    float spin_time)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    /* One system in each of the phases that runs on worker threads */
+    ecs_new_system(world, "TouchPreUpdate", EcsPreUpdate, "Position", Touch);
+    ecs_new_system(world, "TouchOnUpdate", EcsOnUpdate, "Position", Touch);
+    ecs_new_system(world, "TouchOnValidate", EcsOnValidate, "Position", Touch);
+    ecs_new_system(world, "TouchPostUpdate", EcsPostUpdate, "Position", Touch);
+
+    ecs_new_w_count(world, Position, ENTITY_COUNT);
+
+    ecs_set_thread_spin_time(world, spin_time);
+    ecs_set_threads(world, threads);
+
+    int i;
+    for (i = 0; i < WARMUP_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    ecs_time_t start;
+    ecs_time_measure(&start);
+
+    for (i = 0; i < MEASURE_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    double t = ecs_time_measure(&start);
+
+    ecs_fini(world);
+
+    return t / (MEASURE_FRAMES * MULTI_THREADED_PHASES);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t threads;
+
+    printf("threads   park (us/phase)   spin (us/phase)\n");
+
+    for (threads = 2; threads <= 16; threads *= 2) {
+        double t_park = run(threads, 0);
+        double t_spin = run(threads, 0.00005);
+
+        printf("%7u   %15.2f   %15.2f\n", 
+            threads, t_park * 1000000, t_spin * 1000000);
+    }
+
+    return 0;
+}
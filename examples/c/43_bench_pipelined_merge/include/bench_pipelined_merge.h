@@ -0,0 +1,16 @@
+#ifndef BENCH_PIPELINED_MERGE_H
+#define BENCH_PIPELINED_MERGE_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_pipelined_merge/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,106 @@
+#include <bench_pipelined_merge.h>
+
+#define ENTITY_COUNT (10000)
+#define WARMUP_FRAMES (10)
+#define MEASURE_FRAMES (500)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+typedef struct Velocity {
+    float x;
+    float y;
+} Velocity;
+
+typedef float Mass;
+
+typedef bool Tag;
+
+/* Changes the components of entities, which requires a merge */
+void ToggleTag(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Tag, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        if (ecs_has(rows->world, rows->entities[i], Tag)) {
+            ecs_remove(rows->world, rows->entities[i], Tag);
+        } else {
+            ecs_add(rows->world, rows->entities[i], Tag);
+        }
+    }
+}
+
+/* Does not access the components changed by ToggleTag */
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x += v[i].x;
+        p[i].y += v[i].y;
+    }
+}
+
+static
+double run(
+    uint32_t threads,
+    bool pipelined)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_COMPONENT(world, Tag);
+
+    ecs_new_system(world, "ToggleTag", EcsPreUpdate, "Mass, .Tag", ToggleTag);
+    ecs_new_system(world, "MoveOnUpdate", EcsOnUpdate, "Position, Velocity", Move);
+    ecs_new_system(world, "MoveOnValidate", EcsOnValidate, "Position, Velocity", Move);
+    ecs_new_system(world, "MovePostUpdate", EcsPostUpdate, "Position, Velocity", Move);
+
+    ecs_new_w_count(world, Mass, ENTITY_COUNT);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+    ecs_new_w_count(world, Movable, ENTITY_COUNT);
+
+    ecs_set_pipelined_merge(world, pipelined);
+    ecs_set_threads(world, threads);
+
+    int i;
+    for (i = 0; i < WARMUP_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    ecs_time_t start;
+    ecs_time_measure(&start);
+
+    for (i = 0; i < MEASURE_FRAMES; i ++) {
+        ecs_progress(world, 1.0 / 60.0);
+    }
+
+    double t = ecs_time_measure(&start);
+
+    ecs_fini(world);
+
+    return t / MEASURE_FRAMES;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t threads;
+
+    printf("threads   strict (us/frame)   pipelined (us/frame)   saved (us/frame)\n");
+
+    for (threads = 2; threads <= 16; threads *= 2) {
+        double t_strict = run(threads, false);
+        double t_pipelined = run(threads, true);
+
+        printf("%7u   %17.2f   %20.2f   %16.2f\n", 
+            threads, t_strict * 1000000, t_pipelined * 1000000,
+            (t_strict - t_pipelined) * 1000000);
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_MAP_H
+#define BENCH_MAP_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_map/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
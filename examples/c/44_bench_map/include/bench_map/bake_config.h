@@ -0,0 +1,44 @@
+/*
+                                   )
+                                  (.)
+                                  .|.
+                                  | |
+                              _.--| |--._
+                           .-';  ;`-'& ; `&.
+                          \   &  ;    &   &_/
+                           |"""---...---"""|
+                           \ | | | | | | | /
+                            `---.|.|.|.---'
+
+ * This file is generated by bake.lang.c for your convenience. Headers of
+ * dependencies will automatically show up in this file. Include bake_config.h
+ * in your main project file. Do not edit! */
+
+#ifndef BENCH_MAP_BAKE_CONFIG_H
+#define BENCH_MAP_BAKE_CONFIG_H
+
+/* Headers of public dependencies */
+#include <flecs.h>
+
+/* Headers of private dependencies */
+#ifdef BENCH_MAP_IMPL
+/* No dependencies */
+#endif
+
+/* Convenience macro for exporting symbols */
+#ifndef BENCH_MAP_STATIC
+  #if BENCH_MAP_IMPL && (defined(_MSC_VER) || defined(__MINGW32__))
+    #define BENCH_MAP_EXPORT __declspec(dllexport)
+  #elif BENCH_MAP_IMPL
+    #define BENCH_MAP_EXPORT __attribute__((__visibility__("default")))
+  #elif defined _MSC_VER
+    #define BENCH_MAP_EXPORT __declspec(dllimport)
+  #else
+    #define BENCH_MAP_EXPORT
+  #endif
+#else
+  #define BENCH_MAP_EXPORT
+#endif
+
+#endif
+
@@ -0,0 +1,53 @@
+#ifndef CHAINED_MAP_H
+#define CHAINED_MAP_H
+
+typedef struct chained_map_t chained_map_t;
+
+typedef struct chained_map_iter_t {
+    chained_map_t *map;
+    uint32_t bucket_index;
+    uint32_t node;
+} chained_map_iter_t;
+
+chained_map_t* chained_map_new(
+    uint32_t size,
+    uint32_t elem_size);
+
+void chained_map_free(
+    chained_map_t *map);
+
+uint32_t chained_map_count(
+    chained_map_t *map);
+
+uint32_t chained_map_data_size(
+    chained_map_t *map);
+
+void* _chained_map_set(
+    chained_map_t *map,
+    uint64_t key_hash,
+    const void *data,
+    uint32_t size);
+
+#define chained_map_set(map, key, data)\
+    _chained_map_set(map, key, data, sizeof(*data));
+
+void* chained_map_get_ptr(
+    chained_map_t *map,
+    uint64_t key_hash);
+
+int chained_map_remove(
+    chained_map_t *map,
+    uint64_t key_hash);
+
+chained_map_iter_t chained_map_iter(
+    chained_map_t *map);
+
+bool chained_map_hasnext(
+    chained_map_iter_t *it);
+
+void* chained_map_next_w_key_w_size(
+    chained_map_iter_t *it,
+    uint64_t *key_out,
+    size_t size);
+
+#endif
@@ -0,0 +1,246 @@
+#include <bench_map.h>
+#include "chained_map.h"
+
+#define MEASURE_RUNS (5)
+
+typedef struct map_api_t {
+    const char *name;
+    void* (*new)(uint32_t size, uint32_t elem_size);
+    void (*free)(void *map);
+    void* (*set)(void *map, uint64_t key, const void *data, uint32_t size);
+    void* (*get_ptr)(void *map, uint64_t key);
+    int (*remove)(void *map, uint64_t key);
+    uint64_t (*sum)(void *map);
+} map_api_t;
+
+typedef struct results_t {
+    double insert;
+    double lookup_hit;
+    double lookup_miss;
+    double iter;
+    double remove;
+} results_t;
+
+/* -- Adapters, so both maps can be driven by the same benchmark code -- */
+
+static
+void* open_new(uint32_t size, uint32_t elem_size) {
+    return ecs_map_new(size, elem_size);
+}
+
+static
+void open_free(void *map) {
+    ecs_map_free(map);
+}
+
+static
+void* open_set(void *map, uint64_t key, const void *data, uint32_t size) {
+    return _ecs_map_set(map, key, data, size);
+}
+
+static
+void* open_get_ptr(void *map, uint64_t key) {
+    return ecs_map_get_ptr(map, key);
+}
+
+static
+int open_remove(void *map, uint64_t key) {
+    return ecs_map_remove(map, key);
+}
+
+static
+uint64_t open_sum(void *map) {
+    uint64_t result = 0;
+    ecs_map_iter_t it = ecs_map_iter(map);
+    while (ecs_map_hasnext(&it)) {
+        result += ecs_map_next64(&it);
+    }
+    return result;
+}
+
+static
+void* chained_new(uint32_t size, uint32_t elem_size) {
+    return chained_map_new(size, elem_size);
+}
+
+static
+void chained_free(void *map) {
+    chained_map_free(map);
+}
+
+static
+void* chained_set(void *map, uint64_t key, const void *data, uint32_t size) {
+    return _chained_map_set(map, key, data, size);
+}
+
+static
+void* chained_get_ptr(void *map, uint64_t key) {
+    return chained_map_get_ptr(map, key);
+}
+
+static
+int chained_remove(void *map, uint64_t key) {
+    return chained_map_remove(map, key);
+}
+
+static
+uint64_t chained_sum(void *map) {
+    uint64_t result = 0;
+    chained_map_iter_t it = chained_map_iter(map);
+    while (chained_map_hasnext(&it)) {
+        result += *(uint64_t*)chained_map_next_w_key_w_size(
+            &it, NULL, sizeof(uint64_t));
+    }
+    return result;
+}
+
+static const map_api_t open_map = {
+    "open", open_new, open_free, open_set, open_get_ptr, open_remove, open_sum
+};
+
+static const map_api_t chained_map = {
+    "chained", chained_new, chained_free, chained_set, chained_get_ptr,
+    chained_remove, chained_sum
+};
+
+/* -- Benchmark -- */
+
+static
+uint64_t rand_key(
+    uint64_t *state)
+{
+    /* xorshift64, spreads keys over the full 64 bit range like type hashes */
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static
+void fill_keys(
+    uint64_t *keys,
+    uint64_t *misses,
+    uint32_t count,
+    bool random)
+{
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        if (random) {
+            keys[i] = rand_key(&state);
+            misses[i] = rand_key(&state);
+        } else {
+            /* Sequential ids, like the entity index */
+            keys[i] = i + 1;
+            misses[i] = count + i + 1;
+        }
+    }
+}
+
+static
+void run(
+    const map_api_t *api,
+    const uint64_t *keys,
+    const uint64_t *misses,
+    uint32_t count,
+    results_t *r)
+{
+    uint64_t check = 0;
+    uint32_t i;
+    ecs_time_t start;
+
+    void *map = api->new(0, sizeof(uint64_t));
+
+    ecs_time_measure(&start);
+    for (i = 0; i < count; i ++) {
+        uint64_t v = i;
+        api->set(map, keys[i], &v, sizeof(uint64_t));
+    }
+    r->insert += ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < count; i ++) {
+        check += *(uint64_t*)api->get_ptr(map, keys[i]);
+    }
+    r->lookup_hit += ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < count; i ++) {
+        check += api->get_ptr(map, misses[i]) != NULL;
+    }
+    r->lookup_miss += ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    check += api->sum(map);
+    r->iter += ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < count; i ++) {
+        check += api->remove(map, keys[i]);
+    }
+    r->remove += ecs_time_measure(&start);
+
+    api->free(map);
+
+    /* Expected: sum of hits (twice, lookup + iter), no misses, no failures */
+    uint64_t expect = (uint64_t)count * (count - 1);
+    if (check != expect) {
+        printf("%s: unexpected result (%llu != %llu)\n", api->name,
+            (unsigned long long)check, (unsigned long long)expect);
+    }
+}
+
+static
+void bench(
+    uint32_t count,
+    bool random)
+{
+    uint64_t *keys = ecs_os_malloc(count * sizeof(uint64_t));
+    uint64_t *misses = ecs_os_malloc(count * sizeof(uint64_t));
+    fill_keys(keys, misses, count, random);
+
+    results_t open_r = {0}, chained_r = {0};
+
+    int i;
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        run(&chained_map, keys, misses, count, &chained_r);
+        run(&open_map, keys, misses, count, &open_r);
+    }
+
+    double ns = 1000000000.0 / (MEASURE_RUNS * count);
+
+    printf("%u %s keys (ns per operation)\n", count,
+        random ? "random" : "sequential");
+    printf("  %-12s %10s %10s %10s\n", "", "chained", "open", "speedup");
+    printf("  %-12s %10.2f %10.2f %9.2fx\n", "insert",
+        chained_r.insert * ns, open_r.insert * ns,
+        chained_r.insert / open_r.insert);
+    printf("  %-12s %10.2f %10.2f %9.2fx\n", "lookup hit",
+        chained_r.lookup_hit * ns, open_r.lookup_hit * ns,
+        chained_r.lookup_hit / open_r.lookup_hit);
+    printf("  %-12s %10.2f %10.2f %9.2fx\n", "lookup miss",
+        chained_r.lookup_miss * ns, open_r.lookup_miss * ns,
+        chained_r.lookup_miss / open_r.lookup_miss);
+    printf("  %-12s %10.2f %10.2f %9.2fx\n", "iterate",
+        chained_r.iter * ns, open_r.iter * ns,
+        chained_r.iter / open_r.iter);
+    printf("  %-12s %10.2f %10.2f %9.2fx\n", "remove",
+        chained_r.remove * ns, open_r.remove * ns,
+        chained_r.remove / open_r.remove);
+
+    ecs_os_free(keys);
+    ecs_os_free(misses);
+}
+
+int main(int argc, char *argv[]) {
+    ecs_os_set_api_defaults();
+
+    bench(1000, false);
+    bench(1000, true);
+    bench(1000000, false);
+    bench(1000000, true);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_ADD_REMOVE_H
+#define BENCH_ADD_REMOVE_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_add_remove/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
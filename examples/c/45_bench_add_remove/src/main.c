@@ -0,0 +1,102 @@
+#include <bench_add_remove.h>
+
+#define ENTITY_COUNT (100000)
+#define MEASURE_RUNS (10)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+typedef struct Velocity {
+    float x;
+    float y;
+} Velocity;
+
+typedef struct Rotation {
+    float angle;
+} Rotation;
+
+typedef float Mass;
+
+typedef struct results_t {
+    double add;
+    double remove;
+} results_t;
+
+/* Add and remove a type to all entities, and measure each operation */
+static
+void run(
+    ecs_world_t *world,
+    ecs_entity_t *entities,
+    ecs_type_t type,
+    results_t *r)
+{
+    ecs_time_t start;
+    int i;
+
+    ecs_time_measure(&start);
+    for (i = 0; i < ENTITY_COUNT; i ++) {
+        _ecs_add(world, entities[i], type);
+    }
+    r->add += ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < ENTITY_COUNT; i ++) {
+        _ecs_remove(world, entities[i], type);
+    }
+    r->remove += ecs_time_measure(&start);
+}
+
+static
+void bench(
+    ecs_world_t *world,
+    const char *label,
+    ecs_type_t base,
+    ecs_type_t type)
+{
+    ecs_entity_t *entities = ecs_os_malloc(ENTITY_COUNT * sizeof(ecs_entity_t));
+    int i;
+    for (i = 0; i < ENTITY_COUNT; i ++) {
+        entities[i] = _ecs_new(world, base);
+    }
+
+    results_t r = {0};
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        run(world, entities, type, &r);
+    }
+
+    double ns = 1000000000.0 / (MEASURE_RUNS * ENTITY_COUNT);
+    printf("  %-32s %10.2f %10.2f\n", label, r.add * ns, r.remove * ns);
+
+    ecs_os_free(entities);
+}
+
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Rotation);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG(world, Tag);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+    ECS_TYPE(world, Body, Position, Velocity, Rotation);
+
+    printf("%u entities (ns per operation)\n", ENTITY_COUNT);
+    printf("  %-32s %10s %10s\n", "", "add", "remove");
+
+    bench(world, "Velocity to Position", 
+        ecs_type(Position), ecs_type(Velocity));
+    bench(world, "Tag to Position, Velocity", 
+        ecs_type(Movable), ecs_type(Tag));
+    bench(world, "Mass to Position, Velocity", 
+        ecs_type(Movable), ecs_type(Mass));
+    bench(world, "Mass to Position, Velocity, Rot", 
+        ecs_type(Body), ecs_type(Mass));
+
+    ecs_fini(world);
+
+    return 0;
+}
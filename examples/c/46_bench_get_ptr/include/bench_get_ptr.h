@@ -0,0 +1,16 @@
+#ifndef BENCH_GET_PTR_H
+#define BENCH_GET_PTR_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_get_ptr/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,44 @@
+/*
+                                   )
+                                  (.)
+                                  .|.
+                                  | |
+                              _.--| |--._
+                           .-';  ;`-'& ; `&.
+                          \   &  ;    &   &_/
+                           |"""---...---"""|
+                           \ | | | | | | | /
+                            `---.|.|.|.---'
+
+ * This file is generated by bake.lang.c for your convenience. Headers of
+ * dependencies will automatically show up in this file. Include bake_config.h
+ * in your main project file. Do not edit! */
+
+#ifndef BENCH_GET_PTR_BAKE_CONFIG_H
+#define BENCH_GET_PTR_BAKE_CONFIG_H
+
+/* Headers of public dependencies */
+#include <flecs.h>
+
+/* Headers of private dependencies */
+#ifdef BENCH_GET_PTR_IMPL
+/* No dependencies */
+#endif
+
+/* Convenience macro for exporting symbols */
+#ifndef BENCH_GET_PTR_STATIC
+  #if BENCH_GET_PTR_IMPL && (defined(_MSC_VER) || defined(__MINGW32__))
+    #define BENCH_GET_PTR_EXPORT __declspec(dllexport)
+  #elif BENCH_GET_PTR_IMPL
+    #define BENCH_GET_PTR_EXPORT __attribute__((__visibility__("default")))
+  #elif defined _MSC_VER
+    #define BENCH_GET_PTR_EXPORT __declspec(dllimport)
+  #else
+    #define BENCH_GET_PTR_EXPORT
+  #endif
+#else
+  #define BENCH_GET_PTR_EXPORT
+#endif
+
+#endif
+
@@ -0,0 +1,81 @@
+#include <bench_get_ptr.h>
+
+#define ENTITY_COUNT (10000)
+#define COMPONENT_COUNT (40)
+#define MEASURE_RUNS (200)
+
+typedef struct Value {
+    float value[4];
+} Value;
+
+/* Creates entities with COMPONENT_COUNT components, and measures getting
+ * components from each of the entities. If offset is larger than
+ * ECS_HI_COMPONENT_ID, component ids are too large for the direct index. */
+static
+void bench(
+    uint32_t offset)
+{
+    ecs_world_t *world = ecs_init();
+
+    /* Use up ids, so that components get the ids we want */
+    if (offset) {
+        ecs_new_w_count(world, 0, offset);
+    }
+
+    /* Component ids are not copied, so they must outlive the world */
+    static char ids[COMPONENT_COUNT][16];
+    ecs_entity_t components[COMPONENT_COUNT];
+    ecs_type_t types[COMPONENT_COUNT];
+    ecs_type_t type = NULL;
+
+    int i;
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        sprintf(ids[i], "C%d", i);
+        components[i] = ecs_new_component(world, ids[i], sizeof(Value));
+        types[i] = ecs_type_from_entity(world, components[i]);
+        type = ecs_type_merge(world, type, types[i], 0);
+    }
+
+    ecs_entity_t first = _ecs_new_w_count(world, type, ENTITY_COUNT);
+
+    /* Measure getting the first and the last component in the type, since a
+     * linear search for a component gets slower towards the end of a type */
+    printf("  first component id %-8u", (uint32_t)components[0]);
+
+    int c;
+    for (c = 0; c < COMPONENT_COUNT; c += COMPONENT_COUNT - 1) {
+        ecs_time_t start;
+        ecs_time_measure(&start);
+
+        uintptr_t check = 0;
+        int r;
+        for (r = 0; r < MEASURE_RUNS; r ++) {
+            for (i = 0; i < ENTITY_COUNT; i ++) {
+                check += (uintptr_t)_ecs_get_ptr(world, first + i, types[c]);
+            }
+        }
+
+        double t = ecs_time_measure(&start);
+
+        if (!check) {
+            printf("unexpected result\n");
+        }
+
+        printf(" %10.2f", t * 1000000000.0 / (MEASURE_RUNS * ENTITY_COUNT));
+    }
+
+    printf("\n");
+
+    ecs_fini(world);
+}
+
+int main(int argc, char *argv[]) {
+    printf("%u entities, %u components (ns per ecs_get_ptr)\n", 
+        ENTITY_COUNT, COMPONENT_COUNT);
+    printf("  %-28s %10s %10s\n", "", "first", "last");
+
+    bench(0);
+    bench(1000);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_TYPE_MEMORY_H
+#define BENCH_TYPE_MEMORY_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_type_memory/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
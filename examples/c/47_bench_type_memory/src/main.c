@@ -0,0 +1,156 @@
+#include <bench_type_memory.h>
+
+#define COMPONENT_COUNT (64)
+#define TYPE_COUNT (10000)
+#define TYPE_SIZE (6)
+#define MEASURE_RUNS (10)
+
+/* Keep track of the number of bytes in use by prefixing each allocation with
+ * its size. */
+static int64_t bytes_in_use;
+
+typedef union alloc_header_t {
+    size_t size;
+    double align;
+} alloc_header_t;
+
+static
+void* track_malloc(
+    size_t size)
+{
+    alloc_header_t *hdr = malloc(sizeof(alloc_header_t) + size);
+    hdr->size = size;
+    bytes_in_use += size;
+    return hdr + 1;
+}
+
+static
+void* track_calloc(
+    size_t num,
+    size_t size)
+{
+    alloc_header_t *hdr = calloc(1, sizeof(alloc_header_t) + num * size);
+    hdr->size = num * size;
+    bytes_in_use += num * size;
+    return hdr + 1;
+}
+
+static
+void* track_realloc(
+    void *ptr,
+    size_t size)
+{
+    if (!ptr) {
+        return track_malloc(size);
+    }
+
+    alloc_header_t *hdr = (alloc_header_t*)ptr - 1;
+    bytes_in_use += (int64_t)size - (int64_t)hdr->size;
+    hdr = realloc(hdr, sizeof(alloc_header_t) + size);
+    hdr->size = size;
+    return hdr + 1;
+}
+
+static
+void track_free(
+    void *ptr)
+{
+    if (ptr) {
+        alloc_header_t *hdr = (alloc_header_t*)ptr - 1;
+        bytes_in_use -= hdr->size;
+        free(hdr);
+    }
+}
+
+static
+char* track_strdup(
+    const char *str)
+{
+    size_t len = strlen(str);
+    char *result = track_malloc(len + 1);
+    memcpy(result, str, len + 1);
+    return result;
+}
+
+/* Register TYPE_COUNT random types of TYPE_SIZE components, and measure the
+ * memory used by the types and the time it takes to look them up again. If
+ * offset is set, components are created with large ids. */
+static
+void bench(
+    const char *label,
+    uint32_t offset)
+{
+    ecs_world_t *world = ecs_init();
+
+    if (offset) {
+        ecs_new_w_count(world, 0, offset);
+    }
+
+    /* Component ids are not copied, so they must outlive the world */
+    static char ids[COMPONENT_COUNT][16];
+    ecs_entity_t components[COMPONENT_COUNT];
+
+    int i, j;
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        sprintf(ids[i], "C%d", i);
+        components[i] = ecs_new_component(world, ids[i], sizeof(float));
+    }
+
+    ecs_entity_t *arrays = ecs_os_malloc(
+        TYPE_COUNT * TYPE_SIZE * sizeof(ecs_entity_t));
+
+    srand(1);
+    for (i = 0; i < TYPE_COUNT; i ++) {
+        for (j = 0; j < TYPE_SIZE; j ++) {
+            arrays[i * TYPE_SIZE + j] = components[rand() % COMPONENT_COUNT];
+        }
+    }
+
+    /* Register types */
+    int64_t bytes_before = bytes_in_use;
+    ecs_time_t start;
+    ecs_time_measure(&start);
+    for (i = 0; i < TYPE_COUNT; i ++) {
+        ecs_type_find(world, &arrays[i * TYPE_SIZE], TYPE_SIZE);
+    }
+    double t_create = ecs_time_measure(&start);
+    int64_t bytes = bytes_in_use - bytes_before;
+
+    /* Lookup existing types */
+    double t_find = 0;
+    int r;
+    for (r = 0; r < MEASURE_RUNS; r ++) {
+        ecs_time_measure(&start);
+        for (i = 0; i < TYPE_COUNT; i ++) {
+            ecs_type_find(world, &arrays[i * TYPE_SIZE], TYPE_SIZE);
+        }
+        t_find += ecs_time_measure(&start);
+    }
+
+    printf("  %-16s %12.1f %12.2f %12.2f\n", label, 
+        (double)bytes / 1024.0, 
+        t_create * 1000000000.0 / TYPE_COUNT,
+        t_find * 1000000000.0 / (TYPE_COUNT * MEASURE_RUNS));
+
+    ecs_os_free(arrays);
+    ecs_fini(world);
+}
+
+int main(int argc, char *argv[]) {
+    ecs_os_set_api_defaults();
+    ecs_os_api_t api = ecs_os_api;
+    api.malloc = track_malloc;
+    api.calloc = track_calloc;
+    api.realloc = track_realloc;
+    api.free = track_free;
+    api.strdup = track_strdup;
+    ecs_os_set_api(&api);
+
+    printf("%u types of %u components\n", TYPE_COUNT, TYPE_SIZE);
+    printf("  %-16s %12s %12s %12s\n", "", "KB", "create (ns)", "find (ns)");
+
+    bench("low ids", 0);
+    bench("high ids", 1000);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_FILTER_ITER_H
+#define BENCH_FILTER_ITER_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_filter_iter/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,142 @@
+#include <bench_filter_iter.h>
+
+#define COMPONENT_COUNT (12)
+#define RARE_TABLE_COUNT (8)
+#define MEASURE_RUNS (1000)
+#define SYSTEM_COUNT (100)
+
+typedef struct Value {
+    float value;
+} Value;
+
+static
+void Dummy(ecs_rows_t *rows) { }
+
+/* Create a table for each combination of COMPONENT_COUNT components, and add
+ * a rare component to a few of them. Then measure iterating filters and
+ * queries, and matching systems for the rare component. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    /* Component ids are not copied, so they must outlive the world */
+    static char ids[COMPONENT_COUNT][16];
+    ecs_type_t types[COMPONENT_COUNT];
+
+    int i, j;
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        sprintf(ids[i], "C%d", i);
+        ecs_entity_t c = ecs_new_component(world, ids[i], sizeof(Value));
+        types[i] = ecs_type_from_entity(world, c);
+    }
+
+    ECS_COMPONENT(world, Value);
+
+    int table_count = 1 << COMPONENT_COUNT;
+    for (i = 1; i < table_count; i ++) {
+        ecs_type_t type = NULL;
+        for (j = 0; j < COMPONENT_COUNT; j ++) {
+            if (i & (1 << j)) {
+                type = ecs_type_merge(world, type, types[j], 0);
+            }
+        }
+
+        if (i % (table_count / RARE_TABLE_COUNT) == 0) {
+            type = ecs_type_merge(world, type, ecs_type(Value), 0);
+        }
+
+        _ecs_new(world, type);
+    }
+
+    printf("%d tables, %d with rare component\n", 
+        table_count - 1, RARE_TABLE_COUNT - 1);
+
+    /* Iterate filter */
+    ecs_filter_t filter = {.include = ecs_type(Value)};
+    ecs_time_t start;
+    int entity_count = 0;
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_filter_iter_t it = ecs_filter_iter(world, &filter);
+        while (ecs_filter_next(&it)) {
+            entity_count += it.rows.count;
+        }
+    }
+    double t_filter = ecs_time_measure(&start);
+
+    /* Iterate query, which caches the matched tables */
+    ecs_query_t *query = ecs_query_new(world, &filter);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_query_iter_t it = ecs_query_iter(query);
+        while (ecs_query_next(&it)) {
+            entity_count += it.rows.count;
+        }
+    }
+    double t_query = ecs_time_measure(&start);
+
+    /* Query for a common component, for which the component index does not
+     * reduce the number of tables to evaluate */
+    ecs_filter_t common = {.include = types[0]};
+    ecs_query_t *common_query = ecs_query_new(world, &common);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_filter_iter_t it = ecs_filter_iter(world, &common);
+        while (ecs_filter_next(&it)) {
+            entity_count += it.rows.count;
+        }
+    }
+    double t_common_filter = ecs_time_measure(&start);
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_query_iter_t it = ecs_query_iter(common_query);
+        while (ecs_query_next(&it)) {
+            entity_count += it.rows.count;
+        }
+    }
+    double t_common_query = ecs_time_measure(&start);
+
+    /* Exclude a component that most tables don't have. Excluded components
+     * are not in the component index, so this tests each type. */
+    ecs_filter_t exclude = {.include = types[0], .exclude = ecs_type(Value)};
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_filter_iter_t it = ecs_filter_iter(world, &exclude);
+        while (ecs_filter_next(&it)) {
+            entity_count += it.rows.count;
+        }
+    }
+    double t_exclude_filter = ecs_time_measure(&start);
+
+    /* Count entities */
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        entity_count += ecs_count(world, Value);
+    }
+    double t_count = ecs_time_measure(&start);
+
+    /* Create systems, which are matched with all existing tables */
+    static char sys_ids[SYSTEM_COUNT][16];
+    ecs_time_measure(&start);
+    for (i = 0; i < SYSTEM_COUNT; i ++) {
+        sprintf(sys_ids[i], "Dummy%d", i);
+        ecs_new_system(world, sys_ids[i], EcsOnUpdate, "Value", Dummy);
+    }
+    double t_system = ecs_time_measure(&start);
+
+    printf("  filter iter   %10.2f us\n", t_filter * 1000000.0 / MEASURE_RUNS);
+    printf("  query iter    %10.2f us\n", t_query * 1000000.0 / MEASURE_RUNS);
+    printf("  filter (common) %8.2f us\n", t_common_filter * 1000000.0 / MEASURE_RUNS);
+    printf("  query (common)  %8.2f us\n", t_common_query * 1000000.0 / MEASURE_RUNS);
+    printf("  filter (exclude) %7.2f us\n", t_exclude_filter * 1000000.0 / MEASURE_RUNS);
+    printf("  count         %10.2f us\n", t_count * 1000000.0 / MEASURE_RUNS);
+    printf("  new system    %10.2f us\n", t_system * 1000000.0 / SYSTEM_COUNT);
+
+    ecs_fini(world);
+
+    return entity_count == 0;
+}
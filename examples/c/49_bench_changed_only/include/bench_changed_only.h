@@ -0,0 +1,16 @@
+#ifndef BENCH_CHANGED_ONLY_H
+#define BENCH_CHANGED_ONLY_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_changed_only/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
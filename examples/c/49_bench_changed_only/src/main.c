@@ -0,0 +1,125 @@
+#include <bench_changed_only.h>
+
+#define COMPONENT_COUNT (8)
+#define ENTITIES_PER_TABLE (100)
+#define MEASURE_RUNS (1000)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+typedef struct Velocity {
+    float x;
+    float y;
+} Velocity;
+
+static
+void Read(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    float *sum = rows->param;
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        *sum += p[i].x + p[i].y;
+    }
+}
+
+static
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x += v[i].x;
+        p[i].y += v[i].y;
+    }
+}
+
+static
+double measure(
+    ecs_world_t *world)
+{
+    ecs_time_t start;
+    ecs_time_measure(&start);
+
+    int i;
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    return ecs_time_measure(&start) * 1000000.0 / MEASURE_RUNS;
+}
+
+/* Create a table for each combination of COMPONENT_COUNT tags, each with
+ * Position. Then measure a frame in which a system reads Position, when
+ * nothing changed, and when a single table changed. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    /* Tag ids are not copied, so they must outlive the world */
+    static char ids[COMPONENT_COUNT][16];
+    ecs_type_t tags[COMPONENT_COUNT];
+
+    int i, j;
+    for (i = 0; i < COMPONENT_COUNT; i ++) {
+        sprintf(ids[i], "Tag%d", i);
+        tags[i] = ecs_type_from_entity(world, ecs_new_component(world, ids[i], 0));
+    }
+
+    int table_count = 1 << COMPONENT_COUNT;
+    ecs_entity_t first = 0;
+    for (i = 0; i < table_count; i ++) {
+        ecs_type_t type = ecs_type(Position);
+        for (j = 0; j < COMPONENT_COUNT; j ++) {
+            if (i & (1 << j)) {
+                type = ecs_type_merge(world, type, tags[j], 0);
+            }
+        }
+
+        ecs_entity_t e = _ecs_new_w_count(world, type, ENTITIES_PER_TABLE);
+        if (!first) {
+            first = e;
+        }
+    }
+
+    /* Entities with Velocity are in a separate table */
+    ecs_new_w_count(world, Velocity, ENTITIES_PER_TABLE);
+
+    float sum = 0;
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_context(world, Read, &sum);
+
+    printf("%d tables, %d entities (us per frame)\n", 
+        table_count, table_count * ENTITIES_PER_TABLE);
+
+    double t_all = measure(world);
+
+    ecs_set_system_changed_only(world, Read, true);
+    double t_idle = measure(world);
+
+    ecs_time_t start;
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_set(world, first, Position, {i, i});
+        ecs_progress(world, 0);
+    }
+    double t_one = ecs_time_measure(&start) * 1000000.0 / MEASURE_RUNS;
+
+    /* Systems that write components mark their tables as changed */
+    ECS_SYSTEM(world, Move, EcsPreUpdate, Position, Velocity);
+    double t_move = measure(world);
+
+    printf("  all tables        %8.2f us\n", t_all);
+    printf("  changed (idle)    %8.2f us\n", t_idle);
+    printf("  changed (1 set)   %8.2f us\n", t_one);
+    printf("  changed (1 move)  %8.2f us\n", t_move);
+
+    ecs_fini(world);
+
+    return sum == 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_COLUMN_ALIGNMENT_H
+#define BENCH_COLUMN_ALIGNMENT_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_column_alignment/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
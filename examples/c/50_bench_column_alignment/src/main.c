@@ -0,0 +1,98 @@
+#include <bench_column_alignment.h>
+
+#define TABLE_COUNT (256)
+#define ENTITIES_PER_TABLE (61)
+#define MEASURE_RUNS (10000)
+
+/* Number of floats in a 64 byte block */
+#define BLOCK (16)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+typedef struct Velocity {
+    float x;
+    float y;
+} Velocity;
+
+/* Loop over the exact number of values, which requires the compiler to emit a
+ * scalar tail and to handle unaligned data */
+static
+void Move(ecs_rows_t *rows) {
+    float *p = (float*)ecs_column(rows, Position, 1);
+    float *v = (float*)ecs_column(rows, Velocity, 2);
+
+    int i, count = rows->count * 2;
+    for (i = 0; i < count; i ++) {
+        p[i] += v[i];
+    }
+}
+
+/* Loop over whole 64 byte blocks. Columns are aligned and padded to 64 bytes,
+ * so this reads and writes past the last entity, but not past the allocation */
+static
+void MovePadded(ecs_rows_t *rows) {
+    float *p = __builtin_assume_aligned(ecs_column(rows, Position, 1), 64);
+    float *v = __builtin_assume_aligned(ecs_column(rows, Velocity, 2), 64);
+
+    int i, count = (rows->count * 2 + BLOCK - 1) & ~(BLOCK - 1);
+    for (i = 0; i < count; i ++) {
+        p[i] += v[i];
+    }
+}
+
+static
+double measure(
+    ecs_world_t *world,
+    ecs_entity_t system)
+{
+    ecs_time_t start;
+    ecs_time_measure(&start);
+
+    int i;
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_run(world, system, 0, NULL);
+    }
+
+    return ecs_time_measure(&start) * 1000000.0 / MEASURE_RUNS;
+}
+
+/* Create TABLE_COUNT small tables with Position and Velocity, and compare a
+ * loop with a scalar tail with a loop that processes whole blocks. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    /* Tag ids are not copied, so they must outlive the world */
+    static char ids[TABLE_COUNT][16];
+
+    int i;
+    for (i = 0; i < TABLE_COUNT; i ++) {
+        sprintf(ids[i], "Tag%d", i);
+        ecs_entity_t tag = ecs_new_component(world, ids[i], 0);
+        ecs_type_t type = ecs_type_merge(
+            world, ecs_type(Movable), ecs_type_from_entity(world, tag), 0);
+        _ecs_new_w_count(world, type, ENTITIES_PER_TABLE);
+    }
+
+    ECS_SYSTEM(world, Move, EcsManual, Position, Velocity);
+    ECS_SYSTEM(world, MovePadded, EcsManual, Position, Velocity);
+
+    /* Warm up */
+    measure(world, Move);
+    measure(world, MovePadded);
+
+    printf("%d tables, %d entities per table (us per run)\n", 
+        TABLE_COUNT, ENTITIES_PER_TABLE);
+    printf("  %-32s %10.2f\n", "scalar tail", measure(world, Move));
+    printf("  %-32s %10.2f\n", "padded blocks", measure(world, MovePadded));
+
+    ecs_fini(world);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_REF_REALLOC_H
+#define BENCH_REF_REALLOC_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_ref_realloc/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
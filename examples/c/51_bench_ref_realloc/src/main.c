@@ -0,0 +1,90 @@
+#include <bench_ref_realloc.h>
+
+#define SYSTEM_COUNT (64)
+#define TABLE_COUNT (256)
+#define ENTITIES_PER_TABLE (10)
+#define MEASURE_RUNS (1000)
+
+typedef struct Position {
+    float x;
+    float y;
+} Position;
+
+typedef float Mass;
+
+static
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Mass, m, 1);
+    ECS_COLUMN(rows, Position, p, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x += *m;
+    }
+}
+
+/* Measure frames in which nothing is created, and frames in which an entity is
+ * created in a new table. Creating the first entity of a table allocates its
+ * columns, which before required resolving the references of all systems. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+    ECS_ENTITY(world, Source, Mass);
+
+    ecs_set(world, Source, Mass, {1});
+
+    /* Ids are not copied, so they must outlive the world */
+    static char ids[TABLE_COUNT + MEASURE_RUNS][16];
+
+    int i;
+    for (i = 0; i < TABLE_COUNT + MEASURE_RUNS; i ++) {
+        sprintf(ids[i], "Tag%d", i);
+    }
+
+    for (i = 0; i < TABLE_COUNT; i ++) {
+        ecs_entity_t tag = ecs_new_component(world, ids[i], 0);
+        ecs_type_t type = ecs_type_merge(world, 
+            ecs_type(Position), ecs_type_from_entity(world, tag), 0);
+        _ecs_new_w_count(world, type, ENTITIES_PER_TABLE);
+    }
+
+    for (i = 0; i < SYSTEM_COUNT; i ++) {
+        ecs_new_system(world, NULL, EcsOnUpdate, "Source.Mass, Position", Move);
+    }
+
+    /* Create the tags for the new tables upfront, so that only the cost of
+     * creating the entity is measured */
+    ecs_type_t *types = ecs_os_malloc(sizeof(ecs_type_t) * MEASURE_RUNS);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_entity_t tag = ecs_new_component(world, ids[TABLE_COUNT + i], 0);
+        types[i] = ecs_type_merge(world, 
+            ecs_type(Position), ecs_type_from_entity(world, tag), 0);
+    }
+
+    ecs_progress(world, 0);
+
+    ecs_time_t start;
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_progress(world, 0);
+    }
+    double idle = ecs_time_measure(&start) * 1000000.0 / MEASURE_RUNS;
+
+    ecs_time_measure(&start);
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        _ecs_new(world, types[i]);
+        ecs_progress(world, 0);
+    }
+    double grow = ecs_time_measure(&start) * 1000000.0 / MEASURE_RUNS;
+
+    printf("%d systems, %d tables (us per frame)\n", SYSTEM_COUNT, TABLE_COUNT);
+    printf("  %-32s %10.2f\n", "no new entities", idle);
+    printf("  %-32s %10.2f\n", "entity in new table", grow);
+
+    ecs_os_free(types);
+    ecs_fini(world);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_DELETE_IN_PROGRESS_H
+#define BENCH_DELETE_IN_PROGRESS_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_delete_in_progress/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
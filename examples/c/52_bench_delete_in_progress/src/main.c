@@ -0,0 +1,79 @@
+#include <bench_delete_in_progress.h>
+
+#define ENTITY_COUNT (100000)
+#define MEASURE_RUNS (50)
+
+typedef struct Vector {
+    float x;
+    float y;
+} Vector;
+
+typedef Vector Position;
+typedef Vector Velocity;
+typedef float Mass;
+
+static
+void DeleteEven(ecs_rows_t *rows) {
+    int i;
+    for (i = 0; i < rows->count; i += 2) {
+        ecs_delete(rows->world, rows->entities[i]);
+    }
+}
+
+static
+void DeleteAll(ecs_rows_t *rows) {
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_delete(rows->world, rows->entities[i]);
+    }
+}
+
+static
+double measure(
+    ecs_world_t *world,
+    ecs_type_t type,
+    ecs_entity_t system)
+{
+    double total = 0;
+    int i;
+
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_delete_w_filter(world, &(ecs_filter_t){
+            .include = type
+        });
+
+        _ecs_new_w_count(world, type, ENTITY_COUNT);
+
+        ecs_time_t start;
+        ecs_time_measure(&start);
+        ecs_run(world, system, 0, NULL);
+        total += ecs_time_measure(&start);
+    }
+
+    return total * 1000.0 / MEASURE_RUNS;
+}
+
+/* Measure the time it takes to run a system that deletes entities, including
+ * merging the deletes into the table once the system is done. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TYPE(world, Movable, Position, Velocity, Mass);
+
+    ECS_SYSTEM(world, DeleteEven, EcsManual, Position, Velocity, Mass);
+    ECS_SYSTEM(world, DeleteAll, EcsManual, Position, Velocity, Mass);
+
+    double half = measure(world, ecs_type(Movable), DeleteEven);
+    double all = measure(world, ecs_type(Movable), DeleteAll);
+
+    printf("%d entities (ms per run)\n", ENTITY_COUNT);
+    printf("  %-32s %10.2f\n", "delete every other entity", half);
+    printf("  %-32s %10.2f\n", "delete all entities", all);
+
+    ecs_fini(world);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCH_SPARSE_TOGGLE_H
+#define BENCH_SPARSE_TOGGLE_H
+
+/* This generated file contains includes for project dependencies */
+#include "bench_sparse_toggle/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
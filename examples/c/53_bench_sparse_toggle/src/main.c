@@ -0,0 +1,70 @@
+#include <bench_sparse_toggle.h>
+
+#define ENTITY_COUNT (100000)
+#define MEASURE_RUNS (50)
+
+typedef struct Vector {
+    float x;
+    float y;
+} Vector;
+
+typedef Vector Position;
+typedef Vector Velocity;
+typedef float Mass;
+
+static
+double measure(
+    ecs_world_t *world,
+    ecs_entity_t start,
+    ecs_type_t tag)
+{
+    double total = 0;
+    int i, e;
+
+    for (i = 0; i < MEASURE_RUNS; i ++) {
+        ecs_time_t t_start;
+        ecs_time_measure(&t_start);
+
+        for (e = 0; e < ENTITY_COUNT; e ++) {
+            _ecs_add(world, start + e, tag);
+        }
+
+        for (e = 0; e < ENTITY_COUNT; e ++) {
+            _ecs_remove(world, start + e, tag);
+        }
+
+        total += ecs_time_measure(&t_start);
+    }
+
+    return total * 1000.0 / MEASURE_RUNS;
+}
+
+/* Measure the time it takes to add and remove a tag on many entities, when the
+ * tag is stored in the table of an entity and when it is stored in a sparse
+ * set. Tables store the tag in the entity type, so that toggling it moves the
+ * entity with all of its components to another table. */
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG(world, Stunned);
+    ECS_TAG(world, Dirty);
+    ECS_TYPE(world, Movable, Position, Velocity, Mass);
+
+    ecs_set_sparse(world, Dirty);
+
+    ecs_entity_t start = ecs_new_w_count(world, Movable, ENTITY_COUNT);
+
+    double table = measure(world, start, ecs_type(Stunned));
+    double sparse = measure(world, start, ecs_type(Dirty));
+
+    printf("%d entities (ms per add + remove)\n", ENTITY_COUNT);
+    printf("  %-32s %10.2f\n", "toggle tag stored in table", table);
+    printf("  %-32s %10.2f\n", "toggle sparse tag", sparse);
+
+    ecs_fini(world);
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+/* This generated file contains includes for project dependencies */
+#include "query/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,44 @@
+/*
+                                   )
+                                  (.)
+                                  .|.
+                                  | |
+                              _.--| |--._
+                           .-';  ;`-'& ; `&.
+                          \   &  ;    &   &_/
+                           |"""---...---"""|
+                           \ | | | | | | | /
+                            `---.|.|.|.---'
+
+ * This file is generated by bake.lang.c for your convenience. Headers of
+ * dependencies will automatically show up in this file. Include bake_config.h
+ * in your main project file. Do not edit! */
+
+#ifndef QUERY_BAKE_CONFIG_H
+#define QUERY_BAKE_CONFIG_H
+
+/* Headers of public dependencies */
+#include <flecs.h>
+
+/* Headers of private dependencies */
+#ifdef QUERY_IMPL
+/* No dependencies */
+#endif
+
+/* Convenience macro for exporting symbols */
+#ifndef QUERY_STATIC
+  #if QUERY_IMPL && (defined(_MSC_VER) || defined(__MINGW32__))
+    #define QUERY_EXPORT __declspec(dllexport)
+  #elif QUERY_IMPL
+    #define QUERY_EXPORT __attribute__((__visibility__("default")))
+  #elif defined _MSC_VER
+    #define QUERY_EXPORT __declspec(dllimport)
+  #else
+    #define QUERY_EXPORT
+  #endif
+#else
+  #define QUERY_EXPORT
+#endif
+
+#endif
+
@@ -44,6 +44,7 @@ typedef struct ecs_world_t ecs_world_t;
 typedef struct ecs_rows_t ecs_rows_t;
 typedef struct ecs_reference_t ecs_reference_t;
 typedef struct ecs_snapshot_t ecs_snapshot_t;
+typedef struct ecs_query_t ecs_query_t;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,6 +175,7 @@ typedef const char *EcsId;
 /** Component that contains metadata about a component */
 typedef struct EcsComponent {
     uint32_t size;
+    uint32_t alignment; /* Required alignment of the component (0 if none) */
 } EcsComponent;
 
 /** Metadata of an explicitly created type (ECS_TYPE or ecs_new_type) */
@@ -299,6 +301,24 @@ extern ecs_type_t
     (void)ecs_entity(id);\
     (void)ecs_type(id);\
 
+/** Declare a component with a required alignment.
+ * This macro declares a new component like ECS_COMPONENT, but also specifies
+ * the alignment of the component. Component data is stored in columns that are
+ * aligned at 64 bytes, which satisfies the alignment of most types. Only types
+ * that require a larger alignment need to be declared with this macro. The
+ * alignment must be a power of two, and the size of the type must be a multiple
+ * of the alignment.
+ *
+ * Example:
+ * ECS_ALIGNED_COMPONENT(world, Page, 4096);
+ */
+#define ECS_ALIGNED_COMPONENT(world, id, alignment) \
+    ECS_ENTITY_VAR(id) = ecs_new_component_w_alignment(\
+        world, #id, sizeof(id), alignment);\
+    ECS_TYPE_VAR(id) = ecs_type_from_entity(world, ecs_entity(id));\
+    (void)ecs_entity(id);\
+    (void)ecs_type(id);\
+
 /** Declare a tag. 
  * This macro declares a tag with the provided id. Tags are the similar to 
  * components in that they can be added to an entity, but have no C type 
@@ -623,6 +643,71 @@ void _ecs_dim_type(
 #define ecs_dim_type(world, type, entity_count)\
     _ecs_dim_type(world, T##type, entity_count)
 
+/** Release memory that is no longer in use by the world.
+ * This operation shrinks the component columns of tables to the number of
+ * entities in the table, and releases tables that are empty. Released tables
+ * are removed from the systems and queries they were matched with, so that
+ * they no longer have to be considered when systems are created. A released
+ * table is created again when an entity is added to its type.
+ *
+ * Pointers to components obtained before this operation are invalidated. This
+ * operation may not be called while iterating.
+ *
+ * The total number of bytes released is reported in the reclaimed_bytes_total
+ * member of EcsMemoryStats.
+ *
+ * @param world The world.
+ * @return The number of bytes released.
+ */
+FLECS_EXPORT
+uint64_t ecs_world_compact(
+    ecs_world_t *world);
+
+/** Periodically compact the world from ecs_progress.
+ * When set, ecs_progress shrinks component columns every specified number of
+ * frames, and releases tables that were already empty at the previous
+ * compaction. Tables that are empty for a short time are not released, as
+ * they would have to be created again.
+ *
+ * Compaction happens at the end of a frame. When a target FPS is set, it uses
+ * time that would otherwise be spent sleeping.
+ *
+ * @param world The world.
+ * @param frames Number of frames between compactions (0 disables compaction).
+ */
+FLECS_EXPORT
+void ecs_set_compact_interval(
+    ecs_world_t *world,
+    uint32_t frames);
+
+/** Store a tag outside of tables.
+ * Adding a tag to an entity or removing it normally moves the entity to another
+ * table, which copies all of its components. For tags that are added and
+ * removed often, this operation stores the tag in a sparse set instead, so that
+ * adding and removing it does not move the entity.
+ *
+ * Column systems match sparse tags in their signature as usual. Tables are
+ * matched without the tag, and when iterating, the system is only invoked for
+ * the entities that have the tag (or don't have it, for NOT columns). Sparse
+ * tags can only be matched on the entity itself (SELF), and are not part of 
+ * the type of an entity. Queries, filters and row systems do not match sparse
+ * tags. 
+ *
+ * A sparse tag can be added and removed with the regular operations, and 
+ * ecs_has and ecs_count take it into account. When a tag is added or removed
+ * while iterating, the change becomes visible after the stage is merged.
+ *
+ * This operation must be called before the tag is added to entities, and before
+ * systems that use the tag are created. It may not be called while iterating.
+ *
+ * @param world The world.
+ * @param tag The tag to store in a sparse set.
+ */
+FLECS_EXPORT
+void ecs_set_sparse(
+    ecs_world_t *world,
+    ecs_entity_t tag);
+
 /** Set a range for issueing new entity ids.
  * This function constrains the entity identifiers returned by ecs_new to the 
  * specified range. This operation can be used to ensure that multiple processes
@@ -632,7 +717,8 @@ void _ecs_dim_type(
  * If id_end is set to 0, the range is infinite. If id_end is set to a non-zero
  * value, it has to be larger than id_start. If id_end is set and ecs_new is
  * invoked after an id is issued that is equal to id_end, the application will
- * abort. Flecs does not automatically recycle ids.
+ * abort. Ids of deleted entities are only recycled if they are in the range,
+ * and ids at or above 2^32 are not recycled.
  * 
  * The id_end parameter has to be smaller than the last issued identifier.
  * 
@@ -1363,6 +1449,11 @@ ecs_entity_t ecs_lookup_child(
  * When a valid pointer is obtained, it can be used as an array with rows->count
  * elements if the column is owned by the entity being iterated over, or as a
  * pointer if the column is shared (see ecs_is_shared).
+ *
+ * Owned column data is stored in buffers that are aligned at 64 bytes, and of
+ * which the allocation is padded to a multiple of 64 bytes. When rows->offset
+ * is zero, the returned pointer is aligned, and vectorized code may read up to
+ * the next multiple of 64 bytes after the last element without a scalar tail.
  * 
  * @param rows The rows parameter passed into the system.
  * @param index The index identifying the column in a system signature.
@@ -1558,6 +1649,8 @@ typedef struct ecs_filter_iter_t {
     ecs_filter_t filter;
     ecs_chunked_t *tables;
     uint32_t index;
+    ecs_entity_t component;   /* If set, iterate tables from component index */
+    uint32_t prefab_index;    /* Current position in tables with prefabs */
     ecs_rows_t rows;
 } ecs_filter_iter_t;
 
@@ -1606,6 +1699,80 @@ bool ecs_filter_next(
     ecs_filter_iter_t *iter);
 
 
+////////////////////////////////////////////////////////////////////////////////
+//// Query API
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct ecs_query_iter_t {
+    ecs_query_t *query;
+    uint32_t index;
+    ecs_rows_t rows;
+} ecs_query_iter_t;
+
+/** Create a query from a filter.
+ * A query stores the tables that match a filter, so that a filter does not
+ * have to be evaluated against all tables each time it is iterated. When a new
+ * table is created, it is matched with existing queries. A query also keeps
+ * track of which of its tables are empty, so that empty tables are skipped
+ * during iteration without being visited.
+ *
+ * Tables are matched when a query or table is created. Components that become
+ * available through a prefab afterwards do not cause tables to be rematched.
+ *
+ * A query cannot be created while the world is being progressed.
+ *
+ * @param world The world.
+ * @param filter The filter.
+ * @return The new query.
+ */
+FLECS_EXPORT
+ecs_query_t* ecs_query_new(
+    ecs_world_t *world,
+    const ecs_filter_t *filter);
+
+/** Free a query.
+ * Queries that are not freed by the application are freed by ecs_fini.
+ *
+ * @param query The query.
+ */
+FLECS_EXPORT
+void ecs_query_free(
+    ecs_query_t *query);
+
+/** Return number of tables matched by a query, including empty tables.
+ *
+ * @param query The query.
+ * @return The number of matched tables.
+ */
+FLECS_EXPORT
+uint32_t ecs_query_table_count(
+    ecs_query_t *query);
+
+/** Create iterator for a query.
+ * The iterator is used in the same way as a filter iterator. Only non-empty
+ * tables are returned. An application should not add or remove entities to
+ * or from matched tables while iterating, as this can change which tables are
+ * empty.
+ *
+ * @param query The query.
+ * @return An iterator that can be used with ecs_query_next.
+ */
+FLECS_EXPORT
+ecs_query_iter_t ecs_query_iter(
+    ecs_query_t *query);
+
+/** Iterate tables matched by query.
+ * This operation populates the "rows" member of the iterator in the same way
+ * as ecs_filter_next.
+ *
+ * @param iter The iterator.
+ * @return True if a table was found, false if there are no more tables.
+ */
+FLECS_EXPORT
+bool ecs_query_next(
+    ecs_query_iter_t *iter);
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //// System API
 ////////////////////////////////////////////////////////////////////////////////
@@ -1657,6 +1824,32 @@ void ecs_set_period(
     ecs_entity_t system,
     float period);
 
+/** Only run a system for tables with changed components.
+ * When enabled, a system skips tables for which none of the components it
+ * reads changed since the previous time the system was invoked. A system reads
+ * all components in its signature that are not annotated with [out].
+ *
+ * A component is changed when it is written by a system that does not annotate
+ * the component with [in], when it is set with ecs_set, or when entities are
+ * added to the table. Components that are modified through a pointer obtained
+ * with ecs_get_ptr are not detected as changed.
+ *
+ * Changes are tracked per table column, thus when a single entity in a table
+ * changes, the system is invoked for all entities in the table.
+ *
+ * This operation is only valid on column systems. If it is invoked on handles
+ * of other systems or entities it will be ignored.
+ *
+ * @param world The world.
+ * @param system The system for which to enable change tracking.
+ * @param changed_only true to skip unchanged tables, false to run all tables.
+ */
+FLECS_EXPORT
+void ecs_set_system_changed_only(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    bool changed_only);
+
 /** Returns the enabled status for a system / entity.
  * This operation will return whether a system is enabled or disabled. Currently
  * only systems can be enabled or disabled, but this operation does not fail
@@ -2338,6 +2531,80 @@ void ecs_set_threads(
     ecs_world_t *world,
     uint32_t threads);
 
+/** Set minimum number of rows in a job.
+ * When a system runs on multiple threads, its matched rows are split into jobs.
+ * Tables with fewer than twice the minimum number of rows are never split over
+ * multiple jobs, which prevents threads from repeating the per-table setup for
+ * small tables. Larger tables are split in chunks that are a multiple of the
+ * minimum, which prevents threads from writing to the same cache lines where
+ * jobs meet.
+ *
+ * A value of zero splits systems at arbitrary rows. The default is 64.
+ *
+ * @param world The world.
+ * @param min_rows The minimum number of rows in a job.
+ */
+FLECS_EXPORT
+void ecs_set_job_min_rows(
+    ecs_world_t *world,
+    uint32_t min_rows);
+
+/** Pin a thread to a set of CPUs.
+ * This prevents the OS scheduler from moving a thread between cores, which
+ * reduces cache misses and jitter in frame time. Thread 0 is the thread that
+ * calls ecs_progress, threads 1 and up are worker threads. Threads are pinned
+ * when they are started by ecs_set_threads. When threads are already running,
+ * they will be restarted.
+ *
+ * If the OS API does not support setting thread affinity, this operation has
+ * no effect. Worker threads without a CPU set inherit the affinity of the
+ * thread that started them.
+ *
+ * @param world The world.
+ * @param thread The index of the thread.
+ * @param cpus Array with CPU indices.
+ * @param count Number of elements in the cpus array.
+ */
+FLECS_EXPORT
+void ecs_set_thread_affinity(
+    ecs_world_t *world,
+    uint32_t thread,
+    const uint32_t *cpus,
+    uint32_t count);
+
+/** Reserve main thread.
+ * When the main thread is reserved, it does not run jobs for systems and only
+ * runs tasks, while worker threads run the jobs. This keeps the main thread
+ * responsive, for example to process input or rendering work. Jobs will be
+ * distributed over one less thread than specified by ecs_set_threads.
+ *
+ * @param world The world.
+ * @param reserve Whether the main thread is reserved.
+ */
+FLECS_EXPORT
+void ecs_set_reserve_main_thread(
+    ecs_world_t *world,
+    bool reserve);
+
+/** Set time that threads spin before they wait.
+ * When worker threads wait for jobs, or when the main thread waits for worker
+ * threads to finish, they first spin for the specified time before they block.
+ * Spinning reduces the latency of starting and finishing jobs, at the cost of
+ * CPU time. A value of zero makes threads block immediately. When there are
+ * more threads than available cores, spinning threads take time away from
+ * threads that still have work to do, and a spin time of zero is recommended.
+ *
+ * The spin time is applied when threads are created, and should be set before
+ * calling ecs_set_threads.
+ *
+ * @param world The world.
+ * @param spin_time The time to spin (in seconds).
+ */
+FLECS_EXPORT
+void ecs_set_thread_spin_time(
+    ecs_world_t *world,
+    float spin_time);
+
 /** Get number of configured threads.
  * This operation will return the number of threads set with ecs_set_threads.
  *
@@ -2399,6 +2666,49 @@ void ecs_set_automerge(
     ecs_world_t *world,
     bool auto_merge);
 
+/** Set whether worker threads defer operations.
+ * By default, worker threads store added components and component values in
+ * tables that are private to the thread, so that a thread can read back the
+ * data it has written before the merge. These tables are created for each type
+ * that a thread modifies.
+ *
+ * In deferred mode, worker threads instead record ecs_add, ecs_remove, ecs_set
+ * and ecs_delete operations in a log. When the world is merged, the log is
+ * replayed. Operations on the same entity are combined, so that an entity is
+ * moved to a new table only once, and only the last value of a component is
+ * assigned. Memory use and merge time then depend on the number of
+ * operations, not on the number of types that were modified.
+ *
+ * A thread cannot read back values it has written in deferred mode until the
+ * world is merged.
+ *
+ * @param world The world.
+ * @param enable When true, worker threads defer operations.
+ */
+FLECS_EXPORT
+void ecs_set_deferred_mode(
+    ecs_world_t *world,
+    bool enable);
+
+/** Set whether merges between phases can be postponed.
+ * By default, the world is merged after each phase that runs on worker
+ * threads. In pipelined mode, the merge is postponed when none of the systems
+ * in the next phase access or match with components of entities that were
+ * changed in the previous phase. These systems observe the same data with or
+ * without the merge, and the changes of both phases are merged at once.
+ *
+ * Postponed merges are counted in the merge_skip_count_total member of
+ * EcsWorldStats. OnAdd and OnSet systems for postponed changes run at the
+ * time of the actual merge.
+ *
+ * @param world The world.
+ * @param enable When true, merges are postponed when possible.
+ */
+FLECS_EXPORT
+void ecs_set_pipelined_merge(
+    ecs_world_t *world,
+    bool enable);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Utilities
 ////////////////////////////////////////////////////////////////////////////////
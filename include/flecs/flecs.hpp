@@ -16,6 +16,8 @@ using type_t = ecs_type_t;
 using snapshot_t = ecs_snapshot_t;
 using filter_t = ecs_filter_t;
 using filter_iter_t = ecs_filter_iter_t;
+using query_t = ecs_query_t;
+using query_iter_t = ecs_query_iter_t;
 
 class world;
 class snapshot;
@@ -26,6 +28,8 @@ class filter;
 class filter_iterator;
 class world_filter;
 class snapshot_filter;
+class query;
+class query_iterator;
 
 template <typename T>
 class component_base;
@@ -883,7 +887,8 @@ public:
         entity_t cur_entity = s_entity;
         type_t cur_type = s_type;
 
-        s_entity = ecs_new_component(world.c_ptr(), name, sizeof(T));
+        s_entity = ecs_new_component_w_alignment(
+            world.c_ptr(), name, sizeof(T), alignof(T));
         s_type = ecs_type_from_entity(world.c_ptr(), s_entity);
         s_name = name;
 
@@ -1234,6 +1239,7 @@ public:
         , m_period(0.0)
         , m_on_demand(false)
         , m_hidden(false)
+        , m_changed_only(false)
         , m_finalized(false) { 
             m_world = world.c_ptr();
         }
@@ -1268,6 +1274,12 @@ public:
         return *this;
     }
 
+    system& changed_only() {
+        ecs_assert(!m_finalized, ECS_INVALID_PARAMETER, NULL);
+        m_changed_only = true;
+        return *this;
+    }
+
     /* Action is mandatory and always the last thing that is added in the fluent
      * method chain. Create system signature from both template parameters and
      * anything provided by the signature method. */
@@ -1339,6 +1351,10 @@ public:
             ecs_set_period(m_world, e, m_period);
         }
 
+        if (m_changed_only) {
+            ecs_set_system_changed_only(m_world, e, true);
+        }
+
         m_id = e;
         m_finalized = true;
 
@@ -1365,6 +1381,11 @@ public:
         ecs_set_period(m_world, m_id, period);
     }
 
+    void set_changed_only(bool changed_only) const {
+        ecs_assert(m_finalized, ECS_INVALID_PARAMETER, NULL);
+        ecs_set_system_changed_only(m_world, m_id, changed_only);
+    }
+
     void set_context(void *ctx) const {
         ecs_assert(m_finalized, ECS_INVALID_PARAMETER, NULL);
         ecs_set_system_context(m_world, m_id, ctx);
@@ -1408,6 +1429,7 @@ private:
     float m_period;
     bool m_on_demand;
     bool m_hidden;
+    bool m_changed_only;
     bool m_finalized; // After set to true, call no more fluent functions
 };
 
@@ -1508,6 +1530,98 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////
+//// Utility for iterating over tables that match a query
+////////////////////////////////////////////////////////////////////////////////
+
+class query_iterator
+{
+public:
+    query_iterator()
+        : m_has_next(false)
+        , m_iter{ } { }
+
+    explicit query_iterator(query_t *query)
+        : m_iter( ecs_query_iter(query) ) 
+    { 
+        m_has_next = ecs_query_next(&m_iter);
+    }
+
+    bool operator!=(query_iterator const& other) const {
+        return m_has_next != other.m_has_next;
+    }
+
+    flecs::rows const operator*() const {
+        return flecs::rows(&m_iter.rows);
+    }
+
+    query_iterator& operator++() {
+        m_has_next = ecs_query_next(&m_iter);
+        return *this;
+    }
+
+private:
+    bool m_has_next;
+    query_iter_t m_iter;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//// A query caches the tables that match a filter
+////////////////////////////////////////////////////////////////////////////////
+
+class query final {
+public:
+    query(const world& world, const filter& filter)
+        : m_query( ecs_query_new(world.c_ptr(), filter.c_ptr()) ) { }
+
+    query(const query& obj) = delete;
+
+    query(query&& obj) 
+        : m_query(obj.m_query)
+    {
+        obj.m_query = nullptr;
+    }
+
+    query& operator=(const query& obj) = delete;
+
+    query& operator=(query&& obj) {
+        if (m_query) {
+            ecs_query_free(m_query);
+        }
+
+        m_query = obj.m_query;
+        obj.m_query = nullptr;
+        return *this;
+    }
+
+    ~query() {
+        if (m_query) {
+            ecs_query_free(m_query);
+        }
+    }
+
+    std::uint32_t table_count() const {
+        return ecs_query_table_count(m_query);
+    }
+
+    query_t* c_ptr() const {
+        return m_query;
+    }
+
+    inline query_iterator begin() const {
+        return query_iterator(m_query);
+    }
+
+    inline query_iterator end() const {
+        return query_iterator();
+    }
+
+private:
+    query_t *m_query;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Reader for world/snapshot serialization
 ////////////////////////////////////////////////////////////////////////////////
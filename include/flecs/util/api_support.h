@@ -158,6 +158,11 @@ typedef struct ecs_writer_t {
 #define ECS_ENTITY_FLAGS_MASK ((ecs_entity_t)(ECS_INSTANCEOF | ECS_CHILDOF))
 #define ECS_ENTITY_MASK ((ecs_entity_t)~ECS_ENTITY_FLAGS_MASK)
 
+/* Bits 32..47 of an entity id store its generation. The entity index tests the
+ * generation of an id, so that handles to deleted entities can be detected. */
+#define ECS_GENERATION_MASK ((ecs_entity_t)0xFFFF << 32)
+#define ECS_GENERATION(e) ((uint32_t)(((e) & ECS_GENERATION_MASK) >> 32))
+
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Deprecated names
@@ -207,6 +212,13 @@ ecs_entity_t ecs_new_component(
     const char *id,
     size_t size);
 
+FLECS_EXPORT
+ecs_entity_t ecs_new_component_w_alignment(
+    ecs_world_t *world,
+    const char *id,
+    size_t size,
+    size_t alignment);
+
 FLECS_EXPORT
 ecs_entity_t ecs_new_system(
     ecs_world_t *world,
@@ -9,8 +9,7 @@ typedef struct ecs_map_t ecs_map_t;
 
 typedef struct ecs_map_iter_t {
     ecs_map_t *map;
-    uint32_t bucket_index;
-    uint32_t node;
+    uint32_t index;
 } ecs_map_iter_t;
 
 FLECS_EXPORT
@@ -28,6 +28,7 @@ extern uint64_t ecs_os_api_free_count;
 typedef uintptr_t ecs_os_thread_t;
 typedef uintptr_t ecs_os_cond_t;
 typedef uintptr_t ecs_os_mutex_t;
+typedef uintptr_t ecs_os_barrier_t;
 typedef uintptr_t ecs_os_dl_t;
 
 /* Generic function pointer type */
@@ -70,6 +71,17 @@ typedef
 void* (*ecs_os_api_thread_join_t)(
     ecs_os_thread_t thread);
 
+/* Restrict calling thread to a set of CPUs */
+typedef
+bool (*ecs_os_api_thread_set_affinity_t)(
+    const uint32_t *cpus,
+    uint32_t count);
+
+/* Atomic increment / decrement */
+typedef
+int (*ecs_os_api_ainc_t)(
+    int *value);
+
 
 /* Mutex */
 typedef
@@ -110,6 +122,20 @@ void (*ecs_os_api_cond_wait_t)(
     ecs_os_cond_t cond,
     ecs_os_mutex_t mutex);
 
+/* Barrier */
+typedef
+ecs_os_barrier_t (*ecs_os_api_barrier_new_t)(
+    int count,
+    float spin_time);
+
+typedef
+void (*ecs_os_api_barrier_free_t)(
+    ecs_os_barrier_t barrier);
+
+typedef
+void (*ecs_os_api_barrier_wait_t)(
+    ecs_os_barrier_t barrier);
+
 
 typedef 
 void (*ecs_os_api_sleep_t)(
@@ -160,6 +186,11 @@ typedef struct ecs_os_api_t {
     /* Threads */
     ecs_os_api_thread_new_t thread_new;
     ecs_os_api_thread_join_t thread_join;
+    ecs_os_api_thread_set_affinity_t thread_set_affinity;
+
+    /* Atomic increment / decrement */
+    ecs_os_api_ainc_t ainc;
+    ecs_os_api_ainc_t adec;
 
     /* Mutex */
     ecs_os_api_mutex_new_t mutex_new;
@@ -174,6 +205,11 @@ typedef struct ecs_os_api_t {
     ecs_os_api_cond_broadcast_t cond_broadcast;
     ecs_os_api_cond_wait_t cond_wait;
 
+    /* Barrier */
+    ecs_os_api_barrier_new_t barrier_new;
+    ecs_os_api_barrier_free_t barrier_free;
+    ecs_os_api_barrier_wait_t barrier_wait;
+
     /* Time */
     ecs_os_api_sleep_t sleep;
     ecs_os_api_get_time_t get_time;
@@ -225,6 +261,11 @@ void ecs_os_set_api_defaults(void);
 /* Threads */
 #define ecs_os_thread_new(callback, param) ecs_os_api.thread_new(callback, param)
 #define ecs_os_thread_join(thread) ecs_os_api.thread_join(thread)
+#define ecs_os_thread_set_affinity(cpus, count) ecs_os_api.thread_set_affinity(cpus, count)
+
+/* Atomic increment / decrement */
+#define ecs_os_ainc(value) ecs_os_api.ainc(value)
+#define ecs_os_adec(value) ecs_os_api.adec(value)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new()
@@ -239,6 +280,11 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_cond_broadcast(cond) ecs_os_api.cond_broadcast(cond)
 #define ecs_os_cond_wait(cond, mutex) ecs_os_api.cond_wait(cond, mutex)
 
+/* Barrier */
+#define ecs_os_barrier_new(count, spin_time) ecs_os_api.barrier_new(count, spin_time)
+#define ecs_os_barrier_free(barrier) ecs_os_api.barrier_free(barrier)
+#define ecs_os_barrier_wait(barrier) ecs_os_api.barrier_wait(barrier)
+
 /* Time */
 #define ecs_os_sleep(sec, nanosec) ecs_os_api.sleep(sec, nanosec)
 #define ecs_os_get_time(time_out) ecs_os_api.get_time(time_out)
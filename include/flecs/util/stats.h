@@ -57,6 +57,7 @@ typedef struct EcsMemoryStats {
     ecs_memory_stat_t tables_memory;        /* Memory in use for tables */
     ecs_memory_stat_t stages_memory;        /* Memory in use for stages */
     ecs_memory_stat_t world_memory;         /* Memory in use for world */
+    uint64_t reclaimed_bytes_total;         /* Memory released by compaction */
 } EcsMemoryStats;
 
 /* Component statistics */
@@ -118,6 +119,7 @@ typedef struct EcsTableStats {
 typedef struct EcsWorldStats {
     double target_fps_hz;                   /* Target FPS */
     uint32_t tables_count;                  /* Number of tables in world */
+    uint32_t types_count;                   /* Number of types in world */
     uint32_t components_count;              /* Number of components in world */
     uint32_t col_systems_count;             /* Number of column (periodic) systems in world */
     uint32_t row_systems_count;             /* Nunber of row (reactive) systems in world */
@@ -125,6 +127,8 @@ typedef struct EcsWorldStats {
     uint32_t entities_count;                /* Number if entities in world */
     uint32_t threads_count;                 /* Number of threads in world */
     uint32_t frame_count_total;             /* Total number of frames processed */
+    uint32_t merge_count_total;             /* Total number of merges */
+    uint32_t merge_skip_count_total;        /* Total number of merges postponed to a later phase */
     double frame_seconds_total;        /* Total time spent processing frames */
     double system_seconds_total;       /* Total time spent in systems */
     double merge_seconds_total;        /* Total time spent merging */
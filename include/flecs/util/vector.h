@@ -24,6 +24,7 @@ struct ecs_vector_params_t {
     void *move_ctx;
     void *ctx;
     uint32_t element_size; /* Size of an element */
+    uint32_t alignment; /* Alignment of buffer, 0 for default (16 bytes) */
 };
 
 FLECS_EXPORT
@@ -144,6 +145,15 @@ void ecs_vector_memory(
     uint32_t *allocd,
     uint32_t *used);
 
+FLECS_EXPORT
+void ecs_vector_set_flags(
+    ecs_vector_t *array,
+    uint32_t flags);
+
+FLECS_EXPORT
+uint32_t ecs_vector_flags(
+    const ecs_vector_t *array);
+
 FLECS_EXPORT
 ecs_vector_t* ecs_vector_copy(
     const ecs_vector_t *src,
@@ -32,7 +32,7 @@ ecs_entity_t components_contains(
 
         if (entity & ECS_CHILDOF) {
             entity &= ECS_ENTITY_MASK;
-            ecs_row_t *row = ecs_map_get_ptr(world->main_stage.entity_index, entity);
+            ecs_row_t *row = ecs_ei_get(world->main_stage.entity_index, entity);
             ecs_assert(row != 0, ECS_INTERNAL_ERROR, NULL);
 
             ecs_entity_t component = ecs_type_contains(
@@ -56,7 +56,7 @@ ecs_entity_t ecs_get_entity_for_component(
     ecs_entity_t component)
 {
     if (entity) {
-        ecs_row_t *row = ecs_map_get_ptr(world->main_stage.entity_index, entity);
+        ecs_row_t *row = ecs_ei_get(world->main_stage.entity_index, entity);
         ecs_assert(row != NULL, ECS_INTERNAL_ERROR, NULL);
         type = row->type;
     }
@@ -111,8 +111,9 @@ void add_table(
     table_data->components = NULL;
 
     if (column_count) {
-        /* Array that contains the system column to table column mapping */
-        table_data->columns = ecs_os_malloc(sizeof(uint32_t) * column_count);
+        /* Array that contains the system column to table column mapping. Not
+         * all columns map to table data, so initialize to zero */
+        table_data->columns = ecs_os_calloc(sizeof(uint32_t), column_count);
         ecs_assert(table_data->columns != NULL, ECS_OUT_OF_MEMORY, NULL);
 
         /* Store the components of the matched table. In the case of OR expressions,
@@ -188,7 +189,9 @@ void add_table(
         if (!entity && kind != EcsFromEmpty) {
             if (component) {
                 /* Retrieve offset for component */
-                table_data->columns[c] = ecs_type_index_of(table_type, component);
+                table_data->columns[c] = table 
+                    ? ecs_table_column_index(table, component) 
+                    : -1;
 
                 /* If column is found, add one to the index, as column zero in
                  * a table is reserved for entity id's */
@@ -211,6 +214,11 @@ void add_table(
             }
         }
 
+        /* Sparse tags are not stored in the table, and have no data */
+        if (kind == EcsFromSelf && ecs_sparse_get_set(world, component)) {
+            table_data->columns[c] = 0;
+        }
+
         if (oper_kind == EcsOperOptional) {
             /* If table doesn't have the field, mark it as no data */
             if (!ecs_type_has_entity_intern(
@@ -266,21 +274,10 @@ void add_table(
                     
                     ref->entity = e;
                     ref->component = component;
+                    ecs_resolve_reference(world, ref);
                     
                     if (e != ECS_INVALID_ENTITY) {
-                        ecs_entity_info_t info = {.entity = e};
-
-                        ref->cached_ptr = ecs_get_ptr_intern(
-                            world, 
-                            &world->main_stage,
-                            &info,
-                            component,
-                            false,
-                            true);
-
                         ecs_set_watch(world, &world->main_stage, e);                     
-                    } else {
-                        ref->cached_ptr = NULL;
                     }
 
                     /* Negative number indicates ref instead of offset to ecs_data */
@@ -399,6 +396,12 @@ bool match_table(
 
         if (oper_kind == EcsOperAnd) {
             if (elem_kind == EcsFromSelf) {
+                /* Sparse tags are not stored in tables, and are tested for
+                 * each entity when the system is invoked */
+                if (ecs_sparse_get_set(world, elem->is.component)) {
+                    continue;
+                }
+
                 if (!ecs_type_has_entity_intern(
                         world, table_type, elem->is.component, true))
                 {
@@ -551,14 +554,33 @@ void match_tables(
     ecs_entity_t system,
     EcsColSystem *system_data)
 {
-    uint32_t i, count = ecs_chunked_count(world->main_stage.tables);
+    ecs_type_t and_from_self = system_data->base.and_from_self;
+
+    if (and_from_self) {
+        /* Only visit tables that have the rarest SELF component, or that can
+         * inherit it from a prefab */
+        ecs_entity_t component = ecs_world_get_rarest_component(
+            world, and_from_self);
+        uint32_t table_index = 0, prefab_index = 0;
+        ecs_table_t *table;
+
+        while ((table = ecs_world_next_table(
+            world, component, &table_index, &prefab_index))) 
+        {
+            if (match_table(world, table, system, system_data, NULL)) {
+                add_table(world, system, system_data, table);
+            }
+        }
+    } else {
+        uint32_t i, count = ecs_chunked_count(world->main_stage.tables);
 
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(
-            world->main_stage.tables, ecs_table_t, i);
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = ecs_chunked_get(
+                world->main_stage.tables, ecs_table_t, i);
 
-        if (match_table(world, table, system, system_data, NULL)) {
-            add_table(world, system, system_data, table);
+            if (match_table(world, table, system, system_data, NULL)) {
+                add_table(world, system, system_data, table);
+            }
         }
     }
 
@@ -617,14 +639,12 @@ void resolve_cascade_container(
 
     /* If container was found, update the reference */
     if (container) {
-        ecs_entity_info_t info = {.entity = container};
-        references[ref_index].entity = container;
-        references[ref_index].cached_ptr = ecs_get_ptr_intern(
-            world, &world->main_stage, &info, ref->component, false, true);
+        ref->entity = container;
     } else {
-        references[ref_index].entity = ECS_INVALID_ENTITY;
-        references[ref_index].cached_ptr = NULL;
+        ref->entity = ECS_INVALID_ENTITY;
     }
+
+    ecs_resolve_reference(world, ref);
 }
 
 static
@@ -650,8 +670,257 @@ bool should_run(
     return true;
 }
 
+/** Jobs of the same system may mark the same column of a table from different
+ * threads. They store the same tick, but the accesses still need to be atomic.
+ * Ordering is provided by the barrier that ends the jobs. */
+static
+uint32_t load_change_tick(
+    uint32_t *tick)
+{
+#ifdef _MSC_VER
+    return *(volatile uint32_t*)tick;
+#else
+    return __atomic_load_n(tick, __ATOMIC_RELAXED);
+#endif
+}
+
+static
+void store_change_tick(
+    uint32_t *tick,
+    uint32_t value)
+{
+#ifdef _MSC_VER
+    *(volatile uint32_t*)tick = value;
+#else
+    __atomic_store_n(tick, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/** Test if a tick is more recent than another tick. Ticks are compared as a
+ * difference, which is robust against overflow of the tick counter. */
+static
+bool tick_newer(
+    uint32_t tick,
+    uint32_t other)
+{
+    return (int32_t)(tick - other) > 0;
+}
+
+/** Test if the component of a reference column changed. Components that are
+ * not stored in a table (like components of an invalid entity) are never
+ * changed. */
+static
+bool ref_changed(
+    ecs_reference_t *ref,
+    uint32_t tick)
+{
+    if (!ref->column) {
+        return false;
+    }
+
+    return tick_newer(load_change_tick(&ref->column->change_tick), tick);
+}
+
+/** Test if any of the columns that a system reads changed since the previous
+ * invocation of the system. */
+static
+bool table_changed(
+    ecs_world_t *world,
+    EcsColSystem *system_data,
+    ecs_matched_table_t *table)
+{
+    (void)world;
+    ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
+    uint32_t i, count = ecs_vector_count(system_data->base.columns);
+    ecs_table_column_t *table_columns = table->table->columns;
+    ecs_reference_t *refs = ecs_vector_first(table->references);
+    uint32_t tick = system_data->prev_change_tick;
+
+    for (i = 0; i < count; i ++) {
+        int32_t index = table->columns[i];
+
+        if (columns[i].inout_kind == EcsOut || !index) {
+            continue;
+        }
+
+        if (index > 0) {
+            if (tick_newer(
+                load_change_tick(&table_columns[index].change_tick), tick)) 
+            {
+                return true;
+            }
+        } else if (ref_changed(&refs[-index - 1], tick)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Mark the columns that a system writes as changed */
+static
+void mark_written_columns(
+    EcsColSystem *system_data,
+    ecs_matched_table_t *table)
+{
+    ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
+    uint32_t i, count = ecs_vector_count(system_data->base.columns);
+    ecs_table_column_t *table_columns = table->table->columns;
+    uint32_t tick = system_data->change_tick;
+
+    for (i = 0; i < count; i ++) {
+        int32_t index = table->columns[i];
+        if (index > 0 && columns[i].inout_kind != EcsIn) {
+            store_change_tick(&table_columns[index].change_tick, tick);
+        }
+    }
+}
+
+/** Add component to the read and/or write set of a system */
+static
+void add_inout_component(
+    ecs_world_t *world,
+    EcsColSystem *system_data,
+    ecs_system_expr_inout_kind_t inout_kind,
+    ecs_entity_t component)
+{
+    if (inout_kind != EcsOut) {
+        system_data->read_set = ecs_type_add_intern(
+            world, NULL, system_data->read_set, component);
+    }
+
+    if (inout_kind != EcsIn) {
+        system_data->write_set = ecs_type_add_intern(
+            world, NULL, system_data->write_set, component);
+    }
+}
+
+/** Move sparse tags from the SELF types, which are matched with tables, to
+ * the sparse sets that are tested for each entity */
+static
+void compute_sparse_families(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
+    ecs_type_t sparse_type = world->sparse_type;
+    EcsSystem *base = &system_data->base;
+
+    if (!sparse_type) {
+        return;
+    }
+
+    if (ecs_type_contains(world, base->and_from_self, sparse_type, false, false)) {
+        base->and_sparse = ecs_sparse_get_sets(world, base->and_from_self);
+        base->and_from_self = ecs_type_merge_intern(
+            world, NULL, base->and_from_self, NULL, sparse_type);
+    }
+
+    if (ecs_type_contains(world, base->not_from_self, sparse_type, false, false)) {
+        base->not_sparse = ecs_sparse_get_sets(world, base->not_from_self);
+        base->not_from_self = ecs_type_merge_intern(
+            world, NULL, base->not_from_self, NULL, sparse_type);
+    }
+}
+
+/** Compute which components a system reads and writes. Columns that do not
+ * provide access to component data (handles, NOT columns) and components that
+ * are stored on the system itself are not included. */
+static
+void compute_inout_sets(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
+    uint32_t i, column_count = ecs_vector_count(system_data->base.columns);
+    ecs_system_column_t *buffer = ecs_vector_first(system_data->base.columns);
+
+    for (i = 0; i < column_count; i ++) {
+        ecs_system_column_t *elem = &buffer[i];
+        ecs_system_expr_elem_kind_t elem_kind = elem->kind;
+        ecs_system_expr_oper_kind_t oper_kind = elem->oper_kind;
+
+        if (elem_kind == EcsFromEmpty || elem_kind == EcsFromSystem) {
+            continue;
+        }
+
+        if (oper_kind == EcsOperNot) {
+            continue;
+        }
+
+        if (oper_kind == EcsOperOr) {
+            ecs_entity_t *components = ecs_vector_first(elem->is.type);
+            uint32_t c, count = ecs_vector_count(elem->is.type);
+
+            for (c = 0; c < count; c ++) {
+                add_inout_component(
+                    world, system_data, elem->inout_kind, components[c]);
+            }
+        } else {
+            add_inout_component(
+                world, system_data, elem->inout_kind, elem->is.component);
+        }
+    }
+}
+
+/** Invoke system for each range of rows in which the entities match the sparse
+ * tags of the system. Rows in a range are consecutive, so that the system can
+ * access the component columns of the range as usual. */
+static
+void run_sparse(
+    EcsColSystem *system_data,
+    ecs_rows_t *info)
+{
+    ecs_system_action_t action = system_data->base.action;
+    ecs_vector_t *and_sparse = system_data->base.and_sparse;
+    ecs_vector_t *not_sparse = system_data->base.not_sparse;
+    ecs_entity_t *entities = info->entities;
+    uint32_t offset = info->offset;
+    uint32_t frame_offset = info->frame_offset;
+    uint32_t i = 0, start, count = info->count;
+
+    while (i < count) {
+        while (i < count && 
+            !ecs_sparse_match(and_sparse, not_sparse, entities[i])) 
+        {
+            i ++;
+        }
+
+        start = i;
+
+        while (i < count && 
+            ecs_sparse_match(and_sparse, not_sparse, entities[i])) 
+        {
+            i ++;
+        }
+
+        if (i == start) {
+            break;
+        }
+
+        info->entities = &entities[start];
+        info->offset = offset + start;
+        info->count = i - start;
+        info->frame_offset = frame_offset + start;
+
+        action(info);
+
+        if (info->interrupted_by) {
+            break;
+        }
+    }
+
+    info->frame_offset = frame_offset;
+}
+
 /* -- Private API -- */
 
+void ecs_col_system_next_tick(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
+    system_data->prev_change_tick = system_data->change_tick;
+    system_data->change_tick = world->change_tick ++;
+}
+
 /* Rematch system with tables after a change happened to a container or prefab */
 void ecs_rematch_system(
     ecs_world_t *world,
@@ -710,20 +979,13 @@ void ecs_rematch_system(
         ecs_check_column_constraints(world, (EcsSystem*)system_data), false);
 }
 
-/** Revalidate references after a realloc occurred in a table */
-void ecs_revalidate_system_refs(
+static
+void revalidate_refs(
     ecs_world_t *world,
-    ecs_entity_t system)
+    ecs_vector_t *tables)
 {
-    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
-    ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, 0);
-
-    if (!system_data->base.has_refs) {
-        return;
-    }
-
-    uint32_t i, count = ecs_vector_count(system_data->tables);
-    ecs_matched_table_t *table_data = ecs_vector_first(system_data->tables);
+    uint32_t i, count = ecs_vector_count(tables);
+    ecs_matched_table_t *table_data = ecs_vector_first(tables);
 
     for (i = 0; i < count; i ++) {
         if (!table_data[i].references) {
@@ -734,14 +996,29 @@ void ecs_revalidate_system_refs(
         ecs_reference_t *refs = ecs_vector_first(table_data[i].references);
 
         for (r = 0; r < ref_count; r ++) {
-            ecs_reference_t ref = refs[r];
-            ecs_entity_info_t info = {.entity = ref.entity};
-            refs[r].cached_ptr = ecs_get_ptr_intern(
-                world, &world->main_stage, &info, ref.component, false, true);
-        }            
+            ecs_resolve_reference(world, &refs[r]);
+        }
     }
 }
 
+/** Revalidate references after entities moved to a different row or table. 
+ * References of inactive tables are revalidated as well, as they are used as
+ * soon as the table is activated. */
+void ecs_revalidate_system_refs(
+    ecs_world_t *world,
+    ecs_entity_t system)
+{
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, 0);
+
+    if (!system_data->base.has_refs) {
+        return;
+    }
+
+    revalidate_refs(world, system_data->tables);
+    revalidate_refs(world, system_data->inactive_tables);
+}
+
 /** Match new table against system (table is created after system) */
 void ecs_col_system_notify_of_table(
     ecs_world_t *world,
@@ -780,6 +1057,38 @@ int32_t get_table_param_index(
     return i;
 }
 
+/** Remove a table that is released by ecs_world_compact from the system */
+void ecs_system_remove_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_table_t *table)
+{
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_vector_t *tables = system_data->inactive_tables;
+    int32_t index = table_matched(system_data, tables, table);
+    if (index == -1) {
+        tables = system_data->tables;
+        index = table_matched(system_data, tables, table);
+        if (index == -1) {
+            return;
+        }
+    }
+
+    ecs_matched_table_t *table_data = ecs_vector_first(tables);
+    ecs_os_free(table_data[index].columns);
+    ecs_os_free(table_data[index].components);
+    ecs_vector_free(table_data[index].references);
+
+    remove_table(system_data, tables, index);
+
+    if (tables == system_data->tables && !ecs_vector_count(tables)) {
+        ecs_world_activate_system(
+            world, system, system_data->base.kind, false);
+    }
+}
+
 /** Table activation happens when a table was or becomes empty. Deactivated
  * tables are not considered by the system in the main loop. */
 void ecs_system_activate_table(
@@ -871,6 +1180,10 @@ ecs_entity_t ecs_new_col_system(
 
     ecs_system_compute_and_families(world, &system_data->base);
 
+    compute_sparse_families(world, system_data);
+
+    compute_inout_sets(world, system_data);
+
     ecs_system_init_base(world, &system_data->base);
 
     if (system_data->base.needs_tables) {
@@ -911,6 +1224,8 @@ ecs_entity_t ecs_new_col_system(
         /* Parameter checking happened before this, kind must have been one of
          * the checked values. */
         ecs_assert(elem != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        world->valid_batches = false;
     }
 
     *elem = result;
@@ -958,16 +1273,24 @@ ecs_entity_t ecs_run_intern(
         }
     }
 
+    /* When running on worker threads, the main thread assigned the tick before
+     * the jobs of the system were queued */
+    if (world == real_world) {
+        ecs_col_system_next_tick(real_world, system_data);
+    }
+
     ecs_time_t time_start;
     if (measure_time) {
         ecs_os_get_time(&time_start);
     }
 
     uint32_t column_count = ecs_vector_count(system_data->base.columns);
+    bool changed_only = system_data->changed_only;
     ecs_entity_t interrupted_by = 0;
     ecs_system_action_t action = system_data->base.action;
     bool offset_limit = (offset | limit) != 0;
     bool limit_set = limit != 0;
+    bool has_sparse = system_data->base.and_sparse || system_data->base.not_sparse;
 
     ecs_rows_t info = {
         .world = world,
@@ -1029,6 +1352,18 @@ ecs_entity_t ecs_run_intern(
                 continue;
             }
 
+            /* Tables are skipped after applying the offset and limit, so that
+             * jobs of the same system still cover the same rows */
+            if (changed_only && 
+                !table_changed(real_world, system_data, table)) 
+            {
+                info.frame_offset += count;
+                info.table_offset ++;
+                continue;
+            }
+
+            mark_written_columns(system_data, table);
+
             ecs_entity_t *entity_buffer = 
                     ecs_vector_first(table_data[0].data);
             info.entities = &entity_buffer[first];            
@@ -1047,7 +1382,11 @@ ecs_entity_t ecs_run_intern(
         info.offset = first;
         info.count = count;
         
-        action(&info);
+        if (world_table && has_sparse) {
+            run_sparse(system_data, &info);
+        } else {
+            action(&info);
+        }
 
         info.frame_offset += count;
         info.table_offset ++;
@@ -13,7 +13,10 @@ void copy_column(
     uint32_t size = new_column->size;
 
     if (size) {
-        ecs_vector_params_t param = {.element_size = new_column->size};
+        ecs_vector_params_t param = {
+            .element_size = new_column->size,
+            .alignment = new_column->alignment
+        };
 
         if (old_index < 0) old_index *= -1;
         
@@ -61,7 +64,19 @@ void copy_row(
         }
 
         if (new_component == old_component) {
-            copy_column(&new_columns[i_new + 1], new_index, &old_columns[i_old + 1], old_index);
+            ecs_table_column_t *new_column = &new_columns[i_new + 1];
+            ecs_table_column_t *old_column = &old_columns[i_old + 1];
+
+            copy_column(new_column, new_index, old_column, old_index);
+
+            /* Data copied from a stage keeps the tick at which it was written.
+             * Ticks are compared as a difference, which is robust against
+             * overflow of the tick counter. */
+            int32_t age = old_column->change_tick - new_column->change_tick;
+            if (age > 0) {
+                new_column->change_tick = old_column->change_tick;
+            }
+
             i_new ++;
             i_old ++;
         } else if (new_component < old_component) {
@@ -72,16 +87,41 @@ void copy_row(
     }
 }
 
+static
+void move_row(
+    const ecs_table_edge_t *edge,
+    ecs_table_column_t *new_columns,
+    int32_t new_index,
+    ecs_table_column_t *old_columns,
+    int32_t old_index)
+{
+    ecs_table_move_t *moves = edge->moves;
+    uint32_t i, count = edge->move_count;
+
+    ecs_assert(new_index > 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(old_index > 0, ECS_INTERNAL_ERROR, NULL);
+
+    for (i = 0; i < count; i ++) {
+        uint16_t size = moves[i].size;
+        void *dst = ecs_vector_first(new_columns[moves[i].dst].data);
+        void *src = ecs_vector_first(old_columns[moves[i].src].data);
+
+        ecs_assert(dst != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(src != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        memcpy(ECS_OFFSET(dst, (new_index - 1) * size), 
+            ECS_OFFSET(src, (old_index - 1) * size), size);
+    }
+}
+
 static
 void* get_row_ptr(
-    ecs_type_t type,
+    ecs_table_t *table,
     ecs_table_column_t *columns,
     int32_t index,
     ecs_entity_t component)
 {
-    ecs_assert(ecs_vector_count(type) < ECS_MAX_ENTITIES_IN_TYPE, ECS_TYPE_TOO_LARGE, NULL);
-
-    int16_t column_index = ecs_type_index_of(type, component);
+    int16_t column_index = ecs_table_column_index(table, component);
     if (column_index == -1) {
         return NULL;
     }
@@ -89,7 +129,10 @@ void* get_row_ptr(
     ecs_assert(index >= 0, ECS_INTERNAL_ERROR, NULL);
 
     ecs_table_column_t *column = &columns[column_index + 1];
-    ecs_vector_params_t param = {.element_size = column->size};
+    ecs_vector_params_t param = {
+        .element_size = column->size,
+        .alignment = column->alignment
+    };
 
     if (param.element_size) {
         ecs_assert(column->data != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -107,7 +150,7 @@ ecs_row_t row_from_stage(
     ecs_entity_t entity)
 {
     ecs_row_t row;
-    if (ecs_map_has(stage->entity_index, entity, &row)) {
+    if (ecs_ei_has(stage->entity_index, entity, &row)) {
         return row;
     } else {
         return (ecs_row_t){0, 0};
@@ -122,7 +165,7 @@ bool stage_has_entity(
 {
     ecs_row_t row;
 
-    if (ecs_map_has(stage->entity_index, entity, &row)) {
+    if (ecs_ei_has(stage->entity_index, entity, &row)) {
         if (row.index) {
             *row_out = row;
             return true;
@@ -275,12 +318,11 @@ ecs_type_t instantiate_prefab(
     uint32_t limit,
     ecs_type_t modified)
 {
-    ecs_type_t prefab_type = prefab_info->type;
     ecs_table_column_t *prefab_columns = prefab_info->table->columns;
     ecs_table_column_t *entity_columns = ecs_table_get_columns(world, stage, entity_info->table);
     ecs_entity_t *entity_ids = ecs_vector_first(entity_columns[0].data);
 
-    EcsPrefabBuilder *builder = get_row_ptr(prefab_type, 
+    EcsPrefabBuilder *builder = get_row_ptr(prefab_info->table, 
         prefab_columns, prefab_info->index, EEcsPrefabBuilder);
 
     /* If the current entity is not a prefab itself, and the prefab
@@ -423,7 +465,7 @@ ecs_type_t copy_from_prefab(
             if (info->type == to_add) {
                 dst_col_index = e;
             } else {
-                dst_col_index = ecs_type_index_of(info->type, ee);
+                dst_col_index = ecs_table_column_index(info->table, ee);
             }
             
             ecs_table_column_t *dst_column = &columns[dst_col_index + 1];
@@ -552,11 +594,12 @@ uint32_t commit(
     ecs_type_t type,
     ecs_type_t to_add,
     ecs_type_t to_remove,
-    bool do_set)
+    bool do_set,
+    const ecs_table_edge_t *edge)
 {
     ecs_table_t *new_table = NULL, *old_table;
     ecs_table_column_t *new_columns = NULL, *old_columns;
-    ecs_map_t *entity_index = stage->entity_index;
+    ecs_ei_t *entity_index = stage->entity_index;
     ecs_type_t old_type = NULL;
     int32_t new_index = 0, old_index = 0;
     bool in_progress = world->in_progress;
@@ -633,8 +676,9 @@ uint32_t commit(
          * is merged, which will invoke commit again. */
 
         if (stage->range_check_enabled) {
-            ecs_assert(!world->max_handle || entity <= world->max_handle, ECS_OUT_OF_RANGE, 0);
-            ecs_assert(entity >= world->min_handle, ECS_OUT_OF_RANGE, 0);
+            ecs_entity_t id = ecs_ei_id(world->main_stage.entity_index, entity);
+            ecs_assert(!world->max_handle || id <= world->max_handle, ECS_OUT_OF_RANGE, 0);
+            ecs_assert(id >= world->min_handle, ECS_OUT_OF_RANGE, 0);
         }
     }
 
@@ -645,12 +689,23 @@ uint32_t commit(
      * component from, for example, a container. */
     if (info->is_watched) {
         world->should_match = true;
+
+        /* Systems reference components of watched entities by their table
+         * column and row, which change when the entity moves to another table,
+         * so references must be resolved again before they are used. */
+        if (stage == &world->main_stage) {
+            world->should_resolve = true;
+        }
     }
 
     /* If the new type contains components (that is, it is not 0) obtain the new
      * table and new columns. */
     if (type) {
-        new_table = ecs_world_get_table(world, stage, type);
+        if (edge) {
+            new_table = edge->table;
+        } else {
+            new_table = ecs_world_get_table(world, stage, type);
+        }
 
         /* This operation will automatically obtain components from the stage if
          * the application is iterating. */
@@ -664,8 +719,12 @@ uint32_t commit(
     /* Copy components from old table to new table, only if the entity was not
      * empty, and will not be empty */
     if (old_type && type) {
-        copy_row(new_table->type, new_columns, new_index, 
-            old_type, old_columns, old_index);
+        if (edge) {
+            move_row(edge, new_columns, new_index, old_columns, old_index);
+        } else {
+            copy_row(new_table->type, new_columns, new_index, 
+                old_type, old_columns, old_index);
+        }
     }
 
     /* Update the entity index so that it points to the new table */
@@ -677,14 +736,14 @@ uint32_t commit(
             new_row.index *= -1;
         }
 
-        ecs_map_set(entity_index, entity, &new_row);
+        ecs_ei_set(entity_index, entity, &new_row);
     } else {
         if (in_progress) {
             /* The entity must be kept in the stage index because otherwise the
              * merge doesn't know that it needs to merge data for the entity */
-            ecs_map_set(entity_index, entity, &((ecs_row_t){0, 0}));
+            ecs_ei_set(entity_index, entity, &((ecs_row_t){0, 0}));
         } else {
-            ecs_map_remove(entity_index, entity);
+            ecs_ei_remove(entity_index, entity);
         }
     }
 
@@ -783,7 +842,7 @@ void* get_ptr_from_prefab(
 
         ecs_entity_info_t prefab_info = {.entity = prefab};
         if (populate_info(world, &world->main_stage, &prefab_info)) {
-            ptr = get_row_ptr(prefab_info.table->type, prefab_info.columns, 
+            ptr = get_row_ptr(prefab_info.table, prefab_info.columns, 
                 prefab_info.index, component);
             
             if (!ptr) {
@@ -796,8 +855,68 @@ void* get_ptr_from_prefab(
     return ptr;
 }
 
+static
+bool resolve_reference(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t previous,
+    ecs_reference_t *ref)
+{
+    ecs_entity_info_t info = {.entity = entity};
+    if (!populate_info(world, &world->main_stage, &info)) {
+        return false;
+    }
+
+    int16_t column = ecs_table_column_index(info.table, ref->component);
+    if (column != -1) {
+        if (!info.columns[column + 1].size) {
+            return false;
+        }
+
+        ref->column = &info.columns[column + 1];
+        ref->row = info.index;
+        return true;
+    }
+
+    if (ref->component == EEcsId || ref->component == EEcsPrefab) {
+        return false;
+    }
+
+    /* Same search as get_ptr_from_prefab */
+    ecs_type_t type = info.table->type;
+    ecs_entity_t *type_buffer = ecs_vector_first(type);
+    int32_t p = -1;
+
+    while ((p = ecs_type_get_prefab(type, p)) != -1) {
+        ecs_entity_t prefab = type_buffer[p] & ECS_ENTITY_MASK;
+
+        /* Detect cycles with two entities */
+        if (prefab == previous) {
+            continue;
+        }
+
+        if (resolve_reference(world, prefab, entity, ref)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /* -- Private functions -- */
 
+void ecs_resolve_reference(
+    ecs_world_t *world,
+    ecs_reference_t *ref)
+{
+    ref->column = NULL;
+    ref->row = 0;
+
+    if (ref->entity && ref->entity != ECS_INVALID_ENTITY) {
+        resolve_reference(world, ref->entity, 0, ref);
+    }
+}
+
 void* ecs_get_ptr_intern(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -815,7 +934,7 @@ void* ecs_get_ptr_intern(
 
     if (world->in_progress && stage != &world->main_stage) {
         if (populate_info(world, stage, info)) {
-            ptr = get_row_ptr(info->table->type, info->columns, info->index, component);
+            ptr = get_row_ptr(info->table, info->columns, info->index, component);
         }
 
         if (!ptr && search_prefab) {
@@ -827,7 +946,7 @@ void* ecs_get_ptr_intern(
     if (!ptr && (!world->in_progress || !staged_only)) {
         if (populate_info(world, &world->main_stage, info)) {
             ptr = get_row_ptr(
-                info->table->type, info->columns, info->index, component);
+                info->table, info->columns, info->index, component);
             if (!ptr && search_prefab) {
                 main_info = *info;
             }                
@@ -875,7 +994,14 @@ ecs_type_t ecs_notify(
     ecs_vector_t *systems;
     ecs_type_t modified = 0;
 
-    if (ecs_map_has(index, (uintptr_t)type, &systems)) {
+    ecs_world_t *real_world = world;
+    ecs_get_stage(&real_world);
+
+    ecs_lock_types(real_world);
+    bool has_systems = ecs_map_has(index, (uintptr_t)type, &systems);
+    ecs_unlock_types(real_world);
+
+    if (has_systems) {
         ecs_entity_t *buffer = ecs_vector_first(systems);
         uint32_t i, count = ecs_vector_count(systems);
 
@@ -895,11 +1021,12 @@ ecs_type_t ecs_notify(
     return modified;
 }
 
-void ecs_merge_entity(
+bool ecs_merge_commit(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_entity_t entity,
-    ecs_row_t staged_row)
+    ecs_row_t staged_row,
+    ecs_merge_item_t *item_out)
 {
     ecs_row_t old_row = {0};
     ecs_table_t *old_table = NULL;
@@ -932,7 +1059,7 @@ void ecs_merge_entity(
     }
 
     int32_t new_index = commit(
-        world, &world->main_stage, &info, type, 0, to_remove, false);
+        world, &world->main_stage, &info, type, 0, to_remove, false, NULL);
     
     if (type && staged_type) {
         ecs_table_t *new_table = ecs_world_get_table(world, &world->main_stage, type);
@@ -943,9 +1070,41 @@ void ecs_merge_entity(
         ecs_map_has(stage->data_stage, (uintptr_t)staged_row.type, &staged_columns);
         ecs_assert(staged_columns != NULL, ECS_INTERNAL_ERROR, NULL);
 
-        copy_row( new_table->type, new_table->columns, new_index,
-                staged_table->type, staged_columns, staged_row.index); 
+        *item_out = (ecs_merge_item_t){
+            .entity = entity,
+            .table = new_table,
+            .index = new_index,
+            .staged_table = staged_table,
+            .staged_columns = staged_columns,
+            .staged_index = staged_row.index
+        };
+
+        return true;
+    }
+
+    return false;
+}
+
+void ecs_merge_copy(
+    ecs_world_t *world,
+    ecs_merge_item_t *item,
+    bool lookup_index)
+{
+    if (lookup_index) {
+        /* Systems that ran while committing may have moved the entity to
+         * another table after its item was created, so get both the table
+         * and the row from the entity index. */
+        ecs_row_t row = row_from_stage(&world->main_stage, item->entity);
+        if (!row.type) {
+            return;
+        }
+
+        item->table = ecs_world_get_table(world, &world->main_stage, row.type);
+        item->index = row.index < 0 ? -row.index : row.index;
     }
+
+    copy_row( item->table->type, item->table->columns, item->index,
+            item->staged_table->type, item->staged_columns, item->staged_index);
 }
 
 void ecs_set_watch(
@@ -965,7 +1124,7 @@ void ecs_set_watch(
         row.type = NULL;
     }
 
-    ecs_map_set(stage->entity_index, entity, &row);
+    ecs_ei_set(stage->entity_index, entity, &row);
 }
 
 bool ecs_components_contains_component(
@@ -999,6 +1158,23 @@ bool ecs_components_contains_component(
     return false;
 }
 
+void ecs_recycle_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_entity_t id = ecs_ei_id(world->main_stage.entity_index, entity);
+
+    if (id > world->last_handle || id < world->min_handle) {
+        return;
+    }
+
+    if (world->max_handle && id > world->max_handle) {
+        return;
+    }
+
+    ecs_ei_recycle(world->main_stage.entity_index, entity);
+}
+
 void ecs_add_remove_intern(
     ecs_world_t *world,
     ecs_entity_info_t *info,
@@ -1009,17 +1185,62 @@ void ecs_add_remove_intern(
     ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_stage_t *stage = ecs_get_stage(&world);
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
+
+    if (ecs_stage_is_deferred(world, stage)) {
+        ecs_stage_defer_add_remove(stage, info->entity, to_add, to_remove);
+        return;
+    }
+
+    if (world->sparse_type) {
+        ecs_sparse_add_remove(world, stage, info->entity, &to_add, &to_remove);
+        if (!to_add && !to_remove) {
+            return;
+        }
+    }
     
     ecs_type_t dst_type = 0;
+    ecs_table_edge_t *edge = NULL;
 
     if (populate_info(world, stage, info)) {
-        dst_type = ecs_type_merge_intern(
-            world, stage, info->table->type, to_add, to_remove);
+        /* Outside of progress, adding or removing a single type follows the
+         * cached edge of the table, which knows the destination table and the
+         * components to copy. Staged tables are short-lived, so while in
+         * progress the destination is looked up from the merged type. */
+        if (!world->in_progress && !to_add != !to_remove) {
+            edge = ecs_table_get_edge(
+                world, stage, info->table, to_add, to_remove);
+            dst_type = edge->type;
+        } else {
+            dst_type = ecs_type_merge_intern(
+                world, stage, info->table->type, to_add, to_remove);
+        }
     } else {
         dst_type = to_add;
     }
 
-    commit(world, stage, info, dst_type, to_add, to_remove, do_set);
+    commit(world, stage, info, dst_type, to_add, to_remove, do_set, edge);
+}
+
+static
+ecs_entity_t new_entity_handle(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    /* Ids are only recycled when not running on a worker thread, since worker
+     * threads would otherwise race on the list of recycled ids */
+    if (stage == &world->main_stage || stage == &world->temp_stage) {
+        ecs_entity_t entity = ecs_ei_recycled(world->main_stage.entity_index);
+        if (entity) {
+            return entity;
+        }
+    }
+
+    ecs_entity_t entity = ++ world->last_handle;
+
+    ecs_assert(!world->max_handle || entity <= world->max_handle, 
+        ECS_OUT_OF_RANGE, NULL);
+
+    return entity;
 }
 
 /* -- Public functions -- */
@@ -1034,17 +1255,26 @@ ecs_entity_t _ecs_new(
 
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
 
-    ecs_entity_t entity = ++ world->last_handle;
-
-    ecs_assert(!world->max_handle || entity <= world->max_handle, 
-        ECS_OUT_OF_RANGE, NULL);
+    ecs_entity_t entity = new_entity_handle(world, stage);
 
     if (type) {
-        ecs_entity_info_t info = {
-            .entity = entity
-        };
+        if (ecs_stage_is_deferred(world, stage)) {
+            ecs_stage_defer_add_remove(stage, entity, type, 0);
+            return entity;
+        }
+
+        if (world->sparse_type) {
+            ecs_type_t to_remove = NULL;
+            ecs_sparse_add_remove(world, stage, entity, &type, &to_remove);
+        }
 
-        commit(world, stage, &info, type, type, 0, true);
+        if (type) {
+            ecs_entity_info_t info = {
+                .entity = entity
+            };
+
+            commit(world, stage, &info, type, type, 0, true, NULL);
+        }
     }
 
     return entity;
@@ -1052,7 +1282,7 @@ ecs_entity_t _ecs_new(
 
 static
 bool has_unset_columns(
-    ecs_type_t type,
+    ecs_table_t *table,
     ecs_table_column_t *columns,
     ecs_table_data_t *data)
 {
@@ -1069,7 +1299,7 @@ bool has_unset_columns(
             continue;
         }
 
-        int32_t column = ecs_type_index_of(type, component);
+        int32_t column = ecs_table_column_index(table, component);
         ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
 
         uint32_t size = columns[column + 1].size;
@@ -1085,7 +1315,7 @@ bool has_unset_columns(
 
 static
 void copy_column_data(
-    ecs_type_t type,
+    ecs_table_t *table,
     ecs_table_column_t *columns,
     uint32_t start_row,
     ecs_table_data_t *data)
@@ -1103,7 +1333,7 @@ void copy_column_data(
             continue;
         }
 
-        int32_t column = ecs_type_index_of(type, component);
+        int32_t column = ecs_table_column_index(table, component);
         ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
 
         uint32_t size = columns[column + 1].size;
@@ -1224,7 +1454,7 @@ uint32_t update_entity_index(
     int32_t src_first_contiguous_row = 0;
 
     /* Obtain the entity index in the current stage */
-    ecs_map_t *entity_index = stage->entity_index;
+    ecs_ei_t *entity_index = stage->entity_index;
     ecs_entity_t e;
 
     /* We need to commit each entity individually in order to populate
@@ -1253,14 +1483,15 @@ uint32_t update_entity_index(
 
             /* Ensure that the last issued handle will always be ahead of the
              * entities created by this operation */
-            if (e > world->last_handle) {
-                world->last_handle = e + 1;
+            ecs_entity_t id = ecs_ei_id(world->main_stage.entity_index, e);
+            if (id > world->last_handle) {
+                world->last_handle = id + 1;
             }                            
         } else {
             e = i + start_entity;
         }
 
-        ecs_row_t *row_ptr = ecs_map_get_ptr(entity_index, e);
+        ecs_row_t *row_ptr = ecs_ei_get(entity_index, e);
         if (row_ptr) {
             src_row = row_ptr->index;
             uint8_t is_monitored = 1 - (src_row < 0) * 2;
@@ -1315,7 +1546,7 @@ uint32_t update_entity_index(
                      * must be copied from the old table to the new table */
                     if (!tested_for_unset) {
                         has_unset = has_unset_columns(
-                            type, columns, data);
+                            table, columns, data);
                         tested_for_unset = true;
                     }
 
@@ -1384,7 +1615,7 @@ uint32_t update_entity_index(
                 .type = type, .index = dst_start_row + i + 1
             };
 
-            ecs_map_set(entity_index, e, &new_row);
+            ecs_ei_set(entity_index, e, &new_row);
 
             if (data->entities) {
                 ecs_table_insert(world, table, columns, e);
@@ -1502,6 +1733,21 @@ ecs_entity_t set_w_data_intern(
         ECS_OUT_OF_RANGE, NULL);
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
 
+    if (world->sparse_type && type && ecs_type_contains(
+        world, type, world->sparse_type, false, false)) 
+    {
+        /* Add sparse tags to each entity. The remaining type only contains
+         * components that are stored in the table. */
+        ecs_type_t sparse_type = type;
+        uint32_t i;
+        for (i = 0; i < count; i ++) {
+            ecs_entity_t entity = data->entities ? data->entities[i] : result + i;
+            ecs_type_t to_add = sparse_type, to_remove = NULL;
+            ecs_sparse_add_remove(world, stage, entity, &to_add, &to_remove);
+            type = to_add;
+        }
+    }
+
     if (type) {
         /* Get table, table columns and grow table to accomodate for new
          * entities */
@@ -1512,15 +1758,14 @@ ecs_entity_t set_w_data_intern(
         uint32_t start_row = 0;
 
         /* Obtain the entity index in the current stage */
-        ecs_map_t *entity_index = stage->entity_index;
+        ecs_ei_t *entity_index = stage->entity_index;
 
         /* Grow world entity index only if no entity ids are provided. If ids
          * are provided, it is possible that they already appear in the entity
          * index, in which case they will be overwritten. */
-        uint32_t cur_index_count = ecs_map_count(entity_index);
         if (!data->entities) {
             start_row = ecs_table_grow(world, table, columns, count, result) - 1;
-            ecs_map_grow(entity_index, cur_index_count + count);
+            ecs_ei_grow(entity_index, result, count);
         }
 
         /* Obtain list of entities */
@@ -1560,7 +1805,7 @@ ecs_entity_t set_w_data_intern(
          * entities are nicely ordered in the destination table, we can copy the
          * data into each column with a single memcpy. */
         if (data->columns) {
-            copy_column_data(type, columns, start_row, data);
+            copy_column_data(table, columns, start_row, data);
         }
 
         /* Invoke OnSet systems */
@@ -1680,6 +1925,11 @@ void ecs_delete(
     ecs_stage_t *stage = ecs_get_stage(&world);
     bool in_progress = world->in_progress;
 
+    if (ecs_stage_is_deferred(world, stage)) {
+        ecs_stage_defer_delete(stage, entity);
+        return;
+    }
+
     if (!in_progress) {
         if (stage_has_entity(&world->main_stage, entity, &row)) {
             ecs_entity_info_t info = {
@@ -1689,10 +1939,13 @@ void ecs_delete(
                 .table = ecs_world_get_table(world, stage, row.type)
             };
 
-            commit(world, stage, &info, 0, 0, row.type, false);
+            commit(world, stage, &info, 0, 0, row.type, false, NULL);
 
-            ecs_map_remove(world->main_stage.entity_index, entity);
+            ecs_ei_remove(world->main_stage.entity_index, entity);
         }
+
+        ecs_sparse_remove_entity(world, entity);
+        ecs_recycle_entity(world, entity);
     } else {
         /* Mark components of the entity in the main stage as removed. This will
          * ensure that subsequent calls to ecs_has, ecs_get and ecs_is_empty will
@@ -1703,8 +1956,172 @@ void ecs_delete(
 
         /* Remove the entity from the staged index. Any added components while
          * in progress will be discarded as a result. */
-        ecs_map_set(stage->entity_index, entity, &((ecs_row_t){0, 0}));
+        ecs_ei_set(stage->entity_index, entity, &((ecs_row_t){0, 0}));
+
+        /* The id is recycled after the stage is merged, if the entity has not
+         * been recreated in the meantime */
+        ecs_entity_t *elem = ecs_vector_add(&stage->deleted, &handle_arr_params);
+        *elem = entity;
+    }
+}
+
+/** Row of an entity that is deleted in a batch */
+typedef struct delete_item_t {
+    ecs_table_t *table;
+    uint32_t row;
+    ecs_entity_t entity;
+} delete_item_t;
+
+/** Order deleted rows by table, and by row within a table */
+static
+int compare_delete_item(
+    const void *p1,
+    const void *p2)
+{
+    const delete_item_t *item1 = p1;
+    const delete_item_t *item2 = p2;
+
+    if (item1->table != item2->table) {
+        return ((uintptr_t)item1->table > (uintptr_t)item2->table) - 
+            ((uintptr_t)item1->table < (uintptr_t)item2->table);
     }
+
+    return (item1->row > item2->row) - (item1->row < item2->row);
+}
+
+/** Look up the rows of entities in the main stage, ordered by table and row.
+ * Entities that are not stored in a table, and duplicates, are skipped. */
+static
+uint32_t collect_delete_items(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    uint32_t count,
+    delete_item_t *items)
+{
+    ecs_stage_t *stage = &world->main_stage;
+    ecs_type_t type = NULL;
+    ecs_table_t *table = NULL;
+    uint32_t i, item_count = 0;
+    bool is_sorted = true;
+
+    for (i = 0; i < count; i ++) {
+        ecs_row_t *row = ecs_ei_get(stage->entity_index, entities[i]);
+        if (!row || !row->type) {
+            continue;
+        }
+
+        /* Entities deleted together often share a table */
+        if (row->type != type) {
+            type = row->type;
+            table = ecs_world_get_table(world, stage, type);
+        }
+
+        int32_t index = row->index;
+        if (index < 0) {
+            /* Systems may depend on components of watched entities */
+            world->should_match = true;
+            index = -index;
+        }
+
+        items[item_count] = (delete_item_t){
+            .table = table,
+            .row = index,
+            .entity = entities[i]
+        };
+
+        if (item_count && is_sorted) {
+            is_sorted = compare_delete_item(
+                &items[item_count - 1], &items[item_count]) < 0;
+        }
+
+        item_count ++;
+    }
+
+    /* Entities deleted by a system are usually already ordered by row */
+    if (!is_sorted) {
+        qsort(items, item_count, sizeof(delete_item_t), compare_delete_item);
+    }
+
+    uint32_t unique_count = 0;
+    for (i = 0; i < item_count; i ++) {
+        if (!unique_count || 
+            compare_delete_item(&items[unique_count - 1], &items[i])) 
+        {
+            items[unique_count ++] = items[i];
+        }
+    }
+
+    return unique_count;
+}
+
+void ecs_delete_entities(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    uint32_t count)
+{
+    ecs_assert(!world->in_progress, ECS_INTERNAL_ERROR, NULL);
+
+    if (!count) {
+        return;
+    }
+
+    ecs_stage_t *stage = &world->main_stage;
+    delete_item_t *items = ecs_os_malloc(count * sizeof(delete_item_t));
+    ecs_assert(items != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    uint32_t i, end, item_count = collect_delete_items(
+        world, entities, count, items);
+    uint32_t commit_count = stage->commit_count;
+
+    /* Invoke OnRemove systems once for each range of consecutive rows */
+    for (i = 0; i < item_count; i = end) {
+        ecs_table_t *table = items[i].table;
+
+        for (end = i + 1; end < item_count; end ++) {
+            if (items[end].table != table || 
+                items[end].row != items[end - 1].row + 1) 
+            {
+                break;
+            }
+        }
+
+        notify_post_merge(world, stage, table, table->columns, 
+            items[i].row - 1, end - i, table->type);
+    }
+
+    /* If OnRemove systems committed entities, rows may have moved */
+    if (stage->commit_count != commit_count) {
+        item_count = collect_delete_items(world, entities, count, items);
+    }
+
+    /* Remove the rows of each table in a single pass */
+    uint32_t *rows = ecs_os_malloc(count * sizeof(uint32_t));
+    ecs_assert(rows != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    for (i = 0; i < item_count; i ++) {
+        rows[i] = items[i].row;
+    }
+
+    for (i = 0; i < item_count; i = end) {
+        ecs_table_t *table = items[i].table;
+        end = i + 1;
+        while (end < item_count && items[end].table == table) {
+            end ++;
+        }
+
+        ecs_table_delete_rows(world, stage, table, NULL, &rows[i], end - i);
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_ei_remove(stage->entity_index, entities[i]);
+        ecs_sparse_remove_entity(world, entities[i]);
+    }
+
+    ecs_os_free(rows);
+    ecs_os_free(items);
+
+    stage->commit_count ++;
+    world->valid_schedule = false;
 }
 
 void ecs_delete_w_filter_intern(
@@ -1737,7 +2154,11 @@ void ecs_delete_w_filter_intern(
         ecs_entity_t *array = ecs_vector_first(entities);
         uint32_t j, row_count = ecs_vector_count(entities);
         for (j = 0; j < row_count; j ++) {
-            ecs_map_remove(world->main_stage.entity_index, array[j]);
+            ecs_ei_remove(world->main_stage.entity_index, array[j]);
+            ecs_sparse_remove_entity(world, array[j]);
+            if (is_delete) {
+                ecs_recycle_entity(world, array[j]);
+            }
         }
 
         /* Both filters passed, clear table */
@@ -1763,6 +2184,44 @@ void ecs_clear_w_filter(
     ecs_delete_w_filter_intern(world, filter, false);
 }
 
+/* Add and remove sparse tags for the entities that match a filter. On return,
+ * to_add and to_remove only contain components that are stored in tables. */
+static
+void add_remove_sparse_w_filter(
+    ecs_world_t *world,
+    ecs_type_t *to_add,
+    ecs_type_t *to_remove,
+    const ecs_filter_t *filter)
+{
+    ecs_type_t sparse_type = world->sparse_type;
+    ecs_type_t add = *to_add, remove = *to_remove;
+
+    if (!ecs_type_contains(world, add, sparse_type, false, false) &&
+        !ecs_type_contains(world, remove, sparse_type, false, false))
+    {
+        return;
+    }
+
+    ecs_stage_t *stage = &world->main_stage;
+    ecs_filter_iter_t it = ecs_filter_iter(world, filter);
+    while (ecs_filter_next(&it)) {
+        uint32_t i;
+        for (i = 0; i < it.rows.count; i ++) {
+            ecs_type_t entity_add = add, entity_remove = remove;
+            ecs_sparse_add_remove(
+                world, stage, it.rows.entities[i], &entity_add, &entity_remove);
+        }
+    }
+
+    if (add) {
+        *to_add = ecs_type_merge_intern(world, stage, add, NULL, sparse_type);
+    }
+    if (remove) {
+        *to_remove = ecs_type_merge_intern(
+            world, stage, remove, NULL, sparse_type);
+    }
+}
+
 void _ecs_add_remove_w_filter(
     ecs_world_t *world,
     ecs_type_t to_add,
@@ -1775,6 +2234,13 @@ void _ecs_add_remove_w_filter(
     ecs_assert(stage == &world->main_stage, ECS_UNSUPPORTED, 
         "remove_w_filter currently only supported on main stage");
 
+    if (world->sparse_type) {
+        add_remove_sparse_w_filter(world, &to_add, &to_remove, filter);
+        if (!to_add && !to_remove) {
+            return;
+        }
+    }
+
     uint32_t i, count = ecs_chunked_count(stage->tables);
 
     for (i = 0; i < count; i ++) {
@@ -1839,14 +2305,14 @@ ecs_entity_t copy_from_stage(
 
         ecs_assert(!dst_entity, ECS_INTERNAL_ERROR, NULL);
 
-        dst_entity = ++ world->last_handle;
+        dst_entity = new_entity_handle(world, stage);
         new_type = src_info.type;
 
         ecs_entity_info_t info = {
             .entity = dst_entity
         };
 
-        commit(world, stage, &info, new_type, src_info.type, 0, false);
+        commit(world, stage, &info, new_type, src_info.type, 0, false, NULL);
 
         if (copy_value) {
             copy_row(info.table->type, info.columns, info.index,
@@ -1879,9 +2345,11 @@ ecs_entity_t ecs_clone(
     }
 
     if (!result) {
-        result = ++ world->last_handle;
+        result = new_entity_handle(world, stage);
     }
 
+    ecs_sparse_clone(world, stage, entity, result);
+
     return result;
 }
 
@@ -2020,6 +2488,12 @@ ecs_entity_t _ecs_set_ptr_intern(
     ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_world_t *world_arg = world;
     ecs_stage_t *stage = ecs_get_stage(&world);
+
+    if (ecs_stage_is_deferred(world, stage)) {
+        ecs_stage_defer_set(stage, entity, component, size, ptr);
+        return entity;
+    }
+
     ecs_type_t type = ecs_type_from_entity(world, component);
     ecs_entity_info_t info = {.entity = entity};
 
@@ -2050,6 +2524,11 @@ ecs_entity_t _ecs_set_ptr_intern(
         }
     }
 
+    int16_t column_index = ecs_table_column_index(info.table, component);
+    if (column_index != -1) {
+        info.columns[column_index + 1].change_tick = world->change_tick;
+    }
+
     notify_pre_merge(
         world_arg, stage, info.table, info.columns, info.index - 1, 1, type,
         world->type_sys_set_index);
@@ -2094,6 +2573,15 @@ bool ecs_has_intern(
     }
 
     ecs_world_t *world_arg = world;
+    ecs_get_stage(&world);
+
+    if (world->sparse_type && ecs_type_contains(
+        world, type, world->sparse_type, false, false)) 
+    {
+        return ecs_sparse_has(
+            world_arg, entity, type, match_any, match_prefabs);
+    }
+
     ecs_type_t entity_type = ecs_get_type(world_arg, entity);
     return ecs_type_contains(world, entity_type, type, match_any, match_prefabs) != 0;
 }
@@ -2146,6 +2634,13 @@ bool ecs_has_entity(
     }
 
     ecs_world_t *world_arg = world;
+    ecs_get_stage(&world);
+
+    if (ecs_sparse_get_set(world, component)) {
+        return ecs_sparse_has(world_arg, entity, 
+            ecs_type_from_entity(world, component), false, false);
+    }
+
     ecs_type_t entity_type = ecs_get_type(world_arg, entity);
     return ecs_type_has_entity_intern(world, entity_type, component, true);
 }
@@ -2166,6 +2661,13 @@ bool ecs_has_entity_owned(
     }
 
     ecs_world_t *world_arg = world;
+    ecs_get_stage(&world);
+
+    if (ecs_sparse_get_set(world, component)) {
+        return ecs_sparse_has(world_arg, entity, 
+            ecs_type_from_entity(world, component), false, false);
+    }
+
     ecs_type_t entity_type = ecs_get_type(world_arg, entity);
     return ecs_type_has_entity_intern(world, entity_type, component, false);
 }
@@ -2308,14 +2810,21 @@ uint32_t ecs_count_w_filter(
 {
     ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    ecs_chunked_t *tables = world->main_stage.tables;
-    uint32_t i, count = ecs_chunked_count(tables);
     uint32_t result = 0;
 
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+    if (filter) {
+        /* Use filter iterator, which only visits tables from the component
+         * index with the rarest component of the filter */
+        ecs_filter_iter_t it = ecs_filter_iter(world, filter);
+        while (ecs_filter_next(&it)) {
+            result += it.rows.count;
+        }
+    } else {
+        ecs_chunked_t *tables = world->main_stage.tables;
+        uint32_t i, count = ecs_chunked_count(tables);
 
-        if (!filter || ecs_type_match_w_filter(world, table->type, filter)) {
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
             result += ecs_vector_count(table->columns[0].data); 
         }
     }
@@ -2331,6 +2840,12 @@ uint32_t _ecs_count(
         return 0;
     }
 
+    if (world->sparse_type && ecs_type_contains(
+        world, type, world->sparse_type, false, false)) 
+    {
+        return ecs_sparse_count(world, type);
+    }
+
     return ecs_count_w_filter(world, &(ecs_filter_t){
         .include = type
     });
@@ -2340,17 +2855,33 @@ ecs_entity_t ecs_new_component(
     ecs_world_t *world,
     const char *id,
     size_t size)
+{
+    return ecs_new_component_w_alignment(world, id, size, 0);
+}
+
+ecs_entity_t ecs_new_component_w_alignment(
+    ecs_world_t *world,
+    const char *id,
+    size_t size,
+    size_t alignment)
 {
     ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
     assert(world->magic == ECS_WORLD_MAGIC);
 
+    /* Alignment must be a power of two, and the size of a component must be a
+     * multiple of its alignment so that all elements in a column are aligned */
+    ecs_assert(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(!alignment || !(size % alignment), ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(alignment <= UINT16_MAX, ECS_INVALID_PARAMETER, NULL);
+
     ecs_entity_t result = ecs_lookup(world, id);
     if (result) {
         return result;
     }
 
     result = _ecs_new(world, world->t_component);
-    ecs_set(world, result, EcsComponent, {.size = size});
+    ecs_set(world, result, EcsComponent, {
+        .size = size, .alignment = alignment});
     ecs_set(world, result, EcsId, {id});
 
     return result;
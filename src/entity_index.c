@@ -0,0 +1,491 @@
+#include "flecs_private.h"
+
+/* The entity index is a sparse set that maps entity ids to ecs_row_t. The
+ * sparse part is divided in pages of ECS_ENTITY_PAGE_SIZE entries, indexed by
+ * the lower 32 bits of the id. Pages are allocated when the first entity in
+ * their range is added, so applications that use a few far apart id ranges
+ * only pay for the pages they use. Looking up an entity is a load of the page
+ * pointer followed by a load of the entry.
+ *
+ * The dense part stores the (full) ids of the entities in the index, which
+ * makes it possible to iterate and count the entities, and to clear the index
+ * without visiting all pages.
+ *
+ * An entry stores the generation of the id it was last set with. Lookups with
+ * an id of a different generation are treated as lookups for an entity that is
+ * not in the index, so stale handles are detected. Ids that do not fit in the
+ * lower 32 bits and the generation are stored in a regular map.
+ *
+ * Generations are only issued by recycling, so an id with bits in the
+ * generation is only a handle of a recycled id if the entry of its lower 32
+ * bits has that generation. Other ids with those bits set, as issued from an
+ * entity range above 2^32, are stored in the map as well, so that they do not
+ * alias the entities with small ids.
+ *
+ * Ids of deleted entities can be recycled. Recycling an id increases the
+ * generation of its entry, and stores the id with the new generation in a
+ * free list from which new entities take their id. */
+
+#define ECS_ENTITY_PAGE_MASK (ECS_ENTITY_PAGE_SIZE - 1)
+#define ECS_ENTITY_HI_MASK (~(ECS_GENERATION_MASK | (ecs_entity_t)UINT32_MAX))
+
+typedef struct ecs_ei_entry_t {
+    ecs_row_t row;          /* Table and row of the entity */
+    uint32_t dense;         /* Index in dense array + 1 (0 if not in index) */
+    uint32_t generation;    /* Generation of the id the entry was set with */
+} ecs_ei_entry_t;
+
+struct ecs_ei_t {
+    ecs_ei_entry_t **pages; /* Sparse array of pages */
+    uint32_t page_count;    /* Number of elements in pages array */
+    ecs_vector_t *dense;    /* Ids of entities in the index */
+    ecs_map_t *hi;          /* Entities with ids that do not fit in pages */
+    ecs_vector_t *free;     /* Recycled ids, with their new generation */
+};
+
+static ecs_vector_params_t dense_params = {.element_size = sizeof(ecs_entity_t)};
+
+static
+ecs_ei_entry_t* get_entry(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    uint32_t page = (uint32_t)entity / ECS_ENTITY_PAGE_SIZE;
+    if (page >= ei->page_count) {
+        return NULL;
+    }
+
+    ecs_ei_entry_t *entries = ei->pages[page];
+    if (!entries) {
+        return NULL;
+    }
+
+    return &entries[(uint32_t)entity & ECS_ENTITY_PAGE_MASK];
+}
+
+static
+ecs_ei_entry_t* ensure_page(
+    ecs_ei_t *ei,
+    uint32_t page)
+{
+    if (page >= ei->page_count) {
+        uint32_t page_count = ei->page_count ? ei->page_count : 1;
+        while (page_count <= page) {
+            page_count *= 2;
+        }
+
+        ei->pages = ecs_os_realloc(
+            ei->pages, page_count * sizeof(ecs_ei_entry_t*));
+        ecs_assert(ei->pages != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+        memset(&ei->pages[ei->page_count], 0,
+            (page_count - ei->page_count) * sizeof(ecs_ei_entry_t*));
+        ei->page_count = page_count;
+    }
+
+    ecs_ei_entry_t *entries = ei->pages[page];
+    if (!entries) {
+        entries = ecs_os_calloc(ECS_ENTITY_PAGE_SIZE, sizeof(ecs_ei_entry_t));
+        ecs_assert(entries != NULL, ECS_OUT_OF_MEMORY, NULL);
+        ei->pages[page] = entries;
+    }
+
+    return entries;
+}
+
+static
+ecs_ei_entry_t* ensure_entry(
+    ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    ecs_ei_entry_t *entries = ensure_page(
+        ei, (uint32_t)entity / ECS_ENTITY_PAGE_SIZE);
+    return &entries[(uint32_t)entity & ECS_ENTITY_PAGE_MASK];
+}
+
+static
+bool is_hi(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    if (entity & ECS_ENTITY_HI_MASK) {
+        return true;
+    }
+
+    uint32_t generation = ECS_GENERATION(entity);
+    if (!generation) {
+        return false;
+    }
+
+    ecs_ei_entry_t *entry = get_entry(ei, entity);
+    return !entry || entry->generation != generation;
+}
+
+static
+bool is_alive(
+    const ecs_ei_entry_t *entry,
+    ecs_entity_t entity)
+{
+    return entry && entry->dense &&
+        entry->generation == ECS_GENERATION(entity);
+}
+
+/* -- Private functions -- */
+
+ecs_ei_t* ecs_ei_new(
+    uint32_t size)
+{
+    ecs_ei_t *result = ecs_os_calloc(1, sizeof(ecs_ei_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    result->dense = ecs_vector_new(&dense_params, size);
+    result->hi = ecs_map_new(0, sizeof(ecs_row_t));
+
+    return result;
+}
+
+void ecs_ei_free(
+    ecs_ei_t *ei)
+{
+    uint32_t i;
+    for (i = 0; i < ei->page_count; i ++) {
+        ecs_os_free(ei->pages[i]);
+    }
+
+    ecs_os_free(ei->pages);
+    ecs_vector_free(ei->dense);
+    ecs_vector_free(ei->free);
+    ecs_map_free(ei->hi);
+    ecs_os_free(ei);
+}
+
+void ecs_ei_clear(
+    ecs_ei_t *ei)
+{
+    /* Reset only the entries of entities in the index, and keep the pages so
+     * that stages don't reallocate them every frame */
+    ecs_entity_t *dense = ecs_vector_first(ei->dense);
+    uint32_t i, count = ecs_vector_count(ei->dense);
+
+    for (i = 0; i < count; i ++) {
+        ecs_ei_entry_t *entry = get_entry(ei, dense[i]);
+        ecs_assert(entry != NULL, ECS_INTERNAL_ERROR, NULL);
+        entry->row = (ecs_row_t){0, 0};
+        entry->dense = 0;
+    }
+
+    ecs_vector_clear(ei->dense);
+    ecs_map_clear(ei->hi);
+}
+
+ecs_ei_t* ecs_ei_copy(
+    const ecs_ei_t *ei)
+{
+    ecs_ei_t *dst = ecs_os_memdup(ei, sizeof(ecs_ei_t));
+
+    if (ei->pages) {
+        dst->pages = ecs_os_memdup(
+            ei->pages, ei->page_count * sizeof(ecs_ei_entry_t*));
+
+        uint32_t i;
+        for (i = 0; i < ei->page_count; i ++) {
+            if (ei->pages[i]) {
+                dst->pages[i] = ecs_os_memdup(ei->pages[i],
+                    ECS_ENTITY_PAGE_SIZE * sizeof(ecs_ei_entry_t));
+            }
+        }
+    }
+
+    dst->dense = ecs_vector_copy(ei->dense, &dense_params);
+    dst->free = ecs_vector_copy(ei->free, &dense_params);
+    dst->hi = ecs_map_copy(ei->hi);
+
+    return dst;
+}
+
+ecs_row_t* ecs_ei_get(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    if (is_hi(ei, entity)) {
+        return ecs_map_get_ptr(ei->hi, entity);
+    }
+
+    ecs_ei_entry_t *entry = get_entry(ei, entity);
+    if (is_alive(entry, entity)) {
+        return &entry->row;
+    }
+
+    return NULL;
+}
+
+bool ecs_ei_has(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity,
+    ecs_row_t *row_out)
+{
+    ecs_row_t *row = ecs_ei_get(ei, entity);
+    if (row) {
+        if (row_out) {
+            *row_out = *row;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+ecs_row_t* ecs_ei_set(
+    ecs_ei_t *ei,
+    ecs_entity_t entity,
+    const ecs_row_t *row)
+{
+    if (is_hi(ei, entity)) {
+        return ecs_map_set(ei->hi, entity, row);
+    }
+
+    ecs_ei_entry_t *entry = ensure_entry(ei, entity);
+
+    if (!entry->dense) {
+        ecs_entity_t *elem = ecs_vector_add(&ei->dense, &dense_params);
+        *elem = entity;
+        entry->dense = ecs_vector_count(ei->dense);
+        entry->generation = ECS_GENERATION(entity);
+    } else {
+        /* A live entity can only be set with the handle it was created with */
+        ecs_assert(entry->generation == ECS_GENERATION(entity),
+            ECS_INVALID_HANDLE, NULL);
+    }
+
+    entry->row = *row;
+
+    return &entry->row;
+}
+
+void ecs_ei_remove(
+    ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    if (is_hi(ei, entity)) {
+        ecs_map_remove(ei->hi, entity);
+        return;
+    }
+
+    ecs_ei_entry_t *entry = get_entry(ei, entity);
+    if (!is_alive(entry, entity)) {
+        return;
+    }
+
+    /* Move last entity in dense array to the position of the removed one */
+    ecs_entity_t *dense = ecs_vector_first(ei->dense);
+    uint32_t index = entry->dense - 1;
+    uint32_t last = ecs_vector_count(ei->dense) - 1;
+
+    if (index != last) {
+        ecs_entity_t moved = dense[last];
+        ecs_ei_entry_t *moved_entry = get_entry(ei, moved);
+        ecs_assert(moved_entry != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        dense[index] = moved;
+        moved_entry->dense = index + 1;
+    }
+
+    ecs_vector_remove_last(ei->dense);
+
+    entry->row = (ecs_row_t){0, 0};
+    entry->dense = 0;
+}
+
+uint32_t ecs_ei_count(
+    const ecs_ei_t *ei)
+{
+    return ecs_vector_count(ei->dense) + ecs_map_count(ei->hi);
+}
+
+void ecs_ei_grow(
+    ecs_ei_t *ei,
+    ecs_entity_t first,
+    uint32_t count)
+{
+    if (!count) {
+        return;
+    }
+
+    uint32_t size = ecs_vector_count(ei->dense) + count;
+    if (size > ecs_vector_size(ei->dense)) {
+        ecs_vector_set_size(&ei->dense, &dense_params, size);
+    }
+
+    /* New ids are never recycled, so only ids below 2^32 are stored in pages */
+    ecs_entity_t last = first + count - 1;
+    if ((first | last) & ~(ecs_entity_t)UINT32_MAX) {
+        return;
+    }
+
+    uint32_t page;
+    for (page = (uint32_t)first / ECS_ENTITY_PAGE_SIZE;
+         page <= (uint32_t)last / ECS_ENTITY_PAGE_SIZE;
+         page ++)
+    {
+        ensure_page(ei, page);
+    }
+}
+
+bool ecs_ei_recycle(
+    ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    if (is_hi(ei, entity)) {
+        return false;
+    }
+
+    /* Only recycle ids of entities that have been removed from the index, and
+     * only once, which is guaranteed by the generation check */
+    ecs_ei_entry_t *entry = ensure_entry(ei, entity);
+    if (entry->dense || 
+        entry->generation != ECS_GENERATION(entity)) 
+    {
+        return false;
+    }
+
+    /* Skip generations of which the handle is already used by a large id */
+    ecs_entity_t handle;
+    do {
+        entry->generation = (entry->generation + 1) & 0xFFFF;
+        handle = (uint32_t)entity | ((ecs_entity_t)entry->generation << 32);
+    } while (entry->generation && ecs_map_get_ptr(ei->hi, handle));
+
+    ecs_entity_t *elem = ecs_vector_add(&ei->free, &dense_params);
+    *elem = handle;
+
+    return true;
+}
+
+ecs_entity_t ecs_ei_id(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity)
+{
+    if (is_hi(ei, entity)) {
+        return entity;
+    }
+
+    return (uint32_t)entity;
+}
+
+ecs_entity_t ecs_ei_recycled(
+    ecs_ei_t *ei)
+{
+    ecs_entity_t entity;
+
+    while (ecs_vector_pop(ei->free, &dense_params, &entity)) {
+        /* An id is skipped if its entry was set with a stale handle after it
+         * was recycled, in which case the generation no longer matches */
+        ecs_ei_entry_t *entry = get_entry(ei, entity);
+        ecs_assert(entry != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (!entry->dense && entry->generation == ECS_GENERATION(entity)) {
+            return entity;
+        }
+    }
+
+    return 0;
+}
+
+void ecs_ei_filter_recycled(
+    ecs_ei_t *ei,
+    ecs_entity_t min,
+    ecs_entity_t max)
+{
+    ecs_entity_t *free_ids = ecs_vector_first(ei->free);
+    uint32_t i, count = ecs_vector_count(ei->free), kept = 0;
+    if (!count) {
+        return;
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t id = (uint32_t)free_ids[i];
+        if (id >= min && (!max || id <= max)) {
+            free_ids[kept ++] = free_ids[i];
+        }
+    }
+
+    ecs_vector_set_count(&ei->free, &dense_params, kept);
+}
+
+void ecs_ei_memory(
+    const ecs_ei_t *ei,
+    uint32_t *total,
+    uint32_t *used)
+{
+    if (!ei) {
+        return;
+    }
+
+    uint32_t i, page_count = 0;
+    for (i = 0; i < ei->page_count; i ++) {
+        if (ei->pages[i]) {
+            page_count ++;
+        }
+    }
+
+    if (total) {
+        *total += sizeof(ecs_ei_t) + ei->page_count * sizeof(ecs_ei_entry_t*);
+        *total += page_count * ECS_ENTITY_PAGE_SIZE * sizeof(ecs_ei_entry_t);
+    }
+
+    if (used) {
+        *used += ecs_vector_count(ei->dense) * sizeof(ecs_ei_entry_t);
+    }
+
+    ecs_vector_memory(ei->dense, &dense_params, total, used);
+    ecs_vector_memory(ei->free, &dense_params, total, used);
+    ecs_map_memory(ei->hi, total, used);
+}
+
+ecs_ei_iter_t ecs_ei_iter(
+    ecs_ei_t *ei)
+{
+    return (ecs_ei_iter_t){
+        .ei = ei,
+        .index = -1,
+        .hi_iter = ecs_map_iter(ei->hi)
+    };
+}
+
+bool ecs_ei_hasnext(
+    ecs_ei_iter_t *it)
+{
+    uint32_t count = ecs_vector_count(it->ei->dense);
+    uint32_t index = it->index + 1;
+
+    if (index < count) {
+        it->index = index;
+        return true;
+    }
+
+    it->index = count;
+
+    return ecs_map_hasnext(&it->hi_iter);
+}
+
+ecs_row_t* ecs_ei_next(
+    ecs_ei_iter_t *it,
+    ecs_entity_t *entity_out)
+{
+    ecs_ei_t *ei = it->ei;
+
+    if (it->index < ecs_vector_count(ei->dense)) {
+        ecs_entity_t *dense = ecs_vector_first(ei->dense);
+        ecs_entity_t entity = dense[it->index];
+        ecs_ei_entry_t *entry = get_entry(ei, entity);
+        ecs_assert(entry != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (entity_out) {
+            *entity_out = entity;
+        }
+
+        return &entry->row;
+    }
+
+    return ecs_map_next_w_key(&it->hi_iter, entity_out);
+}
@@ -1,6 +1,41 @@
-
 #include "flecs_private.h"
 
+/* Find component to iterate tables for. Only filters that require all
+ * components can use the component index. */
+static
+ecs_entity_t filter_component(
+    ecs_world_t *world,
+    const ecs_filter_t *filter)
+{
+    if (!filter || !filter->include || filter->include_kind == EcsMatchAny) {
+        return 0;
+    }
+
+    return ecs_world_get_rarest_component(world, filter->include);
+}
+
+static
+bool filter_table(
+    ecs_filter_iter_t *iter,
+    ecs_table_t *table)
+{
+    if (!table->columns) {
+        return false;
+    }
+
+    if (!ecs_type_match_w_filter(iter->rows.world, table->type, &iter->filter)) {
+        return false;
+    }
+
+    ecs_rows_t *rows = &iter->rows;
+    rows->table = table;
+    rows->table_columns = table->columns;
+    rows->count = ecs_vector_count(table->columns[0].data);
+    rows->entities = ecs_vector_first(table->columns[0].data);
+
+    return true;
+}
+
 ecs_filter_iter_t ecs_filter_iter(
     ecs_world_t *world,
     const ecs_filter_t *filter)
@@ -9,6 +44,8 @@ ecs_filter_iter_t ecs_filter_iter(
         .filter = filter ? *filter : (ecs_filter_t){0},
         .tables = world->main_stage.tables,
         .index = 0,
+        .component = filter_component(world, filter),
+        .prefab_index = 0,
         .rows = {
             .world = world
         }
@@ -24,6 +61,8 @@ ecs_filter_iter_t ecs_snapshot_filter_iter(
         .filter = filter ? *filter : (ecs_filter_t){0},
         .tables = snapshot->tables,
         .index = 0,
+        .component = 0,
+        .prefab_index = 0,
         .rows = {
             .world = world
         }
@@ -33,6 +72,19 @@ ecs_filter_iter_t ecs_snapshot_filter_iter(
 bool ecs_filter_next(
     ecs_filter_iter_t *iter)
 {
+    if (iter->component) {
+        ecs_table_t *table;
+        while ((table = ecs_world_next_table(iter->rows.world, 
+            iter->component, &iter->index, &iter->prefab_index))) 
+        {
+            if (filter_table(iter, table)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     ecs_chunked_t *tables = iter->tables;
     int32_t count = ecs_chunked_count(tables);
     int32_t i;
@@ -40,21 +92,10 @@ bool ecs_filter_next(
     for (i = iter->index; i < count; i ++) {
         ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
 
-        if (!table->columns) {
-            continue;
+        if (filter_table(iter, table)) {
+            iter->index = ++i;
+            return true;
         }
-
-        if (!ecs_type_match_w_filter(iter->rows.world, table->type, &iter->filter)) {
-            continue;
-        }
-
-        ecs_rows_t *rows = &iter->rows;
-        rows->table = table;
-        rows->table_columns = table->columns;
-        rows->count = ecs_table_count(table);
-        rows->entities = ecs_vector_first(table->columns[0].data);
-        iter->index = ++i;
-        return true;
     }
 
     return false;
@@ -7,12 +7,44 @@
 
 /* -- Entity API -- */
 
-/* Merge entity with stage */
-void ecs_merge_entity(
+/* Commit staged type of entity to main stage. Returns true if the entity has
+ * staged data, in which case item_out is set to the data to copy. */
+bool ecs_merge_commit(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_entity_t entity,
-    ecs_row_t staged_row);
+    ecs_row_t staged_row,
+    ecs_merge_item_t *item_out);
+
+/* Copy staged data of entity to main stage. The row of the entity must be
+ * looked up again if other entities have been committed since the item was
+ * created, as they may have moved the entity. */
+void ecs_merge_copy(
+    ecs_world_t *world,
+    ecs_merge_item_t *item,
+    bool lookup_index);
+
+/* Make id of deleted entity available to new entities. Ids that have not been
+ * issued, or that are outside of the entity range, are not recycled. */
+void ecs_recycle_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/* Delete entities from the main stage. OnRemove systems are invoked for each
+ * range of consecutive rows, after which the rows of each table are removed in
+ * a single pass. Entity ids are not recycled. */
+void ecs_delete_entities(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    uint32_t count);
+
+/* Add and remove components in a single commit */
+void ecs_add_remove_intern(
+    ecs_world_t *world,
+    ecs_entity_info_t *info,
+    ecs_type_t to_add,
+    ecs_type_t to_remove,
+    bool do_set);
 
 /* Get prefab from type, even if type was introduced while in progress */
 ecs_entity_t ecs_get_prefab_from_type(
@@ -57,6 +89,11 @@ void* ecs_get_ptr_intern(
     bool staged_only,
     bool search_prefab);
 
+/* Resolve table and row of the component of a reference */
+void ecs_resolve_reference(
+    ecs_world_t *world,
+    ecs_reference_t *ref);
+
 ecs_entity_t ecs_get_entity_for_component(
     ecs_world_t *world,
     ecs_entity_t entity,
@@ -67,6 +104,106 @@ void ecs_clear_w_filter(
     ecs_world_t *world,
     const ecs_filter_t *filter);
 
+/* -- Query API -- */
+
+/* Match new table with existing queries */
+void ecs_query_notify_of_table(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Move table between active and inactive tables of query */
+void ecs_query_activate_table(
+    ecs_query_t *query,
+    ecs_table_t *table,
+    bool active);
+
+/* Remove released table from query */
+void ecs_query_remove_table(
+    ecs_query_t *query,
+    ecs_table_t *table);
+
+/* Free query resources without unregistering it from tables */
+void ecs_query_deinit(
+    ecs_query_t *query);
+
+/* -- Sparse set API -- */
+
+/* Get sparse set for tag, or NULL if the tag is stored in tables */
+ecs_sparse_set_t* ecs_sparse_get_set(
+    ecs_world_t *world,
+    ecs_entity_t component);
+
+/* Get sparse sets for the sparse tags in a type */
+ecs_vector_t* ecs_sparse_get_sets(
+    ecs_world_t *world,
+    ecs_type_t type);
+
+/* Add and remove the sparse tags of the provided types. Outside of the main
+ * stage, the operation is recorded and applied when the stage is merged. On
+ * return, to_add and to_remove only contain components stored in tables. */
+void ecs_sparse_add_remove(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t *to_add,
+    ecs_type_t *to_remove);
+
+/* Test if entity has the components of a type that contains sparse tags */
+bool ecs_sparse_has(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type,
+    bool match_all,
+    bool match_prefabs);
+
+/* Count entities with the components of a type that contains sparse tags */
+uint32_t ecs_sparse_count(
+    ecs_world_t *world,
+    ecs_type_t type);
+
+/* Test if entity is in all of the and_sets, and in none of the not_sets */
+bool ecs_sparse_match(
+    ecs_vector_t *and_sets,
+    ecs_vector_t *not_sets,
+    ecs_entity_t entity);
+
+/* Remove entity from all sparse sets */
+void ecs_sparse_remove_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/* Add the sparse tags of one entity to another entity */
+void ecs_sparse_clone(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t src,
+    ecs_entity_t dst);
+
+/* Apply sparse operations that were recorded in a stage */
+void ecs_sparse_merge(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Copy sparse sets (used by snapshots) */
+ecs_map_t* ecs_sparse_copy_sets(
+    ecs_map_t *sets);
+
+/* Replace contents of world sparse sets with copied sets. Takes ownership of
+ * the copied sets. */
+void ecs_sparse_restore_sets(
+    ecs_world_t *world,
+    ecs_map_t *sets);
+
+/* Free sparse sets */
+void ecs_sparse_free_sets(
+    ecs_map_t *sets);
+
+/* Get memory used by sparse sets */
+void ecs_sparse_memory(
+    ecs_world_t *world,
+    uint32_t *allocd,
+    uint32_t *used);
+
 /* -- World API -- */
 
 /* Get (or create) table from type */
@@ -75,6 +212,19 @@ ecs_table_t* ecs_world_get_table(
     ecs_stage_t *stage,
     ecs_type_t type_id);
 
+/* Get component of type with the fewest tables in the component index */
+ecs_entity_t ecs_world_get_rarest_component(
+    ecs_world_t *world,
+    ecs_type_t type);
+
+/* Get next table from component index that may contain the component. Tables
+ * that have prefabs are always returned. Returns NULL when done. */
+ecs_table_t* ecs_world_next_table(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    uint32_t *table_index,
+    uint32_t *prefab_index);
+
 /* Notify systems that there is a new table, which triggers matching */
 void ecs_notify_systems_of_table(
     ecs_world_t *world,
@@ -113,6 +263,126 @@ void ecs_stage_merge(
     ecs_world_t *world,
     ecs_stage_t *stage);
 
+/* Test if operations on stage are recorded in its command log */
+bool ecs_stage_is_deferred(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Record adding and removing components in command log */
+void ecs_stage_defer_add_remove(
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t to_add,
+    ecs_type_t to_remove);
+
+/* Record setting a component value in command log */
+void ecs_stage_defer_set(
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    size_t size,
+    const void *ptr);
+
+/* Record deleting an entity in command log */
+void ecs_stage_defer_delete(
+    ecs_stage_t *stage,
+    ecs_entity_t entity);
+
+/* Replay operations in command log on main stage */
+void ecs_stage_replay(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* -- Entity index API -- */
+
+/* Create entity index with room for size entities in the dense array */
+ecs_ei_t* ecs_ei_new(
+    uint32_t size);
+
+/* Free entity index */
+void ecs_ei_free(
+    ecs_ei_t *ei);
+
+/* Remove all entities from entity index */
+void ecs_ei_clear(
+    ecs_ei_t *ei);
+
+/* Copy entity index */
+ecs_ei_t* ecs_ei_copy(
+    const ecs_ei_t *ei);
+
+/* Get row of entity. Returns NULL if entity is not in index, or if the
+ * generation of the id does not match the generation in the index. */
+ecs_row_t* ecs_ei_get(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity);
+
+/* Test if entity is in index, and if so, copy its row to row_out */
+bool ecs_ei_has(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity,
+    ecs_row_t *row_out);
+
+/* Set row of entity, add entity to index if it is not yet in the index */
+ecs_row_t* ecs_ei_set(
+    ecs_ei_t *ei,
+    ecs_entity_t entity,
+    const ecs_row_t *row);
+
+/* Remove entity from index */
+void ecs_ei_remove(
+    ecs_ei_t *ei,
+    ecs_entity_t entity);
+
+/* Number of entities in index */
+uint32_t ecs_ei_count(
+    const ecs_ei_t *ei);
+
+/* Preallocate room for count additional entities, starting from id first */
+void ecs_ei_grow(
+    ecs_ei_t *ei,
+    ecs_entity_t first,
+    uint32_t count);
+
+/* Recycle id of an entity that has been removed from the index. Returns false
+ * if the id was already recycled, or if the entity is still in the index. */
+bool ecs_ei_recycle(
+    ecs_ei_t *ei,
+    ecs_entity_t entity);
+
+/* Return id of entity without its generation. Only handles of recycled ids
+ * have a generation, other ids are returned as is. */
+ecs_entity_t ecs_ei_id(
+    const ecs_ei_t *ei,
+    ecs_entity_t entity);
+
+/* Take a recycled id, or return 0 if there are none */
+ecs_entity_t ecs_ei_recycled(
+    ecs_ei_t *ei);
+
+/* Drop recycled ids that are outside of [min, max] (no upper bound if 0) */
+void ecs_ei_filter_recycled(
+    ecs_ei_t *ei,
+    ecs_entity_t min,
+    ecs_entity_t max);
+
+/* Add memory used by entity index to total and used */
+void ecs_ei_memory(
+    const ecs_ei_t *ei,
+    uint32_t *total,
+    uint32_t *used);
+
+/* Iterate entities in index */
+ecs_ei_iter_t ecs_ei_iter(
+    ecs_ei_t *ei);
+
+bool ecs_ei_hasnext(
+    ecs_ei_iter_t *it);
+
+ecs_row_t* ecs_ei_next(
+    ecs_ei_iter_t *it,
+    ecs_entity_t *entity_out);
+
 /* -- Type utility API -- */
 
 ecs_type_t ecs_type_find_intern(
@@ -151,6 +421,14 @@ ecs_type_t ecs_type_add_intern(
     ecs_type_t type,
     ecs_entity_t component);
 
+/* Serialize access to the type index and the row system indices, which worker
+ * threads update when they create types. No-op when the world has no threads. */
+void ecs_lock_types(
+    ecs_world_t *world);
+
+void ecs_unlock_types(
+    ecs_world_t *world);
+
 /* Get index for entity in type */
 int16_t ecs_type_index_of(
     ecs_type_t type,
@@ -183,6 +461,26 @@ void ecs_table_init(
     ecs_stage_t *stage,
     ecs_table_t *table);
 
+/* Get edge to table with to_add added, or to_remove removed. Only one of
+ * to_add and to_remove may be set. Edges are only valid for tables in the main
+ * stage, and must not be used while in progress. */
+ecs_table_edge_t* ecs_table_get_edge(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    ecs_type_t to_add,
+    ecs_type_t to_remove);
+
+/* Build lookup from components to columns of table */
+void ecs_table_init_lookup(
+    ecs_table_t *table);
+
+/* Get index of component in table type (not counting the entity column), or
+ * -1 if table does not have component. Equivalent to ecs_type_index_of. */
+int16_t ecs_table_column_index(
+    const ecs_table_t *table,
+    ecs_entity_t component);
+
 /* Evaluate table for special columns */
 void ecs_table_eval_columns(
     ecs_world_t *world,
@@ -240,6 +538,16 @@ void ecs_table_delete(
     ecs_table_column_t *columns,
     int32_t index);
 
+/* Delete multiple rows from table (or stage). Rows start from 1, like with
+ * ecs_table_delete, and must be sorted in ascending order. */
+void ecs_table_delete_rows(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    ecs_table_column_t *columns,
+    const uint32_t *rows,
+    uint32_t row_count);
+
 /* Get row from table (or stage) */
 void* ecs_table_get(
     ecs_table_t *table,
@@ -270,6 +578,20 @@ void ecs_table_clear(
     ecs_world_t *world,
     ecs_table_t *table);    
 
+/* Shrink column data to fit. Returns number of bytes released */
+uint32_t ecs_table_reclaim(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Release resources of empty table. Returns number of bytes released */
+uint32_t ecs_table_release(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Remove edges to released tables */
+void ecs_table_remove_released_edges(
+    ecs_table_t *table);
+
 /* Clear data in columns */
 void ecs_table_replace_columns(
     ecs_world_t *world,
@@ -362,6 +684,12 @@ void ecs_system_activate_table(
     ecs_table_t *table,
     bool active);
 
+/* Remove released table from system */
+void ecs_system_remove_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_table_t *table);
+
 /* Internal function to run a system */
 ecs_entity_t ecs_run_intern(
     ecs_world_t *world,
@@ -373,6 +701,11 @@ ecs_entity_t ecs_run_intern(
     const ecs_filter_t *filter,
     void *param);
 
+/* Assign a new change tick to a system before it is invoked */
+void ecs_col_system_next_tick(
+    ecs_world_t *world,
+    EcsColSystem *system_data);
+
 /* Run a task (periodic system that is not matched against any tables) */
 void ecs_run_task(
     ecs_world_t *world,
@@ -406,7 +739,7 @@ void ecs_rematch_system(
     ecs_world_t *world,
     ecs_entity_t system);
 
-/* Re-resolve references of system after table realloc */
+/* Re-resolve references of system after entities moved in their tables */
 void ecs_revalidate_system_refs(
     ecs_world_t *world,
     ecs_entity_t system);
@@ -421,6 +754,10 @@ void ecs_measure_system_time(
 
 /* -- Worker API -- */
 
+/* Compute batches of systems that can run at the same time */
+void ecs_schedule_batches(
+    ecs_world_t *world);
+
 /* Compute schedule based on current number of entities matching system */
 void ecs_schedule_jobs(
     ecs_world_t *world,
@@ -435,6 +772,17 @@ void ecs_prepare_jobs(
 void ecs_run_jobs(
     ecs_world_t *world);
 
+/* Test if systems in phase access components of staged entities */
+bool ecs_phase_uses_staged(
+    ecs_world_t *world,
+    ecs_vector_t *systems);
+
+/* Copy staged data to main stage on worker threads */
+void ecs_run_merge_jobs(
+    ecs_world_t *world,
+    ecs_merge_item_t *items,
+    uint32_t count);
+
 /* -- Os time api -- */
 
 void ecs_os_time_setup(void);
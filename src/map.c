@@ -1,95 +1,277 @@
 
 #include "flecs_private.h"
 
-#define FLECS_LOAD_FACTOR (3.0f / 4.0f)
+/* The map is an open addressing hashtable with a power-of-two capacity. Keys
+ * are mixed into a 64 bit hash. The low 7 bits of the hash are stored in a
+ * control byte per slot, and the remaining bits select the group of slots at
+ * which probing starts. A group stores 8 control bytes followed by the 8 slots,
+ * so that probing a group touches a single cache line. The control bytes of a
+ * group are loaded in a single 64 bit word and matched all at once, so a key is
+ * only compared when its control byte matches, which filters out almost all
+ * misses.
+ *
+ * The key/value pairs live in a dense array, in insertion order. Slots store
+ * an index into this array. This keeps iteration a linear scan, and means that
+ * a rehash only has to move the (small) slot indices around. */
+
+#define FLECS_LOAD_FACTOR_NUM (7)
+#define FLECS_LOAD_FACTOR_DEN (8)
+#define FLECS_MAP_GROUP_WIDTH (8)
+
+#define CTRL_EMPTY ((uint8_t)0x80)
+#define CTRL_DELETED ((uint8_t)0xFE)
+
+#define GROUP_LSBS (0x0101010101010101ull)
+#define GROUP_MSBS (0x8080808080808080ull)
+
+typedef struct ecs_map_group_t {
+    uint8_t ctrl[FLECS_MAP_GROUP_WIDTH];   /* Empty, deleted or 7 bits of hash */
+    uint32_t index[FLECS_MAP_GROUP_WIDTH]; /* Node index for each slot */
+} ecs_map_group_t;
 
 typedef struct ecs_map_node_t {
     uint64_t key;           /* Key */
-    uint32_t next;          /* Next node index */
-    uint32_t prev;          /* Previous node index (enables O(1) removal) */
 } ecs_map_node_t;
 
 struct ecs_map_t {
-    uint32_t *buckets;      /* Array of buckets */
-    ecs_vector_t *nodes;    /* Array with memory for map nodes */
-    ecs_vector_params_t node_params; /* Parameters for node vector */
-    size_t bucket_count;    /* number of buckets */
-    uint32_t count;         /* number of elements */
-    uint32_t min;           /* minimum number of elements */
+    ecs_map_group_t *groups; /* Array of slot groups */
+    void *nodes;            /* Dense array with keys and values */
+    uint32_t node_size;     /* Size of node (key + value + padding) */
+    uint32_t data_size;     /* Size of value */
+    uint32_t node_capacity; /* Number of nodes that fit in nodes array */
+    uint32_t bucket_count;  /* Number of slots (0 or power of two) */
+    uint32_t count;         /* Number of elements */
+    uint32_t deleted;       /* Number of deleted slots */
+    uint32_t min;           /* Minimum number of slots */
 };
 
 static
 size_t data_size(
-    ecs_map_t *map)
+    const ecs_map_t *map)
 {
-    return map->node_params.element_size - sizeof(ecs_map_node_t);
+    return map->data_size;
 }
 
-/** Get map node from index */
 static
-ecs_map_node_t *node_from_index(
-    ecs_map_t *map,
-    ecs_vector_t *nodes,
+ecs_map_node_t *get_node(
+    const ecs_map_t *map,
     uint32_t index)
 {
-    return ecs_vector_get(nodes, &map->node_params, index - 1);
+    return ECS_OFFSET(map->nodes, index * map->node_size);
 }
 
-/** Get a bucket for a given key */
 static
-uint32_t* get_bucket(
-    ecs_map_t *map,
+void *get_node_data(
+    ecs_map_node_t *node)
+{
+    return ECS_OFFSET(node, sizeof(ecs_map_node_t));
+}
+
+/** Mix bits of key, so that sequential ids don't end up in the same group */
+static
+uint64_t hash_key(
     uint64_t key)
 {
-    uint64_t index = key % map->bucket_count;
-    return &map->buckets[index];
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
 }
 
-/** Callback that updates administration when node is moved in nodes array */
+/** Number of elements that fit in slot_count slots before rehashing */
 static
-void move_node(
-    ecs_vector_t *array,
-    const ecs_vector_params_t *params,
-    void *to,
-    void *from,
-    void *ctx)
-{
-    ecs_map_t *map = ctx;
-    ecs_map_node_t *node_p = to;
-    uint32_t node = ecs_vector_get_index(array, &map->node_params, to) + 1;
-    uint32_t prev = node_p->prev;
-    uint32_t next = node_p->next;
-    (void)params;
-    (void)from;
-
-    if (prev) {
-        ecs_map_node_t *prev_p = node_from_index(map, array, prev);
-        prev_p->next = node;
-    } else {
-        uint32_t *bucket = get_bucket(map, node_p->key);
-        *bucket = node;
+uint32_t max_load(
+    uint32_t slot_count)
+{
+    return (uint64_t)slot_count * FLECS_LOAD_FACTOR_NUM / FLECS_LOAD_FACTOR_DEN;
+}
+
+/** Smallest valid slot count that can hold count elements */
+static
+uint32_t slot_count_for(
+    uint32_t count)
+{
+    if (!count) {
+        return 0;
+    }
+
+    uint32_t result = FLECS_MAP_GROUP_WIDTH;
+    while (max_load(result) < count) {
+        result *= 2;
+    }
+
+    return result;
+}
+
+/** Load control bytes of a group (little endian, byte i is bits 8i..8i+7) */
+static
+uint64_t load_group(
+    const ecs_map_group_t *group)
+{
+    const uint8_t *ctrl = group->ctrl;
+    return (uint64_t)ctrl[0] |
+        ((uint64_t)ctrl[1] << 8) |
+        ((uint64_t)ctrl[2] << 16) |
+        ((uint64_t)ctrl[3] << 24) |
+        ((uint64_t)ctrl[4] << 32) |
+        ((uint64_t)ctrl[5] << 40) |
+        ((uint64_t)ctrl[6] << 48) |
+        ((uint64_t)ctrl[7] << 56);
+}
+
+/** Bitmask with the high bit set for each byte that may equal h2. False
+ * positives are possible, so the caller must still compare the key. */
+static
+uint64_t group_match(
+    uint64_t ctrl,
+    uint8_t h2)
+{
+    uint64_t x = ctrl ^ (GROUP_LSBS * h2);
+    return (x - GROUP_LSBS) & ~x & GROUP_MSBS;
+}
+
+/** Bitmask with the high bit set for each empty byte */
+static
+uint64_t group_match_empty(
+    uint64_t ctrl)
+{
+    return ctrl & (~ctrl << 6) & GROUP_MSBS;
+}
+
+/** Bitmask with the high bit set for each empty or deleted byte */
+static
+uint64_t group_match_free(
+    uint64_t ctrl)
+{
+    return ctrl & GROUP_MSBS;
+}
+
+/** Index of the lowest byte set in a match bitmask */
+static
+uint32_t mask_first(
+    uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask) / 8;
+#else
+    uint32_t result = 0;
+    while (!(mask & 0x80)) {
+        mask >>= 8;
+        result ++;
+    }
+    return result;
+#endif
+}
+
+/** Find group and slot for a key. Returns NULL if key is not in the map. */
+static
+ecs_map_group_t* find_slot(
+    const ecs_map_t *map,
+    uint64_t key,
+    uint32_t *slot_out)
+{
+    uint64_t hash = hash_key(key);
+    uint8_t h2 = hash & 0x7F;
+    uint32_t mask = map->bucket_count / FLECS_MAP_GROUP_WIDTH - 1;
+    uint32_t pos = (hash >> 7) & mask;
+    uint32_t step = 0;
+
+    do {
+        ecs_map_group_t *group = &map->groups[pos];
+        uint64_t ctrl = load_group(group);
+        uint64_t match = group_match(ctrl, h2);
+
+        while (match) {
+            uint32_t slot = mask_first(match);
+            if (get_node(map, group->index[slot])->key == key) {
+                *slot_out = slot;
+                return group;
+            }
+            match &= match - 1;
+        }
+
+        /* A group with an empty slot ends every probe sequence through it */
+        if (group_match_empty(ctrl)) {
+            return NULL;
+        }
+
+        step ++;
+        pos = (pos + step) & mask;
+    } while (step <= mask);
+
+    return NULL;
+}
+
+/** Store node index in the first free slot of the probe sequence of its key */
+static
+void insert_slot(
+    ecs_map_t *map,
+    uint64_t key,
+    uint32_t index)
+{
+    uint64_t hash = hash_key(key);
+    uint32_t mask = map->bucket_count / FLECS_MAP_GROUP_WIDTH - 1;
+    uint32_t pos = (hash >> 7) & mask;
+    uint32_t step = 0;
+    uint64_t avail;
+
+    while (!(avail = group_match_free(load_group(&map->groups[pos])))) {
+        step ++;
+        pos = (pos + step) & mask;
+        ecs_assert(step <= mask, ECS_INTERNAL_ERROR, NULL);
     }
 
-    if (next) {
-        ecs_map_node_t *next_p = node_from_index(map, array, next);
-        next_p->prev = node;
+    ecs_map_group_t *group = &map->groups[pos];
+    uint32_t slot = mask_first(avail);
+
+    if (group->ctrl[slot] == CTRL_DELETED) {
+        map->deleted --;
     }
+
+    group->ctrl[slot] = hash & 0x7F;
+    group->index[slot] = index;
 }
 
-/** Allocate the buckets buffer */
+/** Allocate the slot groups */
 static
 void alloc_buffer(
     ecs_map_t *map,
     uint32_t bucket_count)
 {
     if (bucket_count) {
-        map->buckets = ecs_os_calloc(bucket_count * sizeof(uint32_t), 1);
-        ecs_assert(map->buckets != NULL, ECS_OUT_OF_MEMORY, 0);
+        uint32_t i, group_count = bucket_count / FLECS_MAP_GROUP_WIDTH;
+        map->groups = ecs_os_malloc(group_count * sizeof(ecs_map_group_t));
+        ecs_assert(map->groups != NULL, ECS_OUT_OF_MEMORY, 0);
+        for (i = 0; i < group_count; i ++) {
+            memset(map->groups[i].ctrl, CTRL_EMPTY, FLECS_MAP_GROUP_WIDTH);
+        }
     } else {
-        map->buckets = NULL;
+        map->groups = NULL;
     }
 
     map->bucket_count = bucket_count;
+    map->deleted = 0;
+}
+
+/** Set capacity of the node array */
+static
+void alloc_nodes(
+    ecs_map_t *map,
+    uint32_t capacity)
+{
+    ecs_assert(capacity >= map->count, ECS_INTERNAL_ERROR, NULL);
+
+    if (capacity) {
+        map->nodes = ecs_os_realloc(map->nodes, capacity * map->node_size);
+        ecs_assert(map->nodes != NULL, ECS_OUT_OF_MEMORY, 0);
+    } else {
+        ecs_os_free(map->nodes);
+        map->nodes = NULL;
+    }
+
+    map->node_capacity = capacity;
 }
 
 /** Allocate a map object */
@@ -104,37 +286,34 @@ ecs_map_t *alloc_map(
     alloc_buffer(result, bucket_count);
     result->count = 0;
     result->min = bucket_count;
-    result->node_params = (ecs_vector_params_t){
-        .element_size = data_size + sizeof(ecs_map_node_t),
-        .move_action = move_node
-    };
+    result->data_size = data_size;
+
+    /* Round up so that the key of each node is 8 byte aligned */
+    result->node_size = (data_size + sizeof(ecs_map_node_t) + 
+        sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    result->nodes = NULL;
+    alloc_nodes(result, ECS_MAP_INITIAL_NODE_COUNT);
 
-    result->nodes = ecs_vector_new(&result->node_params, ECS_MAP_INITIAL_NODE_COUNT);
-    
     return result;
 }
 
-/** Find next non-empty bucket */
+/** Resize number of slots in a map. Nodes stay where they are. */
 static
-uint32_t next_bucket(
+void resize_map(
     ecs_map_t *map,
-    uint32_t start_index)
+    uint32_t bucket_count)
 {
-    size_t i;
-    for (i = start_index; i < map->bucket_count; i ++) {
-        if (map->buckets[i]) {
-            break;
-        }
-    }
+    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(max_load(bucket_count) >= map->count,
+        ECS_INTERNAL_ERROR, NULL);
 
-    return i;
-}
+    ecs_os_free(map->groups);
+    alloc_buffer(map, bucket_count);
 
-static
-void *get_node_data(
-    ecs_map_node_t *node)
-{
-    return ECS_OFFSET(node, sizeof(ecs_map_node_t));
+    uint32_t i, count = map->count;
+    for (i = 0; i < count; i ++) {
+        insert_slot(map, get_node(map, i)->key, i);
+    }
 }
 
 static
@@ -144,7 +323,7 @@ void set_node_data(
     const void *data)
 {
     void *node_data = get_node_data(node);
-    if (data != node_data) { 
+    if (data != node_data) {
         if (data) {
             memcpy(node_data, data, data_size(map));
         } else {
@@ -153,111 +332,39 @@ void set_node_data(
     }
 }
 
-/** Add new node to bucket */
+/** Add new node for key that is not yet in the map */
 static
-void* add_node(
+ecs_map_node_t* add_node(
     ecs_map_t *map,
-    uint32_t *bucket,
     uint64_t key,
-    const void *data,
-    ecs_map_node_t *elem_p)
+    const void *data)
 {
-    uint32_t elem;
+    uint32_t index = map->count;
 
-    if (!elem_p) {
-        elem_p = ecs_vector_add(&map->nodes, &map->node_params);
-        elem = ecs_vector_count(map->nodes);
-    } else {
-        elem = ecs_vector_get_index(
-            map->nodes,
-            &map->node_params,
-            elem_p) + 1;
+    if ((index + map->deleted + 1) > max_load(map->bucket_count)) {
+        /* If the map is mostly filled with deleted slots, rehashing at the
+         * same size is enough to make room */
+        uint32_t bucket_count = slot_count_for(index + 1);
+        if (bucket_count < map->bucket_count) {
+            bucket_count = map->bucket_count;
+        }
+        resize_map(map, bucket_count);
     }
 
-    elem_p->key = key;
-    elem_p->next = 0;
-    elem_p->prev = 0;
-    set_node_data(map, elem_p, data);
-
-    uint32_t first = *bucket;
-    if (first) {
-        ecs_map_node_t *first_p = node_from_index(map, map->nodes, first);
-        first_p->prev = elem;
-        elem_p->next = first;
+    if (index == map->node_capacity) {
+        alloc_nodes(map, index ? index * 2 : ECS_MAP_INITIAL_NODE_COUNT);
     }
 
-    *bucket = elem;
+    ecs_map_node_t *node = get_node(map, index);
+    node->key = key;
+    set_node_data(map, node, data);
 
+    insert_slot(map, key, index);
     map->count ++;
 
-    return elem_p;
+    return node;
 }
 
-/** Get map node for a given key */
-static
-ecs_map_node_t *get_node(
-    ecs_map_t *map,
-    uint32_t *bucket,
-    uint64_t key)
-{
-    uint32_t node = *bucket;
-
-    while (node) {
-        ecs_map_node_t *node_p = node_from_index(map, map->nodes, node);
-
-        if (node_p->prev) {
-            assert(node_from_index(map, map->nodes, node_p->prev)->next == node);
-        }
-        if (node_p->next) {
-            assert(node_from_index(map, map->nodes, node_p->next)->prev == node);
-        }
-
-        if (node_p->key == key) {
-            return node_p;
-        }
-        node = node_p->next;
-    }
-
-    return NULL;
-}
-
-/** Resize number of buckets in a map */
-static
-void resize_map(
-    ecs_map_t *map,
-    uint32_t bucket_count)
-{
-    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
-
-    uint32_t *old_buckets = map->buckets;
-    uint32_t old_bucket_count = map->bucket_count;
-
-    alloc_buffer(map, bucket_count);
-    map->count = 0;
-
-    uint32_t bucket_index;
-    for (bucket_index = 0; bucket_index < old_bucket_count; bucket_index ++) {
-        uint32_t bucket = old_buckets[bucket_index];
-        if (bucket) {
-            uint32_t node = bucket;
-            uint32_t next;
-            uint64_t key;
-
-            ecs_map_node_t *node_p;
-            do {
-                node_p = node_from_index(map, map->nodes, node);
-                next = node_p->next;
-                key = node_p->key;
-                uint32_t *new_bucket = get_bucket(map, key);
-                add_node(map, new_bucket, key, get_node_data(node_p), node_p);
-            } while ((node = next));
-        }
-    }
-
-    ecs_os_free(old_buckets);
-}
-
-
 /* -- Public functions -- */
 
 ecs_map_t* ecs_map_new(
@@ -267,7 +374,7 @@ ecs_map_t* ecs_map_new(
     if (!data_size) {
         data_size = sizeof(uint64_t);
     }
-    return alloc_map((float)size / FLECS_LOAD_FACTOR, data_size);
+    return alloc_map(slot_count_for(size), data_size);
 }
 
 void ecs_map_clear(
@@ -275,21 +382,26 @@ void ecs_map_clear(
 {
     ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    uint32_t target_size = (float)map->count / FLECS_LOAD_FACTOR;
+    uint32_t target_size = slot_count_for(map->count);
 
     if (target_size < map->min) {
         target_size = map->min;
     }
 
-    if (target_size < (float)map->bucket_count * 0.75) {
-        ecs_os_free(map->buckets);
+    if (target_size < map->bucket_count) {
+        ecs_os_free(map->groups);
         alloc_buffer(map, target_size);
     } else {
-        memset(map->buckets, 0, sizeof(int32_t) * map->bucket_count);
+        uint32_t i, group_count = map->bucket_count / FLECS_MAP_GROUP_WIDTH;
+        for (i = 0; i < group_count; i ++) {
+            memset(map->groups[i].ctrl, CTRL_EMPTY, FLECS_MAP_GROUP_WIDTH);
+        }
+        map->deleted = 0;
     }
 
-    ecs_vector_reclaim(&map->nodes, &map->node_params);
-    ecs_vector_clear(map->nodes);
+    if (map->count < map->node_capacity) {
+        alloc_nodes(map, map->count);
+    }
 
     map->count = 0;
 }
@@ -297,8 +409,8 @@ void ecs_map_clear(
 void ecs_map_free(
     ecs_map_t *map)
 {
-    ecs_vector_free(map->nodes);
-    ecs_os_free(map->buckets);
+    ecs_os_free(map->nodes);
+    ecs_os_free(map->groups);
     ecs_os_free(map);
 }
 
@@ -313,30 +425,21 @@ void* _ecs_map_set(
     (void)size;
     ecs_assert(ecs_map_data_size(map) == size, ECS_INVALID_PARAMETER, NULL);
 
-    uint32_t bucket_count = map->bucket_count;
-    if (!bucket_count) {
-        alloc_buffer(map, 2);
-        bucket_count = map->bucket_count;
-    }
-
-    if ((((float)map->count) / (float)bucket_count) > FLECS_LOAD_FACTOR) {
-        resize_map(map, bucket_count * 2);
-    }
-
-    uint32_t *bucket = get_bucket(map, key);
     ecs_map_node_t *node = NULL;
 
-    if (!*bucket) {
-        node = add_node(map, bucket, key, data, NULL);
-    } else {
-        node = get_node(map, bucket, key);
-        if (node) {
+    if (map->count) {
+        uint32_t slot;
+        ecs_map_group_t *group = find_slot(map, key, &slot);
+        if (group) {
+            node = get_node(map, group->index[slot]);
             set_node_data(map, node, data);
-        } else {
-            node = add_node(map, bucket, key, data, NULL);
         }
     }
 
+    if (!node) {
+        node = add_node(map, key, data);
+    }
+
     ecs_assert(node != NULL, ECS_INTERNAL_ERROR, NULL);
 
     return get_node_data(node);
@@ -350,37 +453,38 @@ int ecs_map_remove(
         return -1;
     }
 
-    uint32_t *bucket = get_bucket(map, key);
-
-    if (*bucket) {
-        ecs_map_node_t *node = get_node(map, bucket, key);
-        if (node) {
-            ecs_map_node_t *prev_node = node_from_index(map, map->nodes, node->prev);
-            ecs_map_node_t *next_node = node_from_index(map, map->nodes, node->next);
-
-            if (prev_node) {
-                assert(node_from_index(map, map->nodes, prev_node->next) == node);
-                prev_node->next = node->next;
-            } else {
-                *bucket = node->next;
-            }
-
-            if (next_node) {
-                assert(node_from_index(map, map->nodes, next_node->prev) == node);
-                next_node->prev = node->prev;
-            }
-
-            ecs_vector_params_t params = map->node_params;
-            params.move_ctx = map;
+    uint32_t slot;
+    ecs_map_group_t *group = find_slot(map, key, &slot);
+    if (!group) {
+        return -1;
+    }
 
-            ecs_vector_remove(map->nodes, &params, node);
-            map->count --;
+    /* If the group still has an empty slot, no probe sequence continues past
+     * it, and the slot can be marked empty instead of deleted */
+    if (group_match_empty(load_group(group))) {
+        group->ctrl[slot] = CTRL_EMPTY;
+    } else {
+        group->ctrl[slot] = CTRL_DELETED;
+        map->deleted ++;
+    }
 
-            return 0;
-        }
+    /* Move last node into the removed node, and point its slot to new index */
+    uint32_t index = group->index[slot];
+    uint32_t last = map->count - 1;
+    if (index != last) {
+        ecs_map_node_t *last_node = get_node(map, last);
+        uint32_t last_slot;
+        ecs_map_group_t *last_group = find_slot(
+            map, last_node->key, &last_slot);
+        ecs_assert(last_group != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        memcpy(get_node(map, index), last_node, map->node_size);
+        last_group->index[last_slot] = index;
     }
 
-    return -1;
+    map->count --;
+
+    return 0;
 }
 
 void* ecs_map_get_ptr(
@@ -391,12 +495,10 @@ void* ecs_map_get_ptr(
         return 0;
     }
 
-    uint32_t *bucket = get_bucket(map, key);
-    if (*bucket) {
-        ecs_map_node_t *elem = get_node(map, bucket, key);
-        if (elem) {
-            return get_node_data(elem);
-        }
+    uint32_t slot;
+    ecs_map_group_t *group = find_slot(map, key, &slot);
+    if (group) {
+        return get_node_data(get_node(map, group->index[slot]));
     }
 
     return 0;
@@ -413,22 +515,21 @@ bool _ecs_map_has(
     if (!map) {
         return false;
     }
-    
+
     if (!map->count) {
         return false;
     }
 
-    ecs_assert(!value_out || (ecs_map_data_size(map) == size), ECS_INVALID_PARAMETER, NULL); 
+    ecs_assert(!value_out || (ecs_map_data_size(map) == size), ECS_INVALID_PARAMETER, NULL);
 
-    uint32_t *bucket = get_bucket(map, key_hash);
-    if (*bucket) {
-        ecs_map_node_t *elem = get_node(map, bucket, key_hash);
-        if (elem) {
-            if (value_out) {
-                memcpy(value_out, get_node_data(elem), data_size(map));
-            }
-            return true;
+    uint32_t slot;
+    ecs_map_group_t *group = find_slot(map, key_hash, &slot);
+    if (group) {
+        if (value_out) {
+            ecs_map_node_t *elem = get_node(map, group->index[slot]);
+            memcpy(value_out, get_node_data(elem), data_size(map));
         }
+        return true;
     }
 
     return false;
@@ -450,16 +551,23 @@ uint32_t ecs_map_set_size(
     ecs_map_t *map,
     uint32_t size)
 {
-    uint32_t result = ecs_vector_set_size(&map->nodes, &map->node_params, size);
-    resize_map(map, size / FLECS_LOAD_FACTOR);
-    return result;
+    if (size > map->node_capacity) {
+        alloc_nodes(map, size);
+    }
+
+    uint32_t bucket_count = slot_count_for(size);
+    if (bucket_count > map->bucket_count) {
+        resize_map(map, bucket_count);
+    }
+
+    return map->node_capacity;
 }
 
 uint32_t ecs_map_grow(
     ecs_map_t *map,
     uint32_t size)
 {
-    if (size > ecs_vector_size(map->nodes)) {
+    if (size > map->node_capacity) {
         return ecs_map_set_size(map, size);
     }
 
@@ -476,13 +584,14 @@ void ecs_map_memory(
     }
 
     if (total) {
-        *total += map->bucket_count * sizeof(uint32_t) + sizeof(ecs_map_t);
-        ecs_vector_memory(map->nodes, &map->node_params, total, NULL);
+        *total += map->bucket_count / FLECS_MAP_GROUP_WIDTH *
+            sizeof(ecs_map_group_t) + sizeof(ecs_map_t);
+        *total += map->node_capacity * map->node_size;
     }
 
     if (used) {
-        *used += map->count * sizeof(uint32_t);
-        ecs_vector_memory(map->nodes, &map->node_params, NULL, used);
+        *used += map->count * (sizeof(uint8_t) + sizeof(uint32_t));
+        *used += map->count * map->node_size;
     }
 }
 
@@ -490,10 +599,16 @@ ecs_map_t* ecs_map_copy(
     const ecs_map_t *map)
 {
     ecs_map_t *dst = ecs_os_memdup(map, sizeof(ecs_map_t));
-    dst->buckets = ecs_os_memdup(
-        map->buckets, map->bucket_count * sizeof(uint32_t));
-    
-    dst->nodes = ecs_vector_copy(map->nodes, &map->node_params);
+
+    if (map->groups) {
+        dst->groups = ecs_os_memdup(map->groups, map->bucket_count /
+            FLECS_MAP_GROUP_WIDTH * sizeof(ecs_map_group_t));
+    }
+
+    if (map->nodes) {
+        dst->nodes = ecs_os_memdup(
+            map->nodes, map->node_capacity * map->node_size);
+    }
 
     return dst;
 }
@@ -503,8 +618,7 @@ ecs_map_iter_t ecs_map_iter(
 {
     ecs_map_iter_t result = {
         .map = map,
-        .bucket_index = -1,
-        .node = 0
+        .index = -1
     };
 
     return result;
@@ -513,35 +627,9 @@ ecs_map_iter_t ecs_map_iter(
 bool ecs_map_hasnext(
     ecs_map_iter_t *iter_data)
 {
-    ecs_map_t *map = iter_data->map;
-    if (!map->count) {
-        return false;
-    }
-
-    if (!map->buckets) {
-        return false;
-    }
-
-    uint32_t bucket_index = iter_data->bucket_index;
-    uint32_t node = iter_data->node;
-
-    if (node) {
-        ecs_map_node_t *node_p = node_from_index(map, map->nodes, node);
-        node = node_p->next;
-    }
-
-    if (!node) {
-        bucket_index = next_bucket(map, bucket_index + 1);
-        if (bucket_index < map->bucket_count) {
-            node = map->buckets[bucket_index];
-        } else {
-            node = 0;
-        }
-    }
-
-    if (node) {
-        iter_data->node = node;
-        iter_data->bucket_index = bucket_index;
+    uint32_t index = iter_data->index + 1;
+    if (index < iter_data->map->count) {
+        iter_data->index = index;
         return true;
     } else {
         return false;
@@ -557,9 +645,9 @@ void* ecs_map_next_w_key_w_size(
 
     ecs_map_t *map = iter_data->map;
     ecs_assert(!size || data_size(map) == size, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(iter_data->index < map->count, ECS_INTERNAL_ERROR, NULL);
 
-    ecs_map_node_t *node_p = node_from_index(map, map->nodes, iter_data->node);
-    assert(node_p != NULL);
+    ecs_map_node_t *node_p = get_node(map, iter_data->index);
     if (key_out) *key_out = node_p->key;
     return get_node_data(node_p);
 }
@@ -1,5 +1,22 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity */
+#endif
+
 #include "flecs_private.h"
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ecs_os_spin_pause() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#define ecs_os_spin_pause() __builtin_ia32_pause()
+#else
+#define ecs_os_spin_pause()
+#endif
+
 static bool ecs_os_api_initialized = false;
 static bool ecs_os_api_debug_enabled = false;
 
@@ -269,6 +286,159 @@ void ecs_os_api_free(void *ptr) {
     free(ptr);
 }
 
+static
+int ecs_os_api_ainc(int *value) {
+#ifdef _MSC_VER
+    return _InterlockedIncrement((volatile long*)value);
+#else
+    return __sync_add_and_fetch(value, 1);
+#endif
+}
+
+static
+int ecs_os_api_adec(int *value) {
+#ifdef _MSC_VER
+    return _InterlockedDecrement((volatile long*)value);
+#else
+    return __sync_sub_and_fetch(value, 1);
+#endif
+}
+
+/* Sense-reversing barrier. Threads that arrive at the barrier spin for a short
+ * while before they park on a condition variable, which saves the cost of a 
+ * wakeup when the last thread arrives shortly after. Each time all threads
+ * have arrived the sense flips, which allows reusing the barrier. */
+typedef struct ecs_os_barrier_impl_t {
+    int count;               /* Number of threads that synchronize */
+    int remaining;           /* Number of threads that have yet to arrive */
+    int sense;               /* Flips when all threads have arrived */
+    uint64_t spin_time;      /* Time to spin before parking (nanoseconds) */
+    ecs_os_mutex_t mutex;
+    ecs_os_cond_t cond;
+} ecs_os_barrier_impl_t;
+
+/* The sense flag is read outside of the mutex while spinning, so stores must
+ * publish the work done before the barrier, and loads must observe it. */
+static
+int barrier_load_sense(
+    int *sense)
+{
+#ifdef _MSC_VER
+    /* MSVC gives volatile accesses acquire/release semantics */
+    return *(volatile int*)sense;
+#else
+    return __atomic_load_n(sense, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static
+void barrier_store_sense(
+    int *sense,
+    int value)
+{
+#ifdef _MSC_VER
+    *(volatile int*)sense = value;
+#else
+    __atomic_store_n(sense, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static
+ecs_os_barrier_t ecs_os_api_barrier_new(
+    int count,
+    float spin_time)
+{
+    ecs_assert(ecs_os_api.mutex_new != NULL, ECS_MISSING_OS_API, "mutex_new");
+    ecs_assert(ecs_os_api.cond_new != NULL, ECS_MISSING_OS_API, "cond_new");
+
+    ecs_os_barrier_impl_t *b = ecs_os_api.malloc(sizeof(ecs_os_barrier_impl_t));
+    ecs_assert(b != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    b->count = count;
+    b->remaining = count;
+    b->sense = 0;
+    b->spin_time = spin_time * 1000000000.0;
+    b->mutex = ecs_os_mutex_new();
+    b->cond = ecs_os_cond_new();
+
+    return (ecs_os_barrier_t)(uintptr_t)b;
+}
+
+static
+void ecs_os_api_barrier_free(
+    ecs_os_barrier_t barrier)
+{
+    ecs_os_barrier_impl_t *b = (ecs_os_barrier_impl_t*)barrier;
+    ecs_os_mutex_free(b->mutex);
+    ecs_os_cond_free(b->cond);
+    ecs_os_api.free(b);
+}
+
+static
+void ecs_os_api_barrier_wait(
+    ecs_os_barrier_t barrier)
+{
+    ecs_os_barrier_impl_t *b = (ecs_os_barrier_impl_t*)barrier;
+    int sense = !barrier_load_sense(&b->sense);
+
+    /* Last thread to arrive resets the barrier and releases the others */
+    if (!ecs_os_adec(&b->remaining)) {
+        b->remaining = b->count;
+
+        ecs_os_mutex_lock(b->mutex);
+        barrier_store_sense(&b->sense, sense);
+        ecs_os_cond_broadcast(b->cond);
+        ecs_os_mutex_unlock(b->mutex);
+        return;
+    }
+
+    if (b->spin_time) {
+        uint64_t start = ecs_os_time_now();
+        uint32_t i = 0;
+
+        while (barrier_load_sense(&b->sense) != sense) {
+            ecs_os_spin_pause();
+
+            /* Don't query the time on every iteration */
+            if (!(++ i % 64) && (ecs_os_time_now() - start) > b->spin_time) {
+                break;
+            }
+        }
+
+        /* Released while spinning, no need to touch the mutex */
+        if (barrier_load_sense(&b->sense) == sense) {
+            return;
+        }
+    }
+
+    ecs_os_mutex_lock(b->mutex);
+    while (barrier_load_sense(&b->sense) != sense) {
+        ecs_os_cond_wait(b->cond, b->mutex);
+    }
+    ecs_os_mutex_unlock(b->mutex);
+}
+
+#ifdef __linux__
+static
+bool ecs_os_api_thread_set_affinity(
+    const uint32_t *cpus,
+    uint32_t count)
+{
+    cpu_set_t set;
+    uint32_t i;
+
+    CPU_ZERO(&set);
+    for (i = 0; i < count; i ++) {
+        if (cpus[i] < CPU_SETSIZE) {
+            CPU_SET(cpus[i], &set);
+        }
+    }
+
+    /* A pid of 0 applies the mask to the calling thread */
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+}
+#endif
+
 static
 char* ecs_os_api_strdup(const char *str) {
     int len = strlen(str);
@@ -293,6 +463,17 @@ void ecs_os_set_api_defaults(void)
     ecs_os_api.calloc = ecs_os_api_calloc;
     ecs_os_api.strdup = ecs_os_api_strdup;
 
+    ecs_os_api.ainc = ecs_os_api_ainc;
+    ecs_os_api.adec = ecs_os_api_adec;
+
+    ecs_os_api.barrier_new = ecs_os_api_barrier_new;
+    ecs_os_api.barrier_free = ecs_os_api_barrier_free;
+    ecs_os_api.barrier_wait = ecs_os_api_barrier_wait;
+
+#ifdef __linux__
+    ecs_os_api.thread_set_affinity = ecs_os_api_thread_set_affinity;
+#endif
+
 #ifdef __BAKE__
     ecs_os_api.thread_new = bake_thread_new;
     ecs_os_api.thread_join = bake_thread_join;
@@ -0,0 +1,232 @@
+#include "flecs_private.h"
+
+/** Find index of table in a vector of tables */
+static
+int32_t find_table(
+    ecs_vector_t *tables,
+    ecs_table_t *table)
+{
+    ecs_table_t **buffer = ecs_vector_first(tables);
+    uint32_t i, count = ecs_vector_count(tables);
+
+    for (i = 0; i < count; i ++) {
+        if (buffer[i] == table) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** Add table to query, and register query with the table so that the query is
+ * notified when the table becomes empty or non-empty */
+static
+void add_table(
+    ecs_query_t *query,
+    ecs_table_t *table)
+{
+    ecs_table_t **elem;
+
+    if (ecs_vector_count(table->columns[0].data)) {
+        elem = ecs_vector_add(&query->tables, &ptr_params);
+    } else {
+        elem = ecs_vector_add(&query->inactive_tables, &ptr_params);
+    }
+
+    *elem = table;
+
+    ecs_query_t **q_elem = ecs_vector_add(&table->queries, &ptr_params);
+    *q_elem = query;
+}
+
+/** Remove query from the tables it is registered with */
+static
+void unregister_tables(
+    ecs_query_t *query,
+    ecs_vector_t *tables)
+{
+    ecs_table_t **buffer = ecs_vector_first(tables);
+    uint32_t i, count = ecs_vector_count(tables);
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = buffer[i];
+        ecs_query_t **queries = ecs_vector_first(table->queries);
+        uint32_t q, q_count = ecs_vector_count(table->queries);
+
+        for (q = 0; q < q_count; q ++) {
+            if (queries[q] == query) {
+                ecs_vector_remove_index(table->queries, &ptr_params, q);
+                break;
+            }
+        }
+    }
+}
+
+static
+bool match_table(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_table_t *table)
+{
+    return table->columns && 
+        ecs_type_match_w_filter(world, table->type, &query->filter);
+}
+
+/* -- Private functions -- */
+
+void ecs_query_notify_of_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_query_t **buffer = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_query_t *query = buffer[i];
+        if (match_table(world, query, table)) {
+            add_table(query, table);
+        }
+    }
+}
+
+void ecs_query_activate_table(
+    ecs_query_t *query,
+    ecs_table_t *table,
+    bool active)
+{
+    ecs_vector_t *src_array, *dst_array;
+
+    if (active) {
+        src_array = query->inactive_tables;
+        dst_array = query->tables;
+    } else {
+        src_array = query->tables;
+        dst_array = query->inactive_tables;
+    }
+
+    int32_t i = find_table(src_array, table);
+    ecs_assert(i != -1, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_vector_move_index(&dst_array, src_array, &ptr_params, i);
+
+    if (active) {
+        query->tables = dst_array;
+    } else {
+        query->inactive_tables = dst_array;
+    }
+}
+
+void ecs_query_remove_table(
+    ecs_query_t *query,
+    ecs_table_t *table)
+{
+    int32_t index = find_table(query->inactive_tables, table);
+    if (index != -1) {
+        ecs_vector_remove_index(query->inactive_tables, &ptr_params, index);
+        return;
+    }
+
+    index = find_table(query->tables, table);
+    if (index != -1) {
+        ecs_vector_remove_index(query->tables, &ptr_params, index);
+    }
+}
+
+void ecs_query_deinit(
+    ecs_query_t *query)
+{
+    ecs_vector_free(query->tables);
+    ecs_vector_free(query->inactive_tables);
+    ecs_os_free(query);
+}
+
+/* -- Public functions -- */
+
+ecs_query_t* ecs_query_new(
+    ecs_world_t *world,
+    const ecs_filter_t *filter)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    ecs_query_t *result = ecs_os_calloc(1, sizeof(ecs_query_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    result->world = world;
+    result->filter = filter ? *filter : (ecs_filter_t){0};
+
+    /* Match existing tables. New tables are matched when they are created */
+    ecs_filter_iter_t it = ecs_filter_iter(world, &result->filter);
+    while (ecs_filter_next(&it)) {
+        add_table(result, it.rows.table);
+    }
+
+    ecs_query_t **elem = ecs_vector_add(&world->queries, &ptr_params);
+    *elem = result;
+
+    return result;
+}
+
+void ecs_query_free(
+    ecs_query_t *query)
+{
+    ecs_world_t *world = query->world;
+
+    unregister_tables(query, query->tables);
+    unregister_tables(query, query->inactive_tables);
+
+    ecs_query_t **buffer = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        if (buffer[i] == query) {
+            ecs_vector_remove_index(world->queries, &ptr_params, i);
+            break;
+        }
+    }
+
+    ecs_query_deinit(query);
+}
+
+uint32_t ecs_query_table_count(
+    ecs_query_t *query)
+{
+    return ecs_vector_count(query->tables) + 
+        ecs_vector_count(query->inactive_tables);
+}
+
+ecs_query_iter_t ecs_query_iter(
+    ecs_query_t *query)
+{
+    return (ecs_query_iter_t){
+        .query = query,
+        .index = 0,
+        .rows = {
+            .world = query->world
+        }
+    };
+}
+
+bool ecs_query_next(
+    ecs_query_iter_t *iter)
+{
+    ecs_query_t *query = iter->query;
+
+    /* Empty tables are stored in inactive_tables, so that they are skipped
+     * without having to test them */
+    uint32_t count = ecs_vector_count(query->tables);
+    if (iter->index >= count) {
+        return false;
+    }
+
+    ecs_table_t *table = 
+        ((ecs_table_t**)ecs_vector_first(query->tables))[iter->index ++];
+
+    ecs_rows_t *rows = &iter->rows;
+    rows->table = table;
+    rows->table_columns = table->columns;
+    rows->count = ecs_vector_count(table->columns[0].data);
+    rows->entities = ecs_vector_first(table->columns[0].data);
+
+    return true;
+}
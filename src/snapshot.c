@@ -13,7 +13,10 @@ void dup_table(
     /* Now copy each column separately */
     for (c = 0; c < column_count + 1; c ++) {
         ecs_table_column_t *column = &table->columns[c];
-        ecs_vector_params_t column_params = {.element_size = column->size};
+        ecs_vector_params_t column_params = {
+            .element_size = column->size,
+            .alignment = column->alignment
+        };
         column->data = ecs_vector_copy(column->data, &column_params);
     }
 }
@@ -21,8 +24,9 @@ void dup_table(
 static
 ecs_snapshot_t* snapshot_create(
     ecs_world_t *world,
-    const ecs_map_t *entity_index,
+    const ecs_ei_t *entity_index,
     const ecs_chunked_t *tables,
+    ecs_map_t *sparse_sets,
     const ecs_filter_t *filter)
 {
     ecs_snapshot_t *result = ecs_os_malloc(sizeof(ecs_snapshot_t));
@@ -34,9 +38,13 @@ ecs_snapshot_t* snapshot_create(
     if (filter || !entity_index) {
         result->filter = filter ? *filter : (ecs_filter_t){0};
         result->entity_index = NULL;
+        result->sparse_sets = NULL;
     } else {
         result->filter = (ecs_filter_t){0};
-        result->entity_index = ecs_map_copy(entity_index);
+        result->entity_index = ecs_ei_copy(entity_index);
+
+        /* Sparse tags are restored together with the entity index */
+        result->sparse_sets = ecs_sparse_copy_sets(sparse_sets);
     }
 
     /* We need to dup the table data, because right now the copied tables are
@@ -80,6 +88,7 @@ ecs_snapshot_t* ecs_snapshot_take(
             world,
             world->main_stage.entity_index,
             world->main_stage.tables,
+            world->sparse_sets,
             filter);
 
     result->last_handle = world->last_handle;
@@ -97,6 +106,7 @@ ecs_snapshot_t* ecs_snapshot_copy(
             world,
             snapshot->entity_index,
             snapshot->tables,
+            snapshot->sparse_sets,
             filter);
 
     if (!filter) {
@@ -124,14 +134,21 @@ void ecs_snapshot_restore(
     } else {
         /* If no filter was used, the entity index will be an exact copy of what
          * it was before taking the snapshot */
-        ecs_map_free(world->main_stage.entity_index);
+        ecs_ei_free(world->main_stage.entity_index);
         world->main_stage.entity_index = snapshot->entity_index;
+        ecs_sparse_restore_sets(world, snapshot->sparse_sets);
     }   
 
-    /* Move snapshot data to table */
+    /* Move snapshot data to table. Tables are looked up by type, as tables may
+     * have been released by compaction after the snapshot was taken. */
     uint32_t i, count = ecs_chunked_count(snapshot->tables);
+    ecs_map_t *snapshot_types = ecs_map_new(count, sizeof(bool));
+
     for (i = 0; i < count; i ++) {
         ecs_table_t *src = ecs_chunked_get(snapshot->tables, ecs_table_t, i);
+        bool in_snapshot = true;
+        ecs_map_set(snapshot_types, (uintptr_t)src->type, &in_snapshot);
+
         if (src->flags & EcsTableHasBuiltins) {
             continue;
         }
@@ -143,7 +160,8 @@ void ecs_snapshot_restore(
             continue;
         }
 
-        ecs_table_t *dst = ecs_chunked_get(world->main_stage.tables, ecs_table_t, i);
+        ecs_table_t *dst = ecs_world_get_table(
+            world, &world->main_stage, src->type);
         ecs_table_replace_columns(world, dst, src->columns);
 
         /* If a filter was used, we need to fix the entity index one by one */
@@ -151,25 +169,29 @@ void ecs_snapshot_restore(
             ecs_vector_t *entities = dst->columns[0].data;
             ecs_entity_t *array = ecs_vector_first(entities);
             uint32_t j, row_count = ecs_vector_count(entities);
-            ecs_map_t *entity_index = world->main_stage.entity_index;
+            ecs_ei_t *entity_index = world->main_stage.entity_index;
             
             for (j = 0; j < row_count; j ++) {
                 ecs_row_t row = {
                     .type = dst->type,
                     .index = j + 1
                 };
-                ecs_map_set(entity_index, array[j], &row);
+                ecs_ei_set(entity_index, array[j], &row);
             } 
         }
     }
 
-    /* Clear data from remaining tables */
+    /* Clear data from tables that were created after taking the snapshot */
     uint32_t world_count = ecs_chunked_count(world->main_stage.tables);
-    for (; i < world_count; i ++) {
+    for (i = 0; i < world_count; i ++) {
         ecs_table_t *table = ecs_chunked_get(world->main_stage.tables, ecs_table_t, i);
-        ecs_table_replace_columns(world, table, NULL);
+        if (!ecs_map_get_ptr(snapshot_types, (uintptr_t)table->type)) {
+            ecs_table_replace_columns(world, table, NULL);
+        }
     }
 
+    ecs_map_free(snapshot_types);
+
     ecs_chunked_free(snapshot->tables);
 
     world->should_match = true;
@@ -188,9 +210,11 @@ void ecs_snapshot_free(
     ecs_snapshot_t *snapshot)
 {
     if (snapshot->entity_index) {
-        ecs_map_free(snapshot->entity_index);
+        ecs_ei_free(snapshot->entity_index);
     }
 
+    ecs_sparse_free_sets(snapshot->sparse_sets);
+
     uint32_t i, count = ecs_chunked_count(snapshot->tables);
     for (i = 0; i < count; i ++) {
         ecs_table_t *src = ecs_chunked_get(snapshot->tables, ecs_table_t, i);
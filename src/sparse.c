@@ -0,0 +1,537 @@
+#include "flecs_private.h"
+
+static
+const ecs_vector_params_t sparse_op_params = {
+    .element_size = sizeof(ecs_op_t)
+};
+
+static
+ecs_sparse_set_t* new_set(
+    ecs_entity_t component)
+{
+    ecs_sparse_set_t *result = ecs_os_malloc(sizeof(ecs_sparse_set_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    result->component = component;
+    result->index = ecs_map_new(0, sizeof(uint32_t));
+    result->dense = NULL;
+
+    return result;
+}
+
+static
+void free_set(
+    ecs_sparse_set_t *set)
+{
+    ecs_map_free(set->index);
+    ecs_vector_free(set->dense);
+    ecs_os_free(set);
+}
+
+static
+bool set_has(
+    ecs_sparse_set_t *set,
+    ecs_entity_t entity)
+{
+    return ecs_map_get_ptr(set->index, entity) != NULL;
+}
+
+static
+void set_add(
+    ecs_sparse_set_t *set,
+    ecs_entity_t entity)
+{
+    if (set_has(set, entity)) {
+        return;
+    }
+
+    uint32_t dense_index = ecs_vector_count(set->dense);
+    ecs_entity_t *elem = ecs_vector_add(&set->dense, &handle_arr_params);
+    *elem = entity;
+
+    ecs_map_set(set->index, entity, &dense_index);
+}
+
+static
+void set_remove(
+    ecs_sparse_set_t *set,
+    ecs_entity_t entity)
+{
+    uint32_t *index = ecs_map_get_ptr(set->index, entity);
+    if (!index) {
+        return;
+    }
+
+    /* Move the last entity in the dense array to the removed element */
+    uint32_t dense_index = *index;
+    uint32_t last = ecs_vector_count(set->dense) - 1;
+    ecs_entity_t *dense = ecs_vector_first(set->dense);
+
+    if (dense_index != last) {
+        ecs_entity_t moved = dense[last];
+        dense[dense_index] = moved;
+        ecs_map_set(set->index, moved, &dense_index);
+    }
+
+    ecs_vector_remove_last(set->dense);
+    ecs_map_remove(set->index, entity);
+}
+
+/* Add or remove the sparse tags in a type. Components that are stored in tables
+ * are ignored. */
+static
+void apply_type(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type,
+    bool add)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_set_t *set = ecs_sparse_get_set(world, array[i]);
+        if (!set) {
+            continue;
+        }
+
+        if (add) {
+            set_add(set, entity);
+        } else {
+            set_remove(set, entity);
+        }
+    }
+}
+
+static
+bool has_sparse(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    return type && ecs_type_contains(
+        world, type, world->sparse_type, false, false);
+}
+
+/* Test if entity has all sparse tags of type */
+static
+bool has_all_sparse(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_set_t *set = ecs_sparse_get_set(world, array[i]);
+        if (set && !set_has(set, entity)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* -- Private functions -- */
+
+ecs_sparse_set_t* ecs_sparse_get_set(
+    ecs_world_t *world,
+    ecs_entity_t component)
+{
+    if (!world->sparse_sets) {
+        return NULL;
+    }
+
+    ecs_sparse_set_t *result = NULL;
+    ecs_map_has(world->sparse_sets, component, &result);
+    return result;
+}
+
+ecs_vector_t* ecs_sparse_get_sets(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    ecs_vector_t *result = NULL;
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_set_t *set = ecs_sparse_get_set(world, array[i]);
+        if (set) {
+            ecs_sparse_set_t **elem = ecs_vector_add(&result, &ptr_params);
+            *elem = set;
+        }
+    }
+
+    return result;
+}
+
+void ecs_sparse_add_remove(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t *to_add,
+    ecs_type_t *to_remove)
+{
+    ecs_type_t add = *to_add, remove = *to_remove;
+    bool sparse_add = has_sparse(world, add);
+    bool sparse_remove = has_sparse(world, remove);
+
+    if (!sparse_add && !sparse_remove) {
+        return;
+    }
+
+    if (stage == &world->main_stage) {
+        if (sparse_remove) {
+            apply_type(world, entity, remove, false);
+        }
+        if (sparse_add) {
+            apply_type(world, entity, add, true);
+        }
+    } else {
+        /* Sparse sets are only modified on the main stage, so that systems
+         * can test them while iterating, also on worker threads */
+        ecs_op_t *op = ecs_vector_add(&stage->sparse_ops, &sparse_op_params);
+        op->kind = EcsOpAddRemove;
+        op->entity = entity;
+        op->is.add_remove.to_add = sparse_add ? add : NULL;
+        op->is.add_remove.to_remove = sparse_remove ? remove : NULL;
+    }
+
+    ecs_type_t sparse_type = world->sparse_type;
+    if (sparse_add) {
+        *to_add = ecs_type_merge_intern(world, stage, add, NULL, sparse_type);
+    }
+    if (sparse_remove) {
+        *to_remove = ecs_type_merge_intern(
+            world, stage, remove, NULL, sparse_type);
+    }
+}
+
+bool ecs_sparse_has(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type,
+    bool match_all,
+    bool match_prefabs)
+{
+    ecs_type_t entity_type = ecs_get_type(world, entity);
+    ecs_get_stage(&world);
+
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = array[i];
+        ecs_sparse_set_t *set = ecs_sparse_get_set(world, e);
+        bool has;
+
+        if (set) {
+            has = set_has(set, entity);
+        } else {
+            has = ecs_type_has_entity_intern(
+                world, entity_type, e, match_prefabs);
+        }
+
+        if (match_all && !has) {
+            return false;
+        } else if (!match_all && has) {
+            return true;
+        }
+    }
+
+    return match_all;
+}
+
+uint32_t ecs_sparse_count(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    ecs_get_stage(&world);
+
+    ecs_type_t table_type = ecs_type_merge_intern(
+        world, NULL, type, NULL, world->sparse_type);
+    uint32_t result = 0;
+
+    if (!table_type) {
+        /* Only sparse tags, iterate entities of the first set */
+        ecs_sparse_set_t *set = ecs_sparse_get_set(
+            world, ((ecs_entity_t*)ecs_vector_first(type))[0]);
+        ecs_entity_t *dense = ecs_vector_first(set->dense);
+        uint32_t i, count = ecs_vector_count(set->dense);
+
+        for (i = 0; i < count; i ++) {
+            result += has_all_sparse(world, dense[i], type);
+        }
+    } else {
+        ecs_filter_iter_t it = ecs_filter_iter(world, &(ecs_filter_t){
+            .include = table_type
+        });
+
+        while (ecs_filter_next(&it)) {
+            uint32_t i;
+            for (i = 0; i < it.rows.count; i ++) {
+                result += has_all_sparse(world, it.rows.entities[i], type);
+            }
+        }
+    }
+
+    return result;
+}
+
+bool ecs_sparse_match(
+    ecs_vector_t *and_sets,
+    ecs_vector_t *not_sets,
+    ecs_entity_t entity)
+{
+    ecs_sparse_set_t **sets = ecs_vector_first(and_sets);
+    uint32_t i, count = ecs_vector_count(and_sets);
+
+    for (i = 0; i < count; i ++) {
+        if (!set_has(sets[i], entity)) {
+            return false;
+        }
+    }
+
+    sets = ecs_vector_first(not_sets);
+    count = ecs_vector_count(not_sets);
+
+    for (i = 0; i < count; i ++) {
+        if (set_has(sets[i], entity)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ecs_sparse_remove_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    if (!world->sparse_sets) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_sets);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_set_t *set = ecs_map_nextptr(&it);
+        set_remove(set, entity);
+    }
+}
+
+void ecs_sparse_clone(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t src,
+    ecs_entity_t dst)
+{
+    if (!world->sparse_sets) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_sets);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_set_t *set = ecs_map_nextptr(&it);
+        if (set_has(set, src)) {
+            ecs_type_t type = ecs_type_from_entity(world, set->component);
+            ecs_type_t to_remove = NULL;
+            ecs_sparse_add_remove(world, stage, dst, &type, &to_remove);
+        }
+    }
+}
+
+void ecs_sparse_merge(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_op_t *ops = ecs_vector_first(stage->sparse_ops);
+    uint32_t i, count = ecs_vector_count(stage->sparse_ops);
+
+    for (i = 0; i < count; i ++) {
+        ecs_op_t *op = &ops[i];
+        if (op->is.add_remove.to_remove) {
+            apply_type(world, op->entity, op->is.add_remove.to_remove, false);
+        }
+        if (op->is.add_remove.to_add) {
+            apply_type(world, op->entity, op->is.add_remove.to_add, true);
+        }
+    }
+
+    ecs_vector_clear(stage->sparse_ops);
+}
+
+ecs_map_t* ecs_sparse_copy_sets(
+    ecs_map_t *sets)
+{
+    if (!sets) {
+        return NULL;
+    }
+
+    ecs_map_t *result = ecs_map_new(ecs_map_count(sets), sizeof(ecs_sparse_set_t*));
+
+    ecs_map_iter_t it = ecs_map_iter(sets);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_set_t *set = ecs_map_nextptr(&it);
+        ecs_sparse_set_t *copy = ecs_os_malloc(sizeof(ecs_sparse_set_t));
+        ecs_assert(copy != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+        copy->component = set->component;
+        copy->index = ecs_map_copy(set->index);
+        copy->dense = ecs_vector_copy(set->dense, &handle_arr_params);
+
+        ecs_map_set(result, set->component, &copy);
+    }
+
+    return result;
+}
+
+void ecs_sparse_restore_sets(
+    ecs_world_t *world,
+    ecs_map_t *sets)
+{
+    if (!world->sparse_sets) {
+        ecs_sparse_free_sets(sets);
+        return;
+    }
+
+    /* Sets are restored in place, as systems store pointers to them */
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_sets);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_set_t *set = ecs_map_nextptr(&it);
+        ecs_sparse_set_t *copy = NULL;
+
+        if (sets && ecs_map_has(sets, set->component, &copy)) {
+            ecs_map_free(set->index);
+            ecs_vector_free(set->dense);
+            set->index = copy->index;
+            set->dense = copy->dense;
+            ecs_os_free(copy);
+            ecs_map_remove(sets, set->component);
+        } else {
+            /* Tag was made sparse after the snapshot was taken */
+            ecs_map_clear(set->index);
+            ecs_vector_clear(set->dense);
+        }
+    }
+
+    ecs_sparse_free_sets(sets);
+}
+
+void ecs_sparse_free_sets(
+    ecs_map_t *sets)
+{
+    if (!sets) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(sets);
+    while (ecs_map_hasnext(&it)) {
+        free_set(ecs_map_nextptr(&it));
+    }
+
+    ecs_map_free(sets);
+}
+
+void ecs_sparse_memory(
+    ecs_world_t *world,
+    uint32_t *allocd,
+    uint32_t *used)
+{
+    if (!world->sparse_sets) {
+        return;
+    }
+
+    ecs_map_memory(world->sparse_sets, allocd, used);
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_sets);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_set_t *set = ecs_map_nextptr(&it);
+        ecs_map_memory(set->index, allocd, used);
+        ecs_vector_memory(set->dense, &handle_arr_params, allocd, used);
+    }
+}
+
+#ifndef NDEBUG
+/** Test if a column system in the array matches the tag on its entities */
+static
+bool systems_match_tag(
+    ecs_world_t *world,
+    ecs_vector_t *systems,
+    ecs_entity_t tag)
+{
+    ecs_entity_t *buffer = ecs_vector_first(systems);
+    uint32_t i, count = ecs_vector_count(systems);
+
+    for (i = 0; i < count; i ++) {
+        EcsColSystem *system_data = ecs_get_ptr(world, buffer[i], EcsColSystem);
+        EcsSystem *base = &system_data->base;
+
+        if (ecs_type_has_entity_intern(world, base->and_from_self, tag, false) ||
+            ecs_type_has_entity_intern(world, base->not_from_self, tag, false))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Systems split sparse tags from their signature when they are created, so a
+ * tag can't be made sparse once a system matches it */
+static
+bool column_systems_match_tag(
+    ecs_world_t *world,
+    ecs_entity_t tag)
+{
+    return 
+        systems_match_tag(world, world->on_load_systems, tag) ||
+        systems_match_tag(world, world->post_load_systems, tag) ||
+        systems_match_tag(world, world->pre_update_systems, tag) ||
+        systems_match_tag(world, world->on_update_systems, tag) ||
+        systems_match_tag(world, world->on_validate_systems, tag) ||
+        systems_match_tag(world, world->post_update_systems, tag) ||
+        systems_match_tag(world, world->pre_store_systems, tag) ||
+        systems_match_tag(world, world->on_store_systems, tag) ||
+        systems_match_tag(world, world->manual_systems, tag) ||
+        systems_match_tag(world, world->inactive_systems, tag);
+}
+#endif
+
+/* -- Public functions -- */
+
+void ecs_set_sparse(
+    ecs_world_t *world,
+    ecs_entity_t tag)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    if (ecs_sparse_get_set(world, tag)) {
+        return;
+    }
+
+    /* Only tags can be stored in sparse sets */
+    EcsComponent *component = ecs_get_ptr(world, tag, EcsComponent);
+    ecs_assert(component != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(component->size == 0, ECS_INVALID_PARAMETER, NULL);
+    (void)component;
+
+    /* Entities that have the tag are stored in tables */
+    ecs_assert(!_ecs_count(world, ecs_type_from_entity(world, tag)), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    /* Systems that use the tag must be created after it is made sparse */
+    ecs_assert(!column_systems_match_tag(world, tag), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    if (!world->sparse_sets) {
+        world->sparse_sets = ecs_map_new(0, sizeof(ecs_sparse_set_t*));
+    }
+
+    ecs_sparse_set_t *set = new_set(tag);
+    ecs_map_set(world->sparse_sets, tag, &set);
+
+    world->sparse_type = ecs_type_add_intern(
+        world, NULL, world->sparse_type, tag);
+}
@@ -1,19 +1,16 @@
 #include "flecs_private.h"
 
-static
-void merge_families(
-    ecs_world_t *world,
-    ecs_stage_t *stage)
-{
-    bool is_temp_stage = stage == &world->temp_stage;
-    if (is_temp_stage) {
-        if (stage->last_link) {
-            world->main_stage.last_link = stage->last_link;
-        }
+const ecs_vector_params_t merge_item_params = {
+    .element_size = sizeof(ecs_merge_item_t)
+};
 
-        stage->last_link = NULL;
-    }
-}
+const ecs_vector_params_t op_params = {
+    .element_size = sizeof(ecs_op_t)
+};
+
+const ecs_vector_params_t op_data_params = {
+    .element_size = sizeof(char)
+};
 
 static
 void notify_new_tables(
@@ -50,38 +47,112 @@ void clean_data_stage(
         ecs_os_free(columns);
     }
 
-    ecs_map_clear(stage->entity_index);
+    ecs_ei_clear(stage->entity_index);
     ecs_map_clear(stage->remove_merge);
     ecs_map_clear(stage->data_stage);
+    ecs_vector_clear(stage->deleted);
 }
 
 static
-void merge_commits(
+void recycle_deleted(
     ecs_world_t *world,
     ecs_stage_t *stage)
-{  
-    if (!ecs_map_count(stage->entity_index)) {
+{
+    ecs_entity_t *deleted = ecs_vector_first(stage->deleted);
+    uint32_t i, count = ecs_vector_count(stage->deleted);
+
+    for (i = 0; i < count; i ++) {
+        ecs_recycle_entity(world, deleted[i]);
+    }
+}
+
+/** Delete entities that were deleted while in progress in a single batch. If
+ * an entity got components after it was deleted, it is merged as usual. */
+static
+void merge_deleted(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_entity_t *deleted = ecs_vector_first(stage->deleted);
+    uint32_t i, count = ecs_vector_count(stage->deleted);
+    if (!count) {
         return;
     }
 
-    ecs_map_iter_t it = ecs_map_iter(stage->entity_index);
+    ecs_entity_t *entities = ecs_os_malloc(count * sizeof(ecs_entity_t));
+    ecs_assert(entities != NULL, ECS_OUT_OF_MEMORY, NULL);
 
-    while (ecs_map_hasnext(&it)) {
-        ecs_entity_t entity;
-        ecs_row_t *row = ecs_map_next_w_key(&it, &entity);
-        ecs_merge_entity(world, stage, entity, *row);
+    uint32_t entity_count = 0;
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t entity = deleted[i];
+        ecs_row_t *row = ecs_ei_get(stage->entity_index, entity);
+        if (row && !row->type) {
+            entities[entity_count ++] = entity;
+        }
     }
-    
-    clean_data_stage(stage);
+
+    ecs_delete_entities(world, entities, entity_count);
+
+    ecs_os_free(entities);
 }
 
 static
-void clean_types(
+void merge_commits(
+    ecs_world_t *world,
     ecs_stage_t *stage)
-{
-    (void)stage;
+{  
+    if (!ecs_ei_count(stage->entity_index)) {
+        return;
+    }
+
+    merge_deleted(world, stage);
+
+    uint32_t count = ecs_ei_count(stage->entity_index);
+
+    /* When there is enough staged data, commit all entities first, and then
+     * let the worker threads copy the staged data. Committing entities
+     * modifies tables and the entity index, and runs systems, so this always
+     * happens on the main thread. */
+    bool parallel = ecs_vector_count(world->worker_threads) > 1 &&
+        count >= ECS_MERGE_MIN_PARALLEL;
+
+    ecs_ei_iter_t it = ecs_ei_iter(stage->entity_index);
+    ecs_merge_item_t item;
+
+    if (parallel) {
+        ecs_vector_clear(world->merge_items);
+    }
+
+    while (ecs_ei_hasnext(&it)) {
+        ecs_entity_t entity;
+        ecs_row_t *row = ecs_ei_next(&it, &entity);
+
+        /* Skip entities that have been deleted by merge_deleted */
+        if (!row->type && !ecs_ei_get(world->main_stage.entity_index, entity)) {
+            continue;
+        }
+
+        if (ecs_merge_commit(world, stage, entity, *row, &item)) {
+            if (parallel) {
+                ecs_merge_item_t *elem = ecs_vector_add(
+                    &world->merge_items, &merge_item_params);
+                *elem = item;
+            } else {
+                ecs_merge_copy(world, &item, false);
+            }
+        }
+    }
+
+    uint32_t item_count = ecs_vector_count(world->merge_items);
+    if (parallel && item_count) {
+        ecs_run_merge_jobs(
+            world, ecs_vector_first(world->merge_items), item_count);
+    }
+
+    /* Recycle ids of deleted entities, now that the main stage is up to date */
+    recycle_deleted(world, stage);
     
-    /* TODO: clean types */
+    clean_data_stage(stage);
 }
 
 static
@@ -97,6 +168,121 @@ void clean_tables(
     }
 }
 
+/** Add operation to the command log of a stage */
+static
+ecs_op_t* add_op(
+    ecs_stage_t *stage,
+    ecs_op_kind_t kind,
+    ecs_entity_t entity)
+{
+    ecs_op_t *op = ecs_vector_add(&stage->ops, &op_params);
+    op->kind = kind;
+    op->entity = entity;
+    return op;
+}
+
+/** Order operations by entity. Operations on the same entity keep the order in
+ * which they were recorded, as they are compared by their address in the log. */
+static
+int compare_op(
+    const void *p1,
+    const void *p2)
+{
+    const ecs_op_t *op1 = *(ecs_op_t**)p1;
+    const ecs_op_t *op2 = *(ecs_op_t**)p2;
+
+    if (op1->entity != op2->entity) {
+        return (op1->entity > op2->entity) - (op1->entity < op2->entity);
+    }
+
+    return (op1 > op2) - (op1 < op2);
+}
+
+/** Test if the value of a set operation is overwritten or removed by a later
+ * operation on the same entity */
+static
+bool set_is_overwritten(
+    ecs_world_t *world,
+    ecs_op_t **ops,
+    uint32_t index,
+    uint32_t end)
+{
+    ecs_entity_t component = ops[index]->is.set.component;
+    uint32_t i;
+
+    for (i = index + 1; i < end; i ++) {
+        ecs_op_t *op = ops[i];
+        if (op->kind == EcsOpSet) {
+            if (op->is.set.component == component) {
+                return true;
+            }
+        } else if (op->kind == EcsOpAddRemove) {
+            ecs_type_t to_remove = op->is.add_remove.to_remove;
+            if (to_remove && 
+                ecs_type_has_entity_intern(world, to_remove, component, false)) 
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/** Replay operations on a single entity. All components added and removed by
+ * the operations are committed at once, after which the last value of each set
+ * component is assigned. */
+static
+void replay_entity(
+    ecs_world_t *world,
+    ecs_op_t **ops,
+    uint32_t start,
+    uint32_t end,
+    char *data)
+{
+    ecs_stage_t *stage = &world->main_stage;
+    ecs_entity_t entity = ops[start]->entity;
+    ecs_type_t to_add = NULL, to_remove = NULL;
+    uint32_t i;
+
+    /* Operations before a delete have no effect */
+    for (i = end; i > start; i --) {
+        if (ops[i - 1]->kind == EcsOpDelete) {
+            ecs_delete(world, entity);
+            start = i;
+            break;
+        }
+    }
+
+    for (i = start; i < end; i ++) {
+        ecs_op_t *op = ops[i];
+        ecs_type_t add = NULL, remove = NULL;
+
+        if (op->kind == EcsOpAddRemove) {
+            add = op->is.add_remove.to_add;
+            remove = op->is.add_remove.to_remove;
+        } else if (op->kind == EcsOpSet) {
+            add = ecs_type_from_entity(world, op->is.set.component);
+        }
+
+        to_add = ecs_type_merge_intern(world, stage, to_add, add, remove);
+        to_remove = ecs_type_merge_intern(world, stage, to_remove, remove, add);
+    }
+
+    if (to_add || to_remove) {
+        ecs_entity_info_t info = {.entity = entity};
+        ecs_add_remove_intern(world, &info, to_add, to_remove, true);
+    }
+
+    for (i = start; i < end; i ++) {
+        ecs_op_t *op = ops[i];
+        if (op->kind == EcsOpSet && !set_is_overwritten(world, ops, i, end)) {
+            _ecs_set_ptr(world, entity, op->is.set.component, op->is.set.size, 
+                data + op->is.set.offset);
+        }
+    }
+}
+
 /* -- Private functions -- */
 
 void ecs_stage_init(
@@ -104,20 +290,11 @@ void ecs_stage_init(
     ecs_stage_t *stage)
 {
     bool is_main_stage = stage == &world->main_stage;
-    bool is_temp_stage = stage == &world->temp_stage;
 
     memset(stage, 0, sizeof(ecs_stage_t));
 
-    stage->entity_index = ecs_map_new(0, sizeof(ecs_row_t));
+    stage->entity_index = ecs_ei_new(0);
 
-    if (is_main_stage) {
-        stage->last_link = &world->main_stage.type_root.link;
-    } else if (is_temp_stage) {
-        stage->type_root = world->main_stage.type_root;
-        stage->last_link = NULL;
-    } else {
-    }
-    
     stage->table_index = ecs_map_new(0, sizeof(ecs_table_t*));
     if (is_main_stage) {
         stage->tables = ecs_chunked_new(ecs_table_t, 64, 1);
@@ -141,22 +318,21 @@ void ecs_stage_deinit(
     ecs_stage_t *stage)
 {
     bool is_main_stage = stage == &world->main_stage;
-    bool is_temp_stage = stage == &world->temp_stage;
-
-    if (!is_temp_stage) {
-        clean_types(stage);
-    }
 
     if (!is_main_stage) {
         clean_data_stage(stage);
         ecs_map_free(stage->data_stage);
         ecs_map_free(stage->remove_merge);
+        ecs_vector_free(stage->deleted);
+        ecs_vector_free(stage->ops);
+        ecs_vector_free(stage->op_data);
+        ecs_vector_free(stage->sparse_ops);
     }
 
     clean_tables(world, stage);
     ecs_chunked_free(stage->tables);
     ecs_map_free(stage->table_index);
-    ecs_map_free(stage->entity_index);
+    ecs_ei_free(stage->entity_index);
 }
 
 void ecs_stage_merge(
@@ -167,9 +343,12 @@ void ecs_stage_merge(
     
     /* Keep track of old number of tables so we know how many have been added */
     uint32_t old_table_count = ecs_chunked_count(world->main_stage.tables);
+
+    /* Apply sparse tags before merging entities, so that tags of entities that
+     * were deleted in the stage are removed when the deletes are merged */
+    ecs_sparse_merge(world, stage);
     
     /* Merge any new types */
-    merge_families(world, stage);
     
     /* Merge entities. This can create tables if a new combination of components
      * is found after merging the staged type with the non-staged type. */
@@ -187,3 +366,117 @@ void ecs_stage_merge(
         notify_new_tables(world, old_table_count, new_table_count);
     }
 }
+
+bool ecs_stage_is_deferred(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    return world->deferred_mode && stage != &world->main_stage && 
+        stage != &world->temp_stage;
+}
+
+void ecs_stage_defer_add_remove(
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t to_add,
+    ecs_type_t to_remove)
+{
+    ecs_op_t *op = add_op(stage, EcsOpAddRemove, entity);
+    op->is.add_remove.to_add = to_add;
+    op->is.add_remove.to_remove = to_remove;
+}
+
+void ecs_stage_defer_set(
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    size_t size,
+    const void *ptr)
+{
+    ecs_op_t *op = add_op(stage, EcsOpSet, entity);
+    op->is.set.component = component;
+    op->is.set.size = size;
+    op->is.set.offset = ecs_vector_count(stage->op_data);
+
+    if (size) {
+        void *data = ecs_vector_addn(&stage->op_data, &op_data_params, size);
+        if (ptr) {
+            memcpy(data, ptr, size);
+        } else {
+            memset(data, 0, size);
+        }
+    }
+}
+
+void ecs_stage_defer_delete(
+    ecs_stage_t *stage,
+    ecs_entity_t entity)
+{
+    add_op(stage, EcsOpDelete, entity);
+}
+
+void ecs_stage_replay(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_vector_t *log = stage->ops;
+    ecs_vector_t *log_data = stage->op_data;
+    uint32_t i, start, count = ecs_vector_count(log);
+
+    if (!count) {
+        return;
+    }
+
+    /* Detach log from stage, as replayed operations can invoke systems that
+     * merge the world while the log is being replayed */
+    stage->ops = NULL;
+    stage->op_data = NULL;
+
+    ecs_op_t *buffer = ecs_vector_first(log);
+    ecs_op_t **ops = ecs_os_malloc(sizeof(ecs_op_t*) * count);
+    for (i = 0; i < count; i ++) {
+        ops[i] = &buffer[i];
+    }
+
+    /* Group operations by entity, so that operations on the same entity can be
+     * coalesced into a single commit */
+    qsort(ops, count, sizeof(ecs_op_t*), compare_op);
+
+    /* Entities for which the last operation is a delete are deleted together
+     * after the other operations have been replayed */
+    ecs_entity_t *deleted = ecs_os_malloc(sizeof(ecs_entity_t) * count);
+    uint32_t deleted_count = 0;
+
+    char *data = ecs_vector_first(log_data);
+    for (start = 0, i = 1; i <= count; i ++) {
+        if (i == count || ops[i]->entity != ops[start]->entity) {
+            if (ops[i - 1]->kind == EcsOpDelete) {
+                deleted[deleted_count ++] = ops[start]->entity;
+            } else {
+                replay_entity(world, ops, start, i, data);
+            }
+            start = i;
+        }
+    }
+
+    ecs_delete_entities(world, deleted, deleted_count);
+
+    for (i = 0; i < deleted_count; i ++) {
+        ecs_recycle_entity(world, deleted[i]);
+    }
+
+    ecs_os_free(deleted);
+    ecs_os_free(ops);
+
+    /* Reuse memory of the log for the next frame */
+    ecs_vector_clear(log);
+    ecs_vector_clear(log_data);
+
+    if (!stage->ops) {
+        stage->ops = log;
+        stage->op_data = log_data;
+    } else {
+        ecs_vector_free(log);
+        ecs_vector_free(log_data);
+    }
+}
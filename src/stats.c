@@ -1,7 +1,8 @@
 #include "flecs_private.h"
 
+/* Tables are referred to by type, as tables may be released by compaction */
 typedef struct EcsTablePtr {
-    ecs_table_t *table;
+    ecs_type_t type;
 } EcsTablePtr;
 
 /* -- Systems that add components on interest */
@@ -112,12 +113,13 @@ void StatsCollectWorldStats(ecs_rows_t *rows) {
 
     ecs_world_t *world = rows->world;
 
-    stats->entities_count = ecs_map_count(world->main_stage.entity_index);
+    stats->entities_count = ecs_ei_count(world->main_stage.entity_index);
     stats->components_count = ecs_count(world, EcsComponent);
     stats->col_systems_count = ecs_count(world, EcsColSystem);
     stats->row_systems_count = ecs_count(world, EcsRowSystem);
     stats->inactive_systems_count = ecs_vector_count(world->inactive_systems);
     stats->tables_count = ecs_chunked_count(world->main_stage.tables);
+    stats->types_count = ecs_vector_count(world->types);
     stats->threads_count = ecs_vector_count(world->worker_threads);
     stats->frame_seconds_total = world->frame_time_total;
     stats->system_seconds_total = world->system_time_total;
@@ -125,6 +127,8 @@ void StatsCollectWorldStats(ecs_rows_t *rows) {
     stats->world_seconds_total = world->world_time_total;
     stats->target_fps_hz = world->target_fps;
     stats->frame_count_total = world->frame_count_total;
+    stats->merge_count_total = world->merge_count_total;
+    stats->merge_skip_count_total = world->merge_skip_count_total;
 }
 
 static
@@ -187,7 +191,7 @@ void compute_stage_memory(
     ecs_stage_t *stage, 
     EcsMemoryStats *stats)
 {
-    ecs_map_memory(stage->entity_index, 
+    ecs_ei_memory(stage->entity_index, 
         &stats->entities_memory.allocd_bytes, 
         &stats->entities_memory.used_bytes);
 
@@ -268,6 +272,20 @@ void compute_world_memory(
     ecs_map_memory(world->main_stage.table_index,
         &stats->tables_memory.allocd_bytes, &stats->tables_memory.used_bytes);
 
+    /* Compute memory used by type index and the types it stores */
+    stats->types_memory = (ecs_memory_stat_t){0};
+    ecs_map_memory(world->type_index,
+        &stats->types_memory.allocd_bytes, &stats->types_memory.used_bytes);
+    ecs_vector_memory(world->types, &ptr_params,
+        &stats->types_memory.allocd_bytes, &stats->types_memory.used_bytes);
+
+    ecs_type_t *types = ecs_vector_first(world->types);
+    uint32_t t, type_count = ecs_vector_count(world->types);
+    for (t = 0; t < type_count; t ++) {
+        ecs_vector_memory(types[t], &handle_arr_params,
+            &stats->types_memory.allocd_bytes, &stats->types_memory.used_bytes);
+    }
+
     /* Add misc lookup indices to world memory */
     ecs_map_memory(world->prefab_parent_index, 
         &stats->world_memory.allocd_bytes, &stats->world_memory.used_bytes);
@@ -304,7 +322,7 @@ void StatsCollectMemoryStats(ecs_rows_t *rows) {
 
     /* Compute entity memory (entity index) */
     stats->entities_memory = (ecs_memory_stat_t){0};
-    ecs_map_memory(world->main_stage.entity_index, 
+    ecs_ei_memory(world->main_stage.entity_index, 
         &stats->entities_memory.allocd_bytes, 
         &stats->entities_memory.used_bytes);
     
@@ -313,6 +331,11 @@ void StatsCollectMemoryStats(ecs_rows_t *rows) {
     stats->tables_memory = (ecs_memory_stat_t){0};
     ecs_run(world, StatsCollectTableMemoryTotals, 0, stats);
 
+    /* Sparse tags are not stored in tables */
+    ecs_sparse_memory(world, 
+        &stats->components_memory.allocd_bytes, 
+        &stats->components_memory.used_bytes);
+
     /* Compute system memory */
     stats->systems_memory = (ecs_memory_stat_t){0};
     ecs_run(world, StatsCollectColSystemMemoryTotals, 0, &stats->systems_memory);
@@ -320,6 +343,9 @@ void StatsCollectMemoryStats(ecs_rows_t *rows) {
     /* Compute world memory */
     compute_world_memory(world, stats);
 
+    /* Memory released by compaction */
+    stats->reclaimed_bytes_total = world->reclaimed_bytes_total;
+
     /* Add everything up to compute total memory */
     stats->total_memory.used_bytes =
         stats->entities_memory.used_bytes +
@@ -525,11 +551,14 @@ void StatsCollectComponentStats(ecs_rows_t *rows) {
             /* Iterate over table columns until component is found */
             for (c = 0; c < c_count; c ++) {
                 if (components[c] == entity) {
-                    ecs_vector_t *column = table->columns[c].data;
+                    /* First column of a table contains the entity ids */
+                    ecs_table_column_t *table_column = &table->columns[c + 1];
+                    ecs_vector_t *column = table_column->data;
                     stats[i].tables_count ++;
                     stats[i].entities_count += ecs_vector_count(column);
                     ecs_vector_params_t param = {
-                        .element_size = stats[i].size_bytes
+                        .element_size = stats[i].size_bytes,
+                        .alignment = table_column->alignment
                     };
                     ecs_vector_memory(column, &param, 
                         &stats[i].memory.allocd_bytes, 
@@ -560,7 +589,7 @@ void StatsCollectTableStats_StatusAction(
 
         for (i = 0; i < count; i ++) {
             ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
-            ecs_set(world, 0, EcsTablePtr, {table});
+            ecs_set(world, 0, EcsTablePtr, {table->type});
         }
     } else if (status == EcsSystemDisabled) {
         /* Delete all entities with EcsTable tag */
@@ -593,7 +622,8 @@ void collect_table_data_memory(
 
     for (i = 1; i <= count; i ++) {
         ecs_vector_params_t params = {
-            .element_size = columns[i].size
+            .element_size = columns[i].size,
+            .alignment = columns[i].alignment
         };
 
         ecs_vector_memory(columns[i].data, &params, 
@@ -607,12 +637,29 @@ void StatsCollectTableStats(ecs_rows_t *rows) {
     ECS_COLUMN(rows, EcsTablePtr, table_ptr, 1);
     ECS_COLUMN(rows, EcsTableStats, stats, 2);
 
+    ecs_world_t *world = rows->world;
+
     uint32_t i;
     for (i = 0; i < rows->count; i ++) {
-        ecs_table_t *table = table_ptr[i].table;
+        ecs_type_t type = table_ptr[i].type;
+        ecs_table_t *table;
+
+        stats[i].type = type;
+
+        if (!ecs_map_has(
+            world->main_stage.table_index, (uintptr_t)type, &table)) 
+        {
+            /* Table was released */
+            stats[i].columns_count = 0;
+            stats[i].rows_count = 0;
+            stats[i].systems_matched_count = 0;
+            stats[i].other_memory_bytes = 0;
+            stats[i].entity_memory = (ecs_memory_stat_t){0};
+            stats[i].component_memory = (ecs_memory_stat_t){0};
+            continue;
+        }
+
         ecs_table_column_t *columns = table->columns;
-        ecs_type_t type = table->type;
-        stats[i].type = table->type;
         stats[i].columns_count = ecs_vector_count(type);
         stats[i].rows_count = ecs_vector_count(columns[0].data);
         stats[i].systems_matched_count = ecs_vector_count(table->frame_systems);
@@ -47,11 +47,12 @@ void match_families(
     ecs_entity_t system,
     EcsRowSystem *system_data)
 {
-    ecs_type_link_t *link = &world->main_stage.type_root.link;
+    ecs_type_t *types = ecs_vector_first(world->types);
+    uint32_t i, count = ecs_vector_count(world->types);
 
-    do {
-        match_type(world, system, system_data, link->type);
-    } while ((link = link->next));
+    for (i = 0; i < count; i ++) {
+        match_type(world, system, system_data, types[i]);
+    }
 }
 
 static
@@ -581,7 +582,12 @@ ecs_type_t ecs_notify_row_system(
             buffer[i].kind == EcsFromShared) 
         {
             /* If a regular column, find corresponding column in table */
-            columns[i] = ecs_type_index_of(type, buffer[i].is.component) + 1;
+            if (table) {
+                columns[i] = ecs_table_column_index(
+                    table, buffer[i].is.component) + 1;
+            } else {
+                columns[i] = ecs_type_index_of(type, buffer[i].is.component) + 1;
+            }
 
             /* If entity owns component but column is shared, no match */
             if (columns[i] && buffer[i].kind == EcsFromShared) {
@@ -624,13 +630,11 @@ ecs_type_t ecs_notify_row_system(
             }
 
             /* Store the reference data so the system callback can access it */
-            info = (ecs_entity_info_t){.entity = entity};
             references[ref_id] = (ecs_reference_t){
                 .entity = entity, 
-                .component = component,
-                .cached_ptr = ecs_get_ptr_intern(real_world, &real_world->main_stage, 
-                                &info, component, false, true)
+                .component = component
             };
+            ecs_resolve_reference(real_world, &references[ref_id]);
 
             /* Update the column vector with the entry to the ref vector */
             ref_id ++;
@@ -1040,6 +1044,18 @@ void ecs_set_period(
     }
 }
 
+void ecs_set_system_changed_only(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    bool changed_only)
+{
+    assert(world->magic == ECS_WORLD_MAGIC);
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    if (system_data) {
+        system_data->changed_only = changed_only;
+    }
+}
+
 static
 void* get_owned_column_ptr(
     const ecs_rows_t *rows,
@@ -1077,7 +1093,14 @@ void* get_shared_column(
     }
 #endif
 
-    return rows->references[-table_column - 1].cached_ptr;    
+    ecs_reference_t *ref = &rows->references[-table_column - 1];
+    ecs_table_column_t *column = ref->column;
+    if (!column) {
+        return NULL;
+    }
+
+    void *buffer = ecs_vector_first(column->data);
+    return ECS_OFFSET(buffer, column->size * (ref->row - 1));
 }
 
 static
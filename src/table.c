@@ -8,6 +8,10 @@ void activate_table(
     ecs_entity_t system,
     bool activate)
 {
+    if (activate) {
+        table->flags &= ~EcsTableWasEmpty;
+    }
+
     if (system) {
         ecs_system_activate_table(world, system, table, activate);
     } else {
@@ -20,6 +24,70 @@ void activate_table(
                 ecs_system_activate_table(world, buffer[i], table, activate);
             }
         }
+
+        ecs_vector_t *queries = table->queries;
+
+        if (queries) {
+            ecs_query_t **buffer = ecs_vector_first(queries);
+            uint32_t i, count = ecs_vector_count(queries);
+            for (i = 0; i < count; i ++) {
+                ecs_query_activate_table(buffer[i], table, activate);
+            }
+        }
+    }
+}
+
+/** Mark all component columns as changed. This is used when rows are added to
+ * a table, as systems that only run for changed tables have not yet seen the
+ * component values of the new rows. */
+static
+void mark_columns_changed(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_table_column_t *columns)
+{
+    uint32_t i, column_count = ecs_vector_count(table->type);
+    uint32_t tick = world->change_tick;
+
+    for (i = 1; i < column_count + 1; i ++) {
+        columns[i].change_tick = tick;
+    }
+}
+
+/** Row that is moved into the slot of a deleted row */
+typedef struct row_move_t {
+    uint32_t dst;
+    uint32_t src;
+} row_move_t;
+
+/** Update the entity index for an entity that moved to a different row in its
+ * table. A negative index indicates that the entity is watched, which must be
+ * preserved. Systems that reference a watched entity store its row, so their
+ * references are resolved again before the next frame. */
+static
+void move_entity_row(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    ecs_entity_t entity,
+    uint32_t index)
+{
+    ecs_row_t *row = ecs_ei_get(stage->entity_index, entity);
+    if (!row) {
+        ecs_ei_set(stage->entity_index, entity, &(ecs_row_t){
+            .type = table->type, .index = index});
+        return;
+    }
+
+    row->type = table->type;
+
+    if (row->index < 0) {
+        row->index = -(int32_t)index;
+        if (stage == &world->main_stage) {
+            world->should_resolve = true;
+        }
+    } else {
+        row->index = index;
     }
 }
 
@@ -51,6 +119,10 @@ ecs_table_column_t* new_columns(
             if (component->size) {
                 /* Regular column data */
                 result[i + 1].size = component->size;
+                result[i + 1].alignment = ECS_COLUMN_ALIGNMENT;
+                if (component->alignment > ECS_COLUMN_ALIGNMENT) {
+                    result[i + 1].alignment = component->alignment;
+                }
             }
         }
 
@@ -61,13 +133,261 @@ ecs_table_column_t* new_columns(
         if (table && buf[i] == EEcsPrefab) {
             table->flags |= EcsTableIsPrefab;
         }
+
+        if (table && buf[i] & ECS_INSTANCEOF) {
+            table->flags |= EcsTableHasPrefab;
+        }
     }
     
     return result;
 }
 
+static
+void init_moves(
+    ecs_table_edge_t *edge,
+    ecs_table_t *src)
+{
+    ecs_table_t *dst = edge->table;
+    ecs_entity_t *src_components = ecs_vector_first(src->type);
+    ecs_entity_t *dst_components = ecs_vector_first(dst->type);
+    uint32_t i_src = 0, src_count = ecs_vector_count(src->type);
+    uint32_t i_dst = 0, dst_count = ecs_vector_count(dst->type);
+    uint32_t count = 0, max_count = src_count < dst_count ? src_count : dst_count;
+
+    if (!max_count) {
+        return;
+    }
+
+    edge->moves = ecs_os_malloc(max_count * sizeof(ecs_table_move_t));
+    ecs_assert(edge->moves != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    /* Same walk as when copying a row between tables, but done once */
+    while (i_src < src_count && i_dst < dst_count) {
+        ecs_entity_t src_component = src_components[i_src];
+        ecs_entity_t dst_component = dst_components[i_dst];
+
+        if ((src_component & ECS_ENTITY_FLAGS_MASK) || 
+            (dst_component & ECS_ENTITY_FLAGS_MASK)) 
+        {
+            break;
+        }
+
+        if (src_component == dst_component) {
+            uint16_t size = dst->columns[i_dst + 1].size;
+            if (size) {
+                edge->moves[count ++] = (ecs_table_move_t){
+                    .src = i_src + 1,
+                    .dst = i_dst + 1,
+                    .size = size
+                };
+            }
+            i_src ++;
+            i_dst ++;
+        } else if (dst_component < src_component) {
+            i_dst ++;
+        } else {
+            i_src ++;
+        }
+    }
+
+    edge->move_count = count;
+}
+
+static
+void free_edges(
+    ecs_map_t *edges)
+{
+    if (!edges) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(edges);
+    while (ecs_map_hasnext(&it)) {
+        ecs_table_edge_t *edge = ecs_map_next(&it);
+        ecs_os_free(edge->moves);
+    }
+
+    ecs_map_free(edges);
+}
+
+/** Remove edges to tables that are released by ecs_world_compact */
+static
+void remove_released_edges(
+    ecs_map_t *edges)
+{
+    if (!edges) {
+        return;
+    }
+
+    ecs_vector_params_t key_params = {.element_size = sizeof(uint64_t)};
+    ecs_vector_t *keys = NULL;
+
+    ecs_map_iter_t it = ecs_map_iter(edges);
+    while (ecs_map_hasnext(&it)) {
+        uint64_t key;
+        ecs_table_edge_t *edge = ecs_map_next_w_key(&it, &key);
+        if (edge->table && edge->table->flags & EcsTableIsReleased) {
+            ecs_os_free(edge->moves);
+            uint64_t *elem = ecs_vector_add(&keys, &key_params);
+            *elem = key;
+        }
+    }
+
+    uint64_t *buffer = ecs_vector_first(keys);
+    uint32_t i, count = ecs_vector_count(keys);
+    for (i = 0; i < count; i ++) {
+        ecs_map_remove(edges, buffer[i]);
+    }
+
+    ecs_vector_free(keys);
+}
+
+static
+uint32_t hash_component(
+    ecs_entity_t component,
+    uint16_t mask)
+{
+    return (uint32_t)((component * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+static
+void free_lookup(
+    ecs_table_t *table)
+{
+    ecs_os_free(table->lo_columns);
+    ecs_os_free(table->hi_columns);
+}
+
 /* -- Private functions -- */
 
+void ecs_table_init_lookup(
+    ecs_table_t *table)
+{
+    ecs_entity_t *buf = ecs_vector_first(table->type);
+    int32_t i, count = ecs_vector_count(table->type);
+    uint32_t hi_count = 0;
+    ecs_entity_t max_lo = 0;
+    bool has_lo = false;
+
+    table->lo_columns = NULL;
+    table->hi_columns = NULL;
+    table->lo_count = 0;
+    table->hi_mask = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = buf[i] & ECS_ENTITY_MASK;
+        if (e < ECS_HI_COMPONENT_ID) {
+            if (e >= max_lo) {
+                max_lo = e;
+            }
+            has_lo = true;
+        } else {
+            hi_count ++;
+        }
+    }
+
+    if (has_lo) {
+        table->lo_count = max_lo + 1;
+        table->lo_columns = ecs_os_malloc(table->lo_count * sizeof(int16_t));
+        ecs_assert(table->lo_columns != NULL, ECS_OUT_OF_MEMORY, NULL);
+        memset(table->lo_columns, 0xFF, table->lo_count * sizeof(int16_t));
+    }
+
+    if (hi_count) {
+        /* Keep the load factor at or below 0.5, so probe sequences are short */
+        uint32_t size = 2;
+        while (size < hi_count * 2) {
+            size *= 2;
+        }
+
+        table->hi_mask = size - 1;
+        table->hi_columns = ecs_os_calloc(size, sizeof(ecs_table_slot_t));
+        ecs_assert(table->hi_columns != NULL, ECS_OUT_OF_MEMORY, NULL);
+    }
+
+    /* Iterate backwards, so that if an entity appears more than once (with
+     * different flags) the first occurrence wins, like ecs_type_index_of */
+    for (i = count - 1; i >= 0; i --) {
+        ecs_entity_t e = buf[i] & ECS_ENTITY_MASK;
+
+        if (e < ECS_HI_COMPONENT_ID) {
+            table->lo_columns[e] = i;
+        } else {
+            uint32_t slot = hash_component(e, table->hi_mask);
+            while (table->hi_columns[slot].component && 
+                   table->hi_columns[slot].component != e) 
+            {
+                slot = (slot + 1) & table->hi_mask;
+            }
+
+            table->hi_columns[slot] = (ecs_table_slot_t){
+                .component = e,
+                .index = i
+            };
+        }
+    }
+}
+
+int16_t ecs_table_column_index(
+    const ecs_table_t *table,
+    ecs_entity_t component)
+{
+    if (component < table->lo_count) {
+        return table->lo_columns[component];
+    }
+
+    ecs_table_slot_t *slots = table->hi_columns;
+    if (component >= ECS_HI_COMPONENT_ID && slots) {
+        uint16_t mask = table->hi_mask;
+        uint32_t slot = hash_component(component, mask);
+
+        while (slots[slot].component) {
+            if (slots[slot].component == component) {
+                return slots[slot].index;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    return -1;
+}
+
+ecs_table_edge_t* ecs_table_get_edge(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    ecs_type_t to_add,
+    ecs_type_t to_remove)
+{
+    ecs_assert(!to_add != !to_remove, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!world->in_progress, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_map_t **edges_ptr = to_add ? &table->add_edges : &table->remove_edges;
+    ecs_type_t key = to_add ? to_add : to_remove;
+
+    if (!*edges_ptr) {
+        *edges_ptr = ecs_map_new(0, sizeof(ecs_table_edge_t));
+    } else {
+        ecs_table_edge_t *edge = ecs_map_get_ptr(*edges_ptr, (uintptr_t)key);
+        if (edge) {
+            return edge;
+        }
+    }
+
+    ecs_table_edge_t edge = {
+        .type = ecs_type_merge_intern(
+            world, stage, table->type, to_add, to_remove)
+    };
+
+    if (edge.type) {
+        edge.table = ecs_world_get_table(world, stage, edge.type);
+        init_moves(&edge, table);
+    }
+
+    return ecs_map_set(*edges_ptr, (uintptr_t)key, &edge);
+}
+
+
 ecs_table_column_t* ecs_table_get_columns(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -95,8 +415,12 @@ void ecs_table_init(
     ecs_table_t *table)
 {
     table->frame_systems = NULL;
+    table->queries = NULL;
+    table->add_edges = NULL;
+    table->remove_edges = NULL;
     table->flags = 0;
     table->columns = new_columns(world, stage, table, table->type);
+    ecs_table_init_lookup(table);
 }
 
 void ecs_table_deinit(
@@ -152,14 +476,23 @@ void ecs_table_replace_columns(
         clear_columns(table);
     }
 
+    /* The columns array of a table is never reallocated, as system references
+     * point to the columns in it. Copy the new columns into the existing array
+     * and take ownership of the provided array. */
     if (columns) {
-        ecs_os_free(table->columns);
-        table->columns = columns;
+        if (table->columns) {
+            memcpy(table->columns, columns, 
+                sizeof(ecs_table_column_t) * (ecs_vector_count(table->type) + 1));
+            ecs_os_free(columns);
+        } else {
+            table->columns = columns;
+        }
     }
 
     uint32_t count = 0;
     if (table->columns) {
         count = ecs_vector_count(table->columns[0].data);
+        mark_columns_changed(world, table, table->columns);
     }
 
     if (!prev_count && count) {
@@ -190,6 +523,95 @@ void ecs_table_free(
     clear_columns(table);
     ecs_os_free(table->columns);
     ecs_vector_free(table->frame_systems);
+    ecs_vector_free(table->queries);
+    free_edges(table->add_edges);
+    free_edges(table->remove_edges);
+    free_lookup(table);
+}
+
+/* Shrink column data to the number of rows in the table. The columns of an
+ * empty table are freed. Returns the number of bytes released. */
+uint32_t ecs_table_reclaim(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    (void)world;
+    ecs_table_column_t *columns = table->columns;
+    uint32_t c, column_count = ecs_vector_count(table->type);
+    uint32_t allocd = 0, allocd_after = 0;
+    bool is_empty = !ecs_vector_count(columns[0].data);
+
+    for (c = 0; c < column_count + 1; c ++) {
+        if (!columns[c].data) {
+            continue;
+        }
+
+        ecs_vector_params_t params = {
+            .element_size = columns[c].size,
+            .alignment = columns[c].alignment
+        };
+
+        ecs_vector_memory(columns[c].data, &params, &allocd, NULL);
+
+        if (is_empty) {
+            ecs_vector_free(columns[c].data);
+            columns[c].data = NULL;
+        } else {
+            ecs_vector_reclaim(&columns[c].data, &params);
+            ecs_vector_memory(columns[c].data, &params, &allocd_after, NULL);
+        }
+    }
+
+    return allocd - allocd_after;
+}
+
+/* Release an empty table. The table is removed from the systems and queries it
+ * is matched with, and its resources are freed. Returns the number of bytes
+ * released. Removing the table from the world is up to the caller. */
+uint32_t ecs_table_release(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_assert(!ecs_vector_count(table->columns[0].data), 
+        ECS_INTERNAL_ERROR, NULL);
+
+    uint32_t column_count = ecs_vector_count(table->type);
+    uint32_t allocd = ecs_table_reclaim(world, table);
+
+    allocd += sizeof(ecs_table_column_t) * (column_count + 1);
+    allocd += table->lo_count * sizeof(int16_t);
+    if (table->hi_columns) {
+        allocd += (table->hi_mask + 1) * sizeof(ecs_table_slot_t);
+    }
+
+    ecs_vector_memory(table->frame_systems, &handle_arr_params, &allocd, NULL);
+    ecs_vector_memory(table->queries, &ptr_params, &allocd, NULL);
+    ecs_map_memory(table->add_edges, &allocd, NULL);
+    ecs_map_memory(table->remove_edges, &allocd, NULL);
+
+    ecs_entity_t *systems = ecs_vector_first(table->frame_systems);
+    uint32_t i, count = ecs_vector_count(table->frame_systems);
+    for (i = 0; i < count; i ++) {
+        ecs_system_remove_table(world, systems[i], table);
+    }
+
+    ecs_query_t **queries = ecs_vector_first(table->queries);
+    count = ecs_vector_count(table->queries);
+    for (i = 0; i < count; i ++) {
+        ecs_query_remove_table(queries[i], table);
+    }
+
+    ecs_table_free(world, table);
+
+    return allocd;
+}
+
+/* Remove edges to tables that have the EcsTableIsReleased flag */
+void ecs_table_remove_released_edges(
+    ecs_table_t *table)
+{
+    remove_released_edges(table->add_edges);
+    remove_released_edges(table->remove_edges);
 }
 
 void ecs_table_register_system(
@@ -220,34 +642,30 @@ uint32_t ecs_table_insert(
 
     *e = entity;
 
-    /* Add elements to each column array */
+    /* Add elements to each column array. System references store the row of
+     * the entity they reference, so they remain valid if a column reallocs. */
     uint32_t i;
-    bool reallocd = false;
 
     for (i = 1; i < column_count + 1; i ++) {
         uint32_t size = columns[i].size;
         if (size) {
-            ecs_vector_params_t params = {.element_size = size};
-            void *old_vector = columns[i].data;
+            ecs_vector_params_t params = {
+                .element_size = size,
+                .alignment = columns[i].alignment
+            };
 
             ecs_vector_add(&columns[i].data, &params);
-            
-            if (old_vector != columns[i].data) {
-                reallocd = true;
-            }
         }
     }
 
     uint32_t index = ecs_vector_count(columns[0].data) - 1;
 
+    mark_columns_changed(world, table, columns);
+
     if (!world->in_progress && !index) {
         activate_table(world, table, 0, true);
     }
 
-    if (reallocd && table->columns == columns) {
-        world->should_resolve = true;
-    }
-
     /* Return index of last added entity */
     return index + 1;
 }
@@ -293,29 +711,24 @@ void ecs_table_delete(
         entities[index] = to_move;
 
         for (i = 1; i < column_last; i ++) {
-            if (columns[i].size) {
-                ecs_vector_params_t params = {.element_size = columns[i].size};
-                ecs_vector_remove_index(columns[i].data, &params, index);
+            uint32_t size = columns[i].size;
+            if (size) {
+                void *data = ecs_vector_first(columns[i].data);
+                memcpy(ECS_OFFSET(data, size * index), 
+                    ECS_OFFSET(data, size * count), size);
             }
         }
 
         /* Last entity in table is now moved to index of removed entity */
-        ecs_row_t row;
-        row.type = table->type;
-        row.index = index + 1;
-        ecs_map_set(stage->entity_index, to_move, &row);
+        move_entity_row(world, stage, table, to_move, index + 1);
+    }
 
-        /* Decrease size of entity column */
-        ecs_vector_remove_last(entity_column);
+    /* Decrease column counts */
+    ecs_vector_remove_last(entity_column);
 
-    /* This is the last entity in the table, just decrease column counts */
-    } else {
-        ecs_vector_remove_last(entity_column);
-
-        for (i = 1; i < column_last; i ++) {
-            if (columns[i].size) {
-                ecs_vector_remove_last(columns[i].data);
-            }
+    for (i = 1; i < column_last; i ++) {
+        if (columns[i].size) {
+            ecs_vector_remove_last(columns[i].data);
         }
     }
     
@@ -324,6 +737,89 @@ void ecs_table_delete(
     }
 }
 
+void ecs_table_delete_rows(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    ecs_table_column_t *columns,
+    const uint32_t *rows,
+    uint32_t row_count)
+{
+    if (!stage) {
+        stage = &world->main_stage;
+    }
+    if (!columns) {
+        columns = table->columns;
+    }
+
+    if (!row_count) {
+        return;
+    }
+
+    ecs_vector_t *entity_column = columns[0].data;
+    uint32_t count = ecs_vector_count(entity_column);
+    ecs_assert(row_count <= count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(rows[row_count - 1] <= count, ECS_INTERNAL_ERROR, NULL);
+
+    uint32_t new_count = count - row_count;
+
+    /* Deleted rows below new_count are filled with the last rows of the table
+     * that are not deleted, so that the remaining rows are contiguous. The
+     * moves are computed once, and then applied to each column. */
+    row_move_t *moves = ecs_os_malloc(row_count * sizeof(row_move_t));
+    ecs_assert(moves != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    uint32_t i, j = row_count, src = count, move_count = 0;
+    for (i = 0; i < row_count && rows[i] - 1 < new_count; i ++) {
+        ecs_assert(!i || rows[i] > rows[i - 1], ECS_INTERNAL_ERROR, NULL);
+
+        /* Skip deleted rows at the end of the table */
+        src --;
+        while (j > i && rows[j - 1] - 1 == src) {
+            j --;
+            src --;
+        }
+
+        moves[move_count ++] = (row_move_t){
+            .dst = rows[i] - 1,
+            .src = src
+        };
+    }
+
+    uint32_t c, column_count = ecs_vector_count(table->type);
+    for (c = 0; c < column_count + 1; c ++) {
+        uint32_t size = c ? columns[c].size : sizeof(ecs_entity_t);
+        if (!size) {
+            continue;
+        }
+
+        void *data = ecs_vector_first(columns[c].data);
+        for (i = 0; i < move_count; i ++) {
+            memcpy(ECS_OFFSET(data, size * moves[i].dst),
+                ECS_OFFSET(data, size * moves[i].src), size);
+        }
+
+        ecs_vector_params_t params = {
+            .element_size = size,
+            .alignment = columns[c].alignment
+        };
+        ecs_vector_set_count(&columns[c].data, &params, new_count);
+    }
+
+    /* Update the entity index for the entities that moved */
+    ecs_entity_t *entities = ecs_vector_first(entity_column);
+    for (i = 0; i < move_count; i ++) {
+        uint32_t dst = moves[i].dst;
+        move_entity_row(world, stage, table, entities[dst], dst + 1);
+    }
+
+    ecs_os_free(moves);
+
+    if (!world->in_progress && !new_count) {
+        activate_table(world, table, 0, false);
+    }
+}
+
 uint32_t ecs_table_grow(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -342,32 +838,27 @@ uint32_t ecs_table_grow(
         e[i] = first_entity + i;
     }
 
-    bool reallocd = false;
-
     /* Add elements to each column array */
     for (i = 1; i < column_count + 1; i ++) {
-        ecs_vector_params_t params = {.element_size = columns[i].size};
+        ecs_vector_params_t params = {
+            .element_size = columns[i].size,
+            .alignment = columns[i].alignment
+        };
         if (!params.element_size) {
             continue;
         }
-        void *old_vector = columns[i].data;
 
         ecs_vector_addn(&columns[i].data, &params, count);
-
-        if (old_vector != columns[i].data) {
-            reallocd = true;
-        }
     }
 
     uint32_t row_count = ecs_vector_count(columns[0].data);
+
+    mark_columns_changed(world, table, columns);
+
     if (!world->in_progress && row_count == count) {
         activate_table(world, table, 0, true);
     }
 
-    if (reallocd && table->columns == columns) {
-        world->should_resolve = true;
-    }
-
     /* Return index of first added entity */
     return row_count - count + 1;
 }
@@ -393,7 +884,10 @@ int16_t ecs_table_dim(
         uint32_t column_size = columns[i].size;
 
         if (column_size) {
-            ecs_vector_params_t params = {.element_size = column_size};
+            ecs_vector_params_t params = {
+                .element_size = column_size,
+                .alignment = columns[i].alignment
+            };
             uint32_t size = ecs_vector_set_size(&columns[i].data, &params, count);
             ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
             (void)size;
@@ -437,11 +931,11 @@ void ecs_table_swap(
     
     /* Get pointers to records in entity index */
     if (!row_ptr_1) {
-        row_ptr_1 = ecs_map_get_ptr(stage->entity_index, e1);
+        row_ptr_1 = ecs_ei_get(stage->entity_index, e1);
     }
 
     if (!row_ptr_2) {
-        row_ptr_2 = ecs_map_get_ptr(stage->entity_index, e2);
+        row_ptr_2 = ecs_ei_get(stage->entity_index, e2);
     }
 
     /* Swap entities */
@@ -486,12 +980,12 @@ void ecs_table_move_back_and_swap(
         ecs_entity_t cur = entities[row + i];
         entities[row + i - 1] = cur;
 
-        ecs_row_t *row_ptr = ecs_map_get_ptr(stage->entity_index, cur);
+        ecs_row_t *row_ptr = ecs_ei_get(stage->entity_index, cur);
         row_ptr->index = row + i;
     }
 
     entities[row + count - 1] = e;
-    ecs_row_t *row_ptr = ecs_map_get_ptr(stage->entity_index, e);
+    ecs_row_t *row_ptr = ecs_ei_get(stage->entity_index, e);
     row_ptr->index = row + count;
 
     /* Move back and swap columns */
@@ -549,7 +1043,7 @@ void ecs_table_merge(
     uint32_t i;
     for(i = 0; i < old_count; i ++) {
         ecs_row_t row = {.type = new_type, .index = i + new_count};
-        ecs_map_set(world->main_stage.entity_index, old_entities[i], &row);
+        ecs_ei_set(world->main_stage.entity_index, old_entities[i], &row);
     }
 
     if (!new_table) {
@@ -566,6 +1060,8 @@ void ecs_table_merge(
         return;
     }
 
+    mark_columns_changed(world, new_table, new_columns);
+
     for (i_new = 0; i_new <= new_component_count; ) {
         if (i_old == old_component_count) {
             break;
@@ -605,7 +1101,10 @@ void ecs_table_merge(
                 ecs_vector_t *dst = new_columns[i_new].data;
                 ecs_vector_t *src = old_columns[i_old].data;
 
-                ecs_vector_params_t params = {.element_size = size};
+                ecs_vector_params_t params = {
+                    .element_size = size,
+                    .alignment = new_columns[i_new].alignment
+                };
                 ecs_vector_set_count(&dst, &params, new_count + old_count);
                 
                 void *dst_ptr = ecs_vector_first(dst);
@@ -4,22 +4,12 @@ const ecs_vector_params_t char_arr_params = {
     .element_size = sizeof(char)
 };
 
-const ecs_vector_params_t type_node_params = {
-    .element_size = sizeof(ecs_type_node_t)
-};
-
-const ecs_vector_params_t link_params = {
-    .element_size = sizeof(ecs_type_link_t*)
-};
-
 static
 ecs_type_t find_or_create_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
-    ecs_type_node_t *root,
     ecs_entity_t *array,
     uint32_t count,
-    bool create,
     bool normalized);
 
 /** Parse callback that adds type to type identifier for ecs_new_type */
@@ -106,18 +96,16 @@ int compare_handle(
     return e1 > e2 ? 1 : e1 < e2 ? -1 : 0;
 }
 
-/** Hash array of handles */
+/** Hash array of handles. The element count is stored in the upper 32 bits so
+ * that types of different lengths never collide. */
 static
-uint32_t hash_array(
+uint64_t hash_type(
     ecs_entity_t* array,
     uint32_t count)
 {
     uint32_t hash = 0;
-    uint32_t i;
-    for (i = 0; i < count; i ++) {
-        ecs_hash(&array[i], sizeof(ecs_entity_t), &hash);
-    }
-    return hash;
+    ecs_hash(array, count * sizeof(ecs_entity_t), &hash);
+    return ((uint64_t)count << 32) | hash;
 }
 
 static
@@ -155,16 +143,60 @@ ecs_entity_t split_entity_id(
     return id;
 }
 
+/* Types created by the type registry store a bitset signature directly after
+ * their elements, in space that is reserved in the vector, and are marked with
+ * the ECS_TYPE_HAS_SIGNATURE vector flag. Entity e sets bit
+ * (e % TYPE_SIGNATURE_BITS). When a signature is missing the bit of an entity,
+ * the entity is not in the type, which lets include and exclude checks bail
+ * out without scanning the type. */
+#define TYPE_SIGNATURE_BITS (64 * ECS_TYPE_SIGNATURE_WORDS)
+
+static
+const uint64_t* type_signature(
+    ecs_type_t type,
+    ecs_entity_t *array,
+    uint32_t count)
+{
+    if (!(ecs_vector_flags(type) & ECS_TYPE_HAS_SIGNATURE)) {
+        return NULL;
+    }
+
+    return &array[count];
+}
+
+static
+bool signature_has_entity(
+    const uint64_t *sig,
+    ecs_entity_t entity)
+{
+    uint32_t bit = (entity & ECS_ENTITY_MASK) % TYPE_SIGNATURE_BITS;
+    return (sig[bit / 64] & ((uint64_t)1 << (bit % 64))) != 0;
+}
+
 static
 ecs_type_t ecs_type_from_array(
     ecs_entity_t *array,
     uint32_t count)
 {
-    ecs_vector_t *vector = ecs_vector_new(&handle_arr_params, count);
+    /* The signature is not part of the type, and is not included in the
+     * element count. */
+    ecs_vector_t *vector = ecs_vector_new(
+        &handle_arr_params, count + ECS_TYPE_SIGNATURE_WORDS);
     ecs_vector_set_count(&vector, &handle_arr_params, count);
     ecs_entity_t *vector_first = ecs_vector_first(vector);
     memcpy(vector_first, array, sizeof(ecs_entity_t) * count);
 
+    uint64_t *sig = &vector_first[count];
+    memset(sig, 0, sizeof(uint64_t) * ECS_TYPE_SIGNATURE_WORDS);
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        uint32_t bit = (array[i] & ECS_ENTITY_MASK) % TYPE_SIGNATURE_BITS;
+        sig[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+
+    ecs_vector_set_flags(vector, ECS_TYPE_HAS_SIGNATURE);
+
     return vector;
 }
 
@@ -182,29 +214,9 @@ ecs_type_t ecs_type_from_array(
  * prefabs / containers) become more expensive (O(1) to O(n)).
  * To move this complexity out of the main loop, the algorithm that ensures each
  * entity only occurs once in a type (this function) is only performed when a
- * new type is registered. The result of this operation is that the type tree
- * contains an entry for the non-normalized type which points to the normalized
- * type. This ensures that a type merge can produce a non-normalized array,
- * which when looked up, is guaranteed to return a normalized type.
- * This results in some extra memory usage for extra entries in the type tree.
- * For example, a type [A] may occur multiple times:
- *
- * - [A]
- * - [A, INSTANCEOF|A]
- * - [A, CHILDOF|A]
- * - [A, INSTANCEOF|CHILDOF|A]
- * - [INSTANCEOF|A]
- * - [CHILDOF|A]
- * - [INSTANCEOF|CHILDOF|A]
- *
- * While worst case this could result in a lot of memory overhead, in practice
- * this is manageable. Entities are typically only used in combination with a
- * single flag, and types typically have comparatively low numbers of entities
- * with flags. If in the previous example, "A" would always be used as a prefab,
- * it would only create this entry:
- *
- * - [INSTANCEOF|A]
- */
+ * new type is registered. Only the normalized type is stored in the type index.
+ * A type merge can thus produce a non-normalized array, which when looked up,
+ * is normalized first and is guaranteed to return a normalized type. */
 static
 ecs_type_t ecs_type_from_array_normalize(
     ecs_world_t *world,
@@ -239,7 +251,7 @@ ecs_type_t ecs_type_from_array_normalize(
     }
 
     return find_or_create_type(
-        world, stage, &stage->type_root, dst_array, dst_count, true, true);
+        world, stage, dst_array, dst_count, true);
 }
 
 static
@@ -261,11 +273,41 @@ void mark_parents(
     }   
 }
 
+/** Find a type in the type index. Types are hash-consed: each unique array
+ * of entities is stored only once, keyed by its hash. Collisions are resolved
+ * by probing subsequent keys, which is safe since types are never removed from
+ * the index. If the type is not found, the first free key is returned. */
+static
+ecs_type_t find_type(
+    ecs_world_t *world,
+    ecs_entity_t *array,
+    uint32_t count,
+    uint64_t *key_out)
+{
+    uint64_t key = hash_type(array, count);
+    ecs_type_t type;
+
+    while (ecs_map_has(world->type_index, key, &type)) {
+        if (ecs_vector_count(type) == count && !memcmp(
+            ecs_vector_first(type), array, count * sizeof(ecs_entity_t))) 
+        {
+            return type;
+        }
+
+        key ++;
+    }
+
+    if (key_out) {
+        *key_out = key;
+    }
+
+    return NULL;
+}
+
 static
 ecs_type_t register_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
-    ecs_type_link_t *link,
     ecs_entity_t *array,
     uint32_t count,
     bool normalized)
@@ -287,171 +329,55 @@ ecs_type_t register_type(
         }
     }
 
-    link->type = result;
-
-    if (!stage->last_link) {
-        stage->last_link = world->main_stage.last_link;
-    }
-
-    ecs_assert(stage->last_link != NULL, ECS_INTERNAL_ERROR, NULL);
-
-    stage->last_link->next = link;
-    stage->last_link = link;
-
     ecs_assert(result != NULL, ECS_INTERNAL_ERROR, NULL);
 
-    if (normalized || !has_flags) {
-        /* Only notify systems of normalized type */
-        notify_systems_of_type(world, stage, result);
+    /* Another thread may have registered the same type since the lookup. The
+     * type is created outside of the lock, as normalizing it can create other
+     * types. */
+    uint64_t key = 0;
+    ecs_lock_types(world);
+
+    ecs_type_t existing = find_type(world, array, count, &key);
+    if (existing) {
+        ecs_unlock_types(world);
+        ecs_vector_free((ecs_vector_t*)result);
+        return existing;
     }
-    
-    return result;
-}
-
-static
-ecs_type_t find_type_in_vector(
-    ecs_world_t *world,
-    ecs_stage_t *stage,
-    ecs_vector_t **vector,
-    ecs_entity_t *array,
-    uint32_t count,
-    bool create,
-    bool normalized)
-{
-    uint32_t i, types_count = ecs_vector_count(*vector);
-    ecs_type_link_t **type_array = ecs_vector_first(*vector);
-
-    for (i = 0; i < types_count; i ++) {
-        ecs_type_t type = type_array[i]->type;
-        if (!type) {
-            continue;
-        }
 
-        uint32_t type_count = ecs_vector_count(type);
+    ecs_map_set(world->type_index, key, &result);
 
-        if (type_count != count) {
-            continue;
-        }
+    ecs_type_t *elem = ecs_vector_add(&world->types, &ptr_params);
+    *elem = result;
 
-        ecs_entity_t *type_array = ecs_vector_first(type);
+    /* Only notify systems of normalized type */
+    notify_systems_of_type(world, stage, result);
 
-        uint32_t j;
-        for (j = 0; j < type_count; j ++) {
-            if (type_array[j] != array[j]) {
-                break;
-            }
-        }
-
-        if (j == type_count) {
-            return type;
-        }
-    }
-
-    /* Type has not been found, add it */
-    if (create) {
-        ecs_type_link_t **link = ecs_vector_add(vector, &link_params);
-        *link = ecs_os_calloc(1, sizeof(ecs_type_link_t));
-        ecs_type_t result = register_type(world, stage, *link, array, count, normalized);
-        return result;
-    }
+    ecs_unlock_types(world);
     
-    return NULL;
+    return result;
 }
 
 static
 ecs_type_t find_or_create_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
-    ecs_type_node_t *root,
     ecs_entity_t *array,
     uint32_t count,
-    bool create,
     bool normalized)
 {
-    ecs_type_node_t *node = root;
-    ecs_type_t type = NULL;
-    ecs_entity_t offset = 0;
-    uint32_t i;
-
+    ecs_assert(count != 0, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(count < ECS_MAX_ENTITIES_IN_TYPE, ECS_TYPE_TOO_LARGE, NULL);
 
-    for (i = 0; i < count; i ++) {
-        ecs_entity_t e = array[i];
-        ecs_entity_t rel = e - offset;
-
-        /* Lookup next node in nodes array */
-        if (rel < ECS_TYPE_DB_MAX_CHILD_NODES) {
-            ecs_type_node_t *node_array = NULL;
-
-            if (!node->nodes && create) {
-                /* Create vector */
-                ecs_vector_set_count(&node->nodes, &type_node_params, 
-                    ECS_TYPE_DB_MAX_CHILD_NODES);
-
-                node_array = ecs_vector_first(node->nodes);
-
-                memset(node_array, 0, 
-                    ECS_TYPE_DB_MAX_CHILD_NODES * sizeof(ecs_type_node_t));
-            } else {
-                node_array = ecs_vector_first(node->nodes);
-            }
-            
-            if (node_array) {
-                node = &node_array[rel];
-                type = node->link.type;
-                
-                if (!type && create) {
-                    type = register_type(
-                        world, stage, &node->link, array, i + 1, normalized);
-
-                    ecs_assert(
-                        ecs_vector_count(type) == i + 1, 
-                        ECS_INTERNAL_ERROR, 
-                        NULL);
-                }
-            } else {
-                type = NULL;
-            }
-
-        } else {
-            if (!node->types) {
-                if (create) {
-                    node->types = ecs_os_calloc(
-                        ECS_TYPE_DB_BUCKET_COUNT, sizeof(ecs_vector_t*));
-                } else {
-                    return NULL;
-                }
-            }
-
-            uint32_t hash = hash_array(&array[i], count - i);
-            uint32_t index = hash % ECS_TYPE_DB_BUCKET_COUNT;
-
-            if (!node->types[index]) {
-                if (create) {
-                    node->types[index] = ecs_vector_new(&link_params, 1);
-                } else {
-                    return NULL;
-                }
-            }
-
-            type = find_type_in_vector(
-                world, stage, &node->types[index], array, count, create, 
-                normalized);
+    ecs_lock_types(world);
+    ecs_type_t type = find_type(world, array, count, NULL);
+    ecs_unlock_types(world);
 
-            if (type) {
-                break;
-            }
-
-            if (create) {
-                return NULL;
-            }
-        }
-        
-        offset = e;
+    if (!type) {
+        type = register_type(world, stage, array, count, normalized);
     }
     
-    ecs_assert(!create || type != NULL, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(!create || !normalized || ecs_vector_count(type) == count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(type != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!normalized || ecs_vector_count(type) == count, ECS_INTERNAL_ERROR, NULL);
 
     return type;
 }
@@ -504,30 +430,38 @@ ecs_entity_t ecs_find_entity_in_prefabs(
 
 /* -- Private functions -- */
 
+void ecs_lock_types(
+    ecs_world_t *world)
+{
+    if (world->type_mutex) {
+        ecs_os_mutex_lock(world->type_mutex);
+    }
+}
+
+void ecs_unlock_types(
+    ecs_world_t *world)
+{
+    if (world->type_mutex) {
+        ecs_os_mutex_unlock(world->type_mutex);
+    }
+}
+
 ecs_type_t ecs_type_find_intern(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_entity_t *array,
     uint32_t count)
 {
-    ecs_type_t type = NULL;
+    if (!count) {
+        return NULL;
+    }
 
     if (!stage) {
         stage = &world->main_stage;
     }
 
-    if (stage == &world->main_stage) {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, true, false);
-    } else {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, false, false);
-    }
-
-    if (!type && stage != &world->main_stage) {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, true, false);
-    }
+    /* Types are stored in a single index on the world, regardless of stage */
+    ecs_type_t type = find_or_create_type(world, stage, array, count, false);
 
     ecs_assert(type != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -765,6 +699,29 @@ ecs_entity_t ecs_type_contains(
     uint32_t t1_count = ecs_vector_count(type_1);
     uint32_t t2_count = ecs_vector_count(type_2);
 
+    /* Test signatures before scanning the types. Prefabs are stored at the end
+     * of a type, as ECS_INSTANCEOF is the highest bit of an entity. If type_1
+     * has prefabs and prefabs must be matched, components can come from a
+     * prefab, and the signature of type_1 cannot be used to reject a match. */
+    bool t1_prefab = t1_count && (t1_array[t1_count - 1] & ECS_INSTANCEOF);
+    if (!match_prefab || !t1_prefab) {
+        const uint64_t *sig_1 = type_signature(type_1, t1_array, t1_count);
+        const uint64_t *sig_2 = type_signature(type_2, t2_array, t2_count);
+
+        if (sig_1 && sig_2) {
+            uint64_t all = 0, any = 0;
+            int i;
+            for (i = 0; i < ECS_TYPE_SIGNATURE_WORDS; i ++) {
+                all |= sig_2[i] & ~sig_1[i];
+                any |= sig_2[i] & sig_1[i];
+            }
+
+            if (match_all ? all != 0 : any == 0) {
+                return 0;
+            }
+        }
+    }
+
     for (i_2 = 0; i_2 < t2_count; i_2 ++) {
         ecs_entity_t e2 = t2_array[i_2] & ECS_ENTITY_MASK;
 
@@ -821,6 +778,13 @@ bool ecs_type_has_entity_intern(
     ecs_entity_t *array = ecs_vector_first(type);
     uint32_t i, count = ecs_vector_count(type);
 
+    if (count && (!match_prefab || !(array[count - 1] & ECS_INSTANCEOF))) {
+        const uint64_t *sig = type_signature(type, array, count);
+        if (sig && !signature_has_entity(sig, entity)) {
+            return false;
+        }
+    }
+
     for (i = 0; i < count; i++) {
         ecs_entity_t e = array[i];
         if ((e == entity) || (e & ECS_ENTITY_MASK) == entity) {
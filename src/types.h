@@ -38,7 +38,49 @@
 #define ECS_MAP_INITIAL_NODE_COUNT (4)
 #define ECS_TABLE_INITIAL_ROW_COUNT (0)
 #define ECS_SYSTEM_INITIAL_TABLE_COUNT (0)
-#define ECS_MAX_JOBS_PER_WORKER (16)
+#define ECS_JOBS_PER_THREAD (4)
+#define ECS_THREAD_SPIN_TIME (0.00005)
+
+/* When the slowest job of a system takes this much longer than the average job,
+ * the system is split again based on the measured cost of its jobs. Jobs that
+ * take less than the minimum time are not considered, as their measurements 
+ * are dominated by noise. */
+#define ECS_JOB_IMBALANCE_THRESHOLD (1.5)
+#define ECS_JOB_MIN_MEASURED_TIME (0.00001)
+
+/* Default minimum number of rows in a job (see ecs_set_job_min_rows) */
+#define ECS_JOB_MIN_ROWS (64)
+
+/* Minimum number of entities with staged data in a stage before the data is
+ * copied to the main stage by worker threads */
+#define ECS_MERGE_MIN_PARALLEL (1024)
+
+/* Maximum number of distinct staged types that are tested against the systems
+ * of the next phase before a merge is postponed. If stages contain more types,
+ * they are always merged. */
+#define ECS_PIPELINE_MAX_STAGED_TYPES (64)
+
+/* Number of entries in a page of the entity index. Must be a power of two. */
+#define ECS_ENTITY_PAGE_SIZE (1024)
+
+/* Components with ids below this value are looked up in a table with a direct
+ * index. Columns for higher ids are looked up in a map. */
+#define ECS_HI_COMPONENT_ID (256)
+
+/* Number of 64bit words in the bitset signature of a type. Entity e sets bit
+ * (e % (64 * ECS_TYPE_SIGNATURE_WORDS)) in the signature. */
+#define ECS_TYPE_SIGNATURE_WORDS (2)
+
+/* Vector flag of types that store a signature after their elements */
+#define ECS_TYPE_HAS_SIGNATURE (1)
+
+/* Alignment of the component data in table columns. The allocation of a column
+ * is padded to a multiple of the alignment, so that vectorized loops over the
+ * data returned by ecs_column do not need a scalar tail. Must be a power of
+ * two. Components that declare a larger alignment use their own alignment. */
+#ifndef ECS_COLUMN_ALIGNMENT
+#define ECS_COLUMN_ALIGNMENT (64)
+#endif
 
 /* This is _not_ the max number of entities that can be of a given type. This 
  * constant defines the maximum number of components, prefabs and parents can be
@@ -141,12 +183,40 @@ typedef struct ecs_system_column_t {
 struct ecs_table_column_t {
     ecs_vector_t *data;              /* Column data */
     uint16_t size;                   /* Column size (saves component lookups) */
+    uint16_t alignment;              /* Alignment of column data */
+    uint32_t change_tick;            /* Tick at which column was last written */
 };
 
 #define EcsTableIsStaged  (1)
 #define EcsTableIsPrefab (2)
 #define EcsTableHasPrefab (4)
 #define EcsTableHasBuiltins (8)
+#define EcsTableWasEmpty (16)
+#define EcsTableIsReleased (32)
+
+/** Component column that is copied when an entity moves between tables */
+typedef struct ecs_table_move_t {
+    uint16_t src;                     /* Column in source table */
+    uint16_t dst;                     /* Column in destination table */
+    uint16_t size;                    /* Size of component */
+} ecs_table_move_t;
+
+/** Slot in the hashed lookup of component columns in a table */
+typedef struct ecs_table_slot_t {
+    ecs_entity_t component;           /* Component (0 if slot is empty) */
+    int16_t index;                    /* Index of component in table type */
+} ecs_table_slot_t;
+
+/** Cached transition from a table to the table that is the result of adding
+ * or removing a type. Edges are created the first time an entity makes the
+ * transition, so that subsequent adds and removes don't have to merge types
+ * and look up the destination table. */
+typedef struct ecs_table_edge_t {
+    ecs_type_t type;                  /* Type of destination table */
+    ecs_table_t *table;               /* Destination table (NULL if empty) */
+    ecs_table_move_t *moves;          /* Components to copy */
+    uint16_t move_count;              /* Number of components to copy */
+} ecs_table_edge_t;
 
 /** A table is the Flecs equivalent of an archetype. Tables store all entities
  * with a specific set of components. Tables are automatically created when an
@@ -155,15 +225,45 @@ struct ecs_table_column_t {
 struct ecs_table_t {
     ecs_table_column_t *columns;      /* Columns storing components of array */
     ecs_vector_t *frame_systems;      /* Frame systems matched with table */
+    ecs_vector_t *queries;            /* Queries matched with table */
     ecs_type_t type;                  /* Identifies table type in type_index */
+    ecs_map_t *add_edges;             /* Edges to tables with added types */
+    ecs_map_t *remove_edges;          /* Edges to tables with removed types */
+    int16_t *lo_columns;              /* Type index of components < lo_count */
+    ecs_table_slot_t *hi_columns;     /* Hashed type index of other components */
+    uint16_t lo_count;                /* Number of elements in lo_columns */
+    uint16_t hi_mask;                 /* Number of elements in hi_columns - 1 */
     uint32_t flags;                   /* Flags for testing table properties */
 };
 
-/** Cached reference to a component in an entity */
+/** Storage for a tag that is not stored in tables (see ecs_set_sparse). The
+ * entities that have the tag are stored in a dense array, and a map stores the
+ * index of each entity in the dense array. Adding or removing the tag does not
+ * move the entity to another table. */
+typedef struct ecs_sparse_set_t {
+    ecs_entity_t component;           /* Tag stored in the set */
+    ecs_map_t *index;                 /* Index of entity in dense array */
+    ecs_vector_t *dense;              /* Entities that have the tag */
+} ecs_sparse_set_t;
+
+/** A query caches the tables that match a filter. Like column systems, a query
+ * stores non-empty and empty tables in separate arrays, so that iterating a
+ * query does not have to visit empty tables. */
+struct ecs_query_t {
+    ecs_world_t *world;               /* World the query is created for */
+    ecs_filter_t filter;              /* Filter that is matched with tables */
+    ecs_vector_t *tables;             /* Non-empty tables matched with query */
+    ecs_vector_t *inactive_tables;    /* Empty tables matched with query */
+};
+
+/** Cached reference to a component in an entity. A reference stores the table
+ * column and row that contain the component instead of a pointer to the
+ * component, so that it remains valid when the column data is reallocated. */
 struct ecs_reference_t {
-    ecs_entity_t entity;
-    ecs_entity_t component;
-    void *cached_ptr;
+    ecs_entity_t entity;              /* Entity that is referenced */
+    ecs_entity_t component;           /* Component that is referenced */
+    ecs_table_column_t *column;       /* Column that stores the component */
+    uint32_t row;                     /* Row in column (starting from 1) */
 };
 
 /** Type containing data for a table matched with a system */
@@ -204,6 +304,8 @@ typedef struct EcsSystem {
     ecs_type_t and_from_owned;     /* Which components are required from entity */
     ecs_type_t and_from_shared;    /* Which components are required from entity */
     ecs_type_t and_from_system;    /* Used to auto-add components to system */
+    ecs_vector_t *and_sparse;      /* Sparse sets of required SELF tags */
+    ecs_vector_t *not_sparse;      /* Sparse sets of excluded SELF tags */
     
     EcsSystemKind kind;            /* Kind of system */
     int32_t cascade_by;            /* CASCADE column index */
@@ -253,11 +355,18 @@ typedef struct EcsSystem {
  * time the system is evaluated but not ran, the delta_time is added to the 
  * time_passed member, until it exceeds 'period'. In that case, the system is
  * ran, and 'time_passed' is decreased by 'period'. 
+ *
+ * The 'read_set' and 'write_set' members contain the components that the 
+ * system reads and writes, as derived from the [in] and [out] annotations in
+ * the signature. The worker scheduler uses these to determine which systems in
+ * a phase can safely run at the same time.
  */
 typedef struct EcsColSystem {
     EcsSystem base;
     ecs_entity_t entity;                  /* Entity id of system, used for ordering */
     ecs_vector_t *jobs;                   /* Jobs for this system */
+    uint32_t split_count;                 /* Number of jobs before alignment */
+    uint32_t split_min_rows;              /* Minimum rows used for alignment */
     ecs_vector_t *tables;                 /* Vector with matched tables */
     ecs_vector_t *inactive_tables;        /* Inactive tables */
     ecs_on_demand_out_t *on_demand;       /* Keep track of [out] column refs */
@@ -266,10 +375,16 @@ typedef struct EcsColSystem {
     ecs_vector_params_t column_params;    /* Parameters for table_columns */
     ecs_vector_params_t component_params; /* Parameters for components */
     ecs_vector_params_t ref_params;       /* Parameters for refs */
+    ecs_type_t read_set;                  /* Components read by system */
+    ecs_type_t write_set;                 /* Components written by system */
+    uint32_t batch;                       /* Batch in phase in which system runs */
     float period;                         /* Minimum period inbetween system invocations */
     float time_passed;                    /* Time passed since last invocation */
+    uint32_t change_tick;                 /* Tick of last invocation */
+    uint32_t prev_change_tick;            /* Tick of invocation before last */
     bool enabled_by_demand;               /* Is system enabled by on demand systems */
     bool enabled_by_user;                /* Is system enabled by user */
+    bool changed_only;                    /* Skip tables with unchanged [in] columns */
 } EcsColSystem;
 
 /** A row system is a system that is ran on 1..n entities for which a certain 
@@ -289,49 +404,53 @@ typedef struct ecs_row_t {
     int32_t index;                /* Index of the entity in its table */
 } ecs_row_t;
 
-#define ECS_TYPE_DB_MAX_CHILD_NODES (256)
-#define ECS_TYPE_DB_BUCKET_COUNT (256)
+/** Sparse set that stores the ecs_row_t of each entity (see entity_index.c) */
+typedef struct ecs_ei_t ecs_ei_t;
 
-/** The ecs_type_node_t type is a node in a hierarchical structure that allows
- * for quick lookups of types. A node represents a type, and its direct children
- * represent types with one additional entity. For example, given a node [A],
- * [A, B] would be a child node.
- * 
- * Child nodes are looked up directly using the entity id. For example, node [A]
- * will be stored at root.nodes[A]. Children entity ids are offset by their 
- * parent, such that [A, B] is stored at root.nodes[A].nodes[B - A].
- * 
- * If the offset exceeds ECS_TYPE_DB_MAX_CHILD_NODES, the type will be stored in
- * the types map. This map is keyed by the hash of the type relative to its
- * parent. For example, the hash for type [A, B, C] will be computed on [B, C]
- * if its parent is [A]. */
-typedef struct ecs_type_link_t {
-    ecs_type_t type;                /* type of current node */
-    struct ecs_type_link_t *next;   /* next link (for iterating linearly) */
-} ecs_type_link_t;
-
-typedef struct ecs_type_node_t {
-    ecs_vector_t *nodes;    /* child nodes - <ecs_entity_t, ecs_type_node_t> */
-    ecs_vector_t **types;   /* child types w/large entity offsets - <hash, vector<ecs_type_link_t>> */
-    ecs_type_link_t link;     
-} ecs_type_node_t;
+typedef struct ecs_ei_iter_t {
+    ecs_ei_t *ei;
+    uint32_t index;
+    ecs_map_iter_t hi_iter;
+} ecs_ei_iter_t;
 
 /** A stage is a data structure in which delta's are stored until it is safe to
  * merge those delta's with the main world stage. A stage allows flecs systems
  * to arbitrarily add/remove/set components and create/delete entities while
  * iterating. Additionally, worker threads have their own stage that lets them
  * mutate the state of entities without requiring locks. */
+/** Kinds of operations recorded in a command log */
+typedef enum ecs_op_kind_t {
+    EcsOpAddRemove,
+    EcsOpSet,
+    EcsOpDelete
+} ecs_op_kind_t;
+
+/** Operation recorded by a worker thread in deferred mode */
+typedef struct ecs_op_t {
+    ecs_op_kind_t kind;                 /* Kind of operation */
+    ecs_entity_t entity;                /* Entity to apply operation to */
+    union {
+        struct {
+            ecs_type_t to_add;          /* Components to add */
+            ecs_type_t to_remove;       /* Components to remove */
+        } add_remove;
+        struct {
+            ecs_entity_t component;     /* Component to set */
+            uint32_t size;              /* Size of component value */
+            uint32_t offset;            /* Offset of value in op_data */
+        } set;
+    } is;
+} ecs_op_t;
+
 typedef struct ecs_stage_t {
     /* If this is not main stage, 
      * changes to the entity index 
      * are buffered here */
-    ecs_map_t *entity_index;       /* Entity lookup table for (table, row) */
+    ecs_ei_t *entity_index;        /* Entity lookup table for (table, row) */
 
     /* If this is not a thread
      * stage, these are the same
      * as the main stage */
-    ecs_type_node_t type_root;     /* Hierarchical type store (& first link) */
-    ecs_type_link_t *last_link;    /* Link to last registered type */
     ecs_chunked_t *tables;         /* Tables created while >1 threads running */
     ecs_map_t *table_index;        /* Lookup table by type */
 
@@ -340,6 +459,7 @@ typedef struct ecs_stage_t {
      * not on the main stage */
     ecs_map_t *data_stage;         /* Arrays with staged component values */
     ecs_map_t *remove_merge;       /* All removed components before merge */
+    ecs_vector_t *deleted;         /* Entities deleted while in progress */
 
     /* Keep track of changes so
      * code knows when entity
@@ -348,6 +468,15 @@ typedef struct ecs_stage_t {
     ecs_type_t from_type;
     ecs_type_t to_type;
     
+    /* Command log of worker
+     * stages in deferred mode */
+    ecs_vector_t *ops;             /* Recorded operations (ecs_op_t) */
+    ecs_vector_t *op_data;         /* Component values of set operations */
+
+    /* Sparse tags added or
+     * removed while in progress */
+    ecs_vector_t *sparse_ops;      /* Add/remove operations (ecs_op_t) */
+
     /* Is entity range checking enabled? */
     bool range_check_enabled;
 } ecs_stage_t;
@@ -368,11 +497,24 @@ typedef struct ecs_entity_info_t {
 } ecs_entity_info_t;
 
 /** A type describing a unit of work to be executed by a worker thread. */ 
+/** Staged data of an entity that is copied to the main stage during a merge */
+typedef struct ecs_merge_item_t {
+    ecs_entity_t entity;                /* Merged entity */
+    ecs_table_t *table;                 /* Table of entity in main stage */
+    int32_t index;                      /* Row of entity in main stage */
+    ecs_table_t *staged_table;          /* Table of entity in stage */
+    ecs_table_column_t *staged_columns; /* Columns with staged data */
+    int32_t staged_index;               /* Row of entity in staged columns */
+} ecs_merge_item_t;
+
 typedef struct ecs_job_t {
     ecs_entity_t system;          /* System handle */
     EcsColSystem *system_data;    /* System to run */
+    ecs_merge_item_t *merge_items;/* Staged data to copy (merge jobs only) */
     uint32_t offset;              /* Start index in row chunk */
     uint32_t limit;               /* Total number of rows to process */
+    double time_spent;            /* Time spent in last run of job */
+    bool is_task;                 /* Tasks are never stolen by other threads */
 } ecs_job_t;
 
 /** A type desribing a worker thread. When a system is invoked by a worker
@@ -381,23 +523,34 @@ typedef struct ecs_job_t {
  * into the flecs API, the API functions are able to tell whether this is an
  * ecs_thread_t or an ecs_world_t by looking at the 'magic' number. This allows the
  * API to transparently resolve the stage to which updates should be written,
- * without requiring different API calls when working in multi threaded mode. */
+ * without requiring different API calls when working in multi threaded mode.
+ *
+ * Each thread owns a queue with the jobs that were assigned to it. Jobs are
+ * only added to queues while worker threads are waiting, which means that while
+ * jobs are running the queues are only consumed. A job is taken from a queue by
+ * atomically incrementing its head, which lets a thread take jobs from its own
+ * queue, and steal jobs from the queues of other threads once it runs out of
+ * jobs, without locking. Jobs that must run on a specific thread (tasks) are
+ * stored separately, and are never stolen. */
 typedef struct ecs_thread_t {
     uint32_t magic;                           /* Magic number to verify thread pointer */
-    uint32_t job_count;                       /* Number of jobs scheduled for thread */
+    int job_head;                             /* Index of next job to take from queue */
     ecs_world_t *world;                       /* Reference to world */
-    ecs_job_t *jobs[ECS_MAX_JOBS_PER_WORKER]; /* Array with jobs */
+    ecs_vector_t *jobs;                       /* Queue with jobs (ecs_job_t*) */
+    ecs_vector_t *tasks;                      /* Jobs that run on this thread (ecs_job_t*) */
     ecs_stage_t *stage;                       /* Stage for thread */
     ecs_os_thread_t thread;                   /* Thread handle */
+    ecs_vector_t *cpus;                       /* CPUs thread is pinned to (uint32_t) */
     uint16_t index;                           /* Index of thread */
 } ecs_thread_t;
 
 /* World snapshot */
 struct ecs_snapshot_t {
-    ecs_map_t *entity_index;
+    ecs_ei_t *entity_index;
     ecs_chunked_t *tables;
     ecs_entity_t last_handle;
     ecs_filter_t filter;
+    ecs_map_t *sparse_sets;
 };
 
 /** The world stores and manages all ECS data. An application can have more than
@@ -446,6 +599,13 @@ struct ecs_world_t {
     
     ecs_map_t *prefab_parent_index;   /* Index to find flag for prefab parent */
     ecs_map_t *type_handles;          /* Handles to named types */
+    ecs_map_t *type_index;            /* Index to find type by type hash */
+    ecs_map_t *component_tables;      /* Index to find tables by component */
+    ecs_vector_t *prefab_tables;      /* Tables that can inherit components */
+    ecs_vector_t *queries;            /* Queries matched with new tables */
+    ecs_vector_t *types;              /* All types, in order of creation */
+    ecs_map_t *sparse_sets;           /* Sparse storage for tags (see ecs_set_sparse) */
+    ecs_type_t sparse_type;           /* Tags that are stored in sparse sets */
 
 
     /* -- Staging -- */
@@ -458,12 +618,16 @@ struct ecs_world_t {
     /* -- Multithreading -- */
 
     ecs_vector_t *worker_threads;    /* Worker threads */
-    ecs_os_cond_t thread_cond;       /* Signal that worker threads can start */
-    ecs_os_mutex_t thread_mutex;     /* Mutex for thread condition */
-    ecs_os_cond_t job_cond;          /* Signal that worker thread job is done */
-    ecs_os_mutex_t job_mutex;        /* Mutex for protecting job counter */
-    uint32_t jobs_finished;          /* Number of jobs finished */
-    uint32_t threads_running;        /* Number of threads running */
+    ecs_os_barrier_t thread_barrier; /* Synchronizes main and worker threads */
+    ecs_os_mutex_t type_mutex;       /* Protects type index when threaded */
+    float thread_spin_time;          /* Time spent spinning on barrier */
+    uint32_t job_min_rows;           /* Minimum number of rows in a job */
+    ecs_vector_t *thread_affinity;   /* CPU sets of threads (ecs_vector_t*) */
+    ecs_vector_t *merge_items;       /* Staged data copied by merge jobs */
+    ecs_vector_t *merge_jobs;        /* Jobs that copy staged data */
+    bool reserve_main_thread;        /* Don't run jobs on main thread */
+    bool deferred_mode;              /* Worker threads record operations */
+    bool pipelined_merge;            /* Postpone merges when possible */
 
     ecs_entity_t last_handle;        /* Last issued handle */
     ecs_entity_t min_handle;         /* First allowed handle */
@@ -493,8 +657,21 @@ struct ecs_world_t {
     double frame_time_total;      /* Total time spent in processing a frame */
     double system_time_total;     /* Total time spent in periodic systems */
     double merge_time_total;      /* Total time spent in merges */
+    uint32_t merge_count_total;   /* Total number of merges */
+    uint32_t merge_skip_count_total; /* Total number of postponed merges */
     double world_time_total;      /* Time elapsed since first frame */
     uint32_t frame_count_total;   /* Total number of frames */
+    uint64_t reclaimed_bytes_total; /* Total memory released by compaction */
+
+
+    /* -- Compaction -- */
+
+    uint32_t compact_interval;    /* Frames between compactions (0 = never) */
+
+
+    /* -- Change tracking -- */
+
+    uint32_t change_tick;         /* Tick assigned to writes to table columns */
 
 
     /* -- Settings from command line arguments -- */
@@ -506,6 +683,7 @@ struct ecs_world_t {
     /* -- World state -- */
 
     bool valid_schedule;          /* Is job schedule still valid */
+    bool valid_batches;           /* Are batches of systems in phases valid */
     bool quit_workers;            /* Signals worker threads to quit */
     bool in_progress;             /* Is world being progressed */
     bool is_merging;              /* Is world currently being merged */
@@ -514,7 +692,7 @@ struct ecs_world_t {
     bool measure_system_time;     /* Time spent by each system */
     bool should_quit;             /* Did a system signal that app should quit */
     bool should_match;            /* Should tablea be rematched */
-    bool should_resolve;          /* If a table reallocd, resolve system refs */
+    bool should_resolve;          /* If entities moved, resolve system refs */
 }; 
 
 
@@ -530,5 +708,6 @@ extern const ecs_vector_params_t matched_table_params;
 extern const ecs_vector_params_t matched_column_params;
 extern const ecs_vector_params_t reference_params;
 extern const ecs_vector_params_t ptr_params;
+extern const ecs_vector_params_t table_index_params;
 
 #endif
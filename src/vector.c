@@ -1,26 +1,97 @@
 #include "types.h"
 
+/* The header is 16 bytes, so that the buffer of a vector that is allocated
+ * with malloc is 16 byte aligned, which is what most SIMD types require. Vectors
+ * with a larger alignment (see ecs_vector_params_t::alignment) are allocated
+ * with enough space to shift the header so that the buffer that immediately
+ * follows it is aligned. The offset of the header from the start of the
+ * allocation is stored so the allocation can be resized and freed. */
 struct ecs_vector_t {
     uint32_t count;
     uint32_t size;
-
-    /* Aligns the array to 16 bytes. This prevents issues with component types
-     * that are 16 bit aligned, such as some SIMD compiler intrinsics. This is
-     * a quick hack, but should in the long term be solved by using a separate
-     * datastructure for any collection that can contain user-defined types. */
-    uint64_t dummy;
+    uint32_t offset;    /* Offset of the header from start of allocation */
+    uint32_t flags;     /* Application defined flags, not copied */
 };
 
 #define ARRAY_BUFFER(array) ECS_OFFSET(array, sizeof(ecs_vector_t))
+#define ARRAY_ALLOC(array) ECS_OFFSET(array, -(intptr_t)(array)->offset)
+#define DEFAULT_ALIGNMENT (16)
+
+/** Number of bytes to allocate for a buffer of the specified size. The buffer
+ * of an aligned vector is padded to a multiple of the alignment, so that loops
+ * that process the buffer in blocks of the alignment can read past the last
+ * element without reading past the allocation. */
+static
+uint32_t alloc_size(
+    uint32_t alignment,
+    uint32_t size)
+{
+    if (alignment <= DEFAULT_ALIGNMENT) {
+        return sizeof(ecs_vector_t) + size;
+    }
+
+    size = (size + alignment - 1) & ~(alignment - 1);
+    return sizeof(ecs_vector_t) + size + alignment;
+}
+
+/** Offset the header in an allocation so that the buffer is aligned */
+static
+uint32_t align_offset(
+    void *ptr,
+    uint32_t alignment)
+{
+    if (alignment <= DEFAULT_ALIGNMENT) {
+        return 0;
+    }
+
+    uintptr_t buffer = (uintptr_t)ptr + sizeof(ecs_vector_t);
+    return (alignment - (buffer & (alignment - 1))) & (alignment - 1);
+}
 
 /** Resize the array buffer */
 static
 ecs_vector_t* resize(
     ecs_vector_t *array,
+    const ecs_vector_params_t *params,
     uint32_t size)
 {
-    ecs_vector_t *result = ecs_os_realloc(array, sizeof(ecs_vector_t) + size);
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, 0);
+    uint32_t alignment = params->alignment;
+    uint32_t old_offset = array->offset;
+
+    ecs_assert(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER, NULL);
+
+    if (alignment <= DEFAULT_ALIGNMENT && !old_offset) {
+        ecs_vector_t *result = ecs_os_realloc(array, alloc_size(0, size));
+        ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, 0);
+        return result;
+    }
+
+    /* Elements that need to be preserved when the header is shifted */
+    uint32_t used = array->count * params->element_size;
+    if (used > size) {
+        used = size;
+    }
+
+    /* Make sure the elements at the old offset are not truncated */
+    uint32_t alloc = alloc_size(alignment, size);
+    if (alloc < old_offset + sizeof(ecs_vector_t) + used) {
+        alloc = old_offset + sizeof(ecs_vector_t) + used;
+    }
+
+    void *ptr = ecs_os_realloc(ARRAY_ALLOC(array), alloc);
+    ecs_assert(ptr != NULL, ECS_OUT_OF_MEMORY, 0);
+
+    /* The realloc can return memory with a different alignment, in which case
+     * the header and buffer have to be moved to their new aligned position */
+    uint32_t offset = align_offset(ptr, alignment);
+    ecs_vector_t *result = ECS_OFFSET(ptr, offset);
+    if (offset != old_offset) {
+        memmove(result, ECS_OFFSET(ptr, old_offset), 
+            sizeof(ecs_vector_t) + used);
+    }
+
+    result->offset = offset;
+
     return result;
 }
 
@@ -32,19 +103,30 @@ ecs_vector_t* ecs_vector_new(
     uint32_t size)
 {
     ecs_assert(params->element_size != 0, ECS_INTERNAL_ERROR, NULL);
+
+    uint32_t alignment = params->alignment;
+    ecs_assert(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER, NULL);
     
-    ecs_vector_t *result = ecs_os_malloc(sizeof(ecs_vector_t) + size * params->element_size);
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+    void *ptr = ecs_os_malloc(
+        alloc_size(alignment, size * params->element_size));
+    ecs_assert(ptr != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    uint32_t offset = align_offset(ptr, alignment);
+    ecs_vector_t *result = ECS_OFFSET(ptr, offset);
 
     result->count = 0;
     result->size = size;
+    result->offset = offset;
+    result->flags = 0;
     return result;
 }
 
 void ecs_vector_free(
     ecs_vector_t *array)
 {
-    ecs_os_free(array);
+    if (array) {
+        ecs_os_free(ARRAY_ALLOC(array));
+    }
 }
 
 void ecs_vector_clear(
@@ -80,7 +162,7 @@ void* ecs_vector_addn(
             }
         }
 
-        array = resize(array, size * element_size);
+        array = resize(array, params, size * element_size);
         array->size = size;
         *array_inout = array;
     }
@@ -220,7 +302,7 @@ void ecs_vector_reclaim(
 
     if (count < size) {
         size = count;
-        array = resize(array, size * element_size);
+        array = resize(array, params, size * element_size);
         array->size = size;
         *array_inout = array;
     }
@@ -263,7 +345,7 @@ uint32_t ecs_vector_set_size(
         }
 
         if (result < size) {
-            array = resize(array, size * params->element_size);
+            array = resize(array, params, size * params->element_size);
             array->size = size;
             *array_inout = array;
             result = size;
@@ -374,13 +456,32 @@ void ecs_vector_memory(
     ecs_assert(array->size >= array->count, ECS_INTERNAL_ERROR, NULL);
 
     if (allocd) {
-        *allocd += array->size * params->element_size + sizeof(ecs_vector_t);
+        *allocd += alloc_size(
+            params->alignment, array->size * params->element_size);
     }
     if (used) {
         *used += array->count * params->element_size;
     }
 }
 
+void ecs_vector_set_flags(
+    ecs_vector_t *array,
+    uint32_t flags)
+{
+    ecs_assert(array != NULL, ECS_INVALID_PARAMETER, NULL);
+    array->flags = flags;
+}
+
+uint32_t ecs_vector_flags(
+    const ecs_vector_t *array)
+{
+    if (!array) {
+        return 0;
+    }
+
+    return array->flags;
+}
+
 ecs_vector_t* ecs_vector_copy(
     const ecs_vector_t *src,
     const ecs_vector_params_t *params)
@@ -390,6 +491,8 @@ ecs_vector_t* ecs_vector_copy(
     }
 
     ecs_vector_t *dst = ecs_vector_new(params, src->size);
-    memcpy(dst, src, sizeof(ecs_vector_t) + params->element_size * src->count);
+    memcpy(ARRAY_BUFFER(dst), ARRAY_BUFFER(src), 
+        params->element_size * src->count);
+    dst->count = src->count;
     return dst;
 }
@@ -8,85 +8,137 @@ const ecs_vector_params_t job_arr_params = {
     .element_size = sizeof(ecs_job_t)
 };
 
-/** Worker thread code. Processes a job for one system */
+const ecs_vector_params_t cpu_arr_params = {
+    .element_size = sizeof(uint32_t)
+};
+
+/** Take a job from the queue of a thread. This can be the current thread, or
+ * another thread from which the current thread is stealing. */
 static
-void* ecs_worker(void *arg) {
-    ecs_thread_t *thread = arg;
-    ecs_world_t *world = thread->world;
-    uint32_t i;
+ecs_job_t* take_job(
+    ecs_thread_t *thread)
+{
+    uint32_t count = ecs_vector_count(thread->jobs);
 
-    ecs_os_mutex_lock(world->thread_mutex);
-    world->threads_running ++;
+    /* Test before incrementing, so that head does not keep increasing while
+     * threads are looking for work in an empty queue */
+    if ((uint32_t)thread->job_head >= count) {
+        return NULL;
+    }
 
-    while (!world->quit_workers) {
-        ecs_os_cond_wait(world->thread_cond, world->thread_mutex);
-        if (world->quit_workers) {
-            break;
-        }
+    uint32_t index = ecs_os_ainc(&thread->job_head) - 1;
+    if (index < count) {
+        ecs_job_t **jobs = ecs_vector_first(thread->jobs);
+        return jobs[index];
+    }
 
-        ecs_job_t **jobs = thread->jobs;
-        uint32_t job_count = thread->job_count;
-        ecs_os_mutex_unlock(world->thread_mutex);
+    return NULL;
+}
 
-        for (i = 0; i < job_count; i ++) {
-            ecs_run_intern(
-                (ecs_world_t*)thread, /* magic */
-                world,
-                jobs[i]->system, 
-                world->delta_time, 
-                jobs[i]->offset, 
-                jobs[i]->limit, 
-                NULL, 
-                NULL);
-        }
+/** Run a single job in the stage of the current thread */
+static
+void run_job(
+    ecs_thread_t *thread,
+    ecs_job_t *job)
+{
+    ecs_world_t *world = thread->world;
+    ecs_time_t start;
 
-        ecs_os_mutex_lock(world->thread_mutex);
-        thread->job_count = 0;
+    ecs_os_get_time(&start);
 
-        ecs_os_mutex_lock(world->job_mutex);
-        world->jobs_finished ++;
-        if (world->jobs_finished == world->threads_running) {
-            ecs_os_cond_signal(world->job_cond);
+    if (job->merge_items) {
+        uint32_t i, end = job->offset + job->limit;
+        for (i = job->offset; i < end; i ++) {
+            ecs_merge_copy(world, &job->merge_items[i], true);
         }
-        ecs_os_mutex_unlock(world->job_mutex);
+    } else {
+        ecs_run_intern(
+            (ecs_world_t*)thread, /* magic */
+            world,
+            job->system, 
+            world->delta_time, 
+            job->offset, 
+            job->limit, 
+            NULL, 
+            NULL);
     }
 
-    ecs_os_mutex_unlock(world->thread_mutex);
-
-    return NULL;
+    /* Used by the scheduler to balance the cost of jobs */
+    job->time_spent = ecs_time_measure(&start);
 }
 
-/** Wait until threads have started (busy loop) */
+/** Run jobs of current thread, then steal jobs until all queues are empty */
 static
-void wait_for_threads(
-    ecs_world_t *world)
+void run_jobs(
+    ecs_thread_t *thread)
 {
-    uint32_t thread_count = ecs_vector_count(world->worker_threads) - 1;
-    bool wait = true;
+    ecs_world_t *world = thread->world;
+    ecs_thread_t *threads = ecs_vector_first(world->worker_threads);
+    uint32_t i, count = ecs_vector_count(world->worker_threads);
+    ecs_job_t *job;
+
+    ecs_job_t **tasks = ecs_vector_first(thread->tasks);
+    uint32_t task_count = ecs_vector_count(thread->tasks);
+    for (i = 0; i < task_count; i ++) {
+        run_job(thread, tasks[i]);
+    }
+
+    while ((job = take_job(thread))) {
+        run_job(thread, job);
+    }
+
+    /* A reserved main thread only runs tasks */
+    if (!thread->index && world->reserve_main_thread) {
+        return;
+    }
 
-    do {
-        ecs_os_mutex_lock(world->thread_mutex);
-        if (world->threads_running == thread_count) {
-            wait = false;
+    /* Jobs are only added to queues before threads are signalled, so once a
+     * queue is empty it stays empty and visiting each victim once is enough.
+     * Start at the next thread, so that thieves spread out over victims. */
+    for (i = 1; i < count; i ++) {
+        ecs_thread_t *victim = &threads[(thread->index + i) % count];
+        while ((job = take_job(victim))) {
+            run_job(thread, job);
         }
-        ecs_os_mutex_unlock(world->thread_mutex);
-    } while (wait);
+    }
 }
 
-/** Wait until threads have finished processing their jobs */
+/** Pin thread to its CPU set. Does nothing if the OS API does not support
+ * setting the affinity of threads. */
 static
-void wait_for_jobs(
-    ecs_world_t *world)
+void set_affinity(
+    ecs_thread_t *thread)
 {
-    uint32_t thread_count = ecs_vector_count(world->worker_threads) - 1;
+    uint32_t count = ecs_vector_count(thread->cpus);
+    if (count && ecs_os_api.thread_set_affinity) {
+        if (!ecs_os_thread_set_affinity(ecs_vector_first(thread->cpus), count)) {
+            ecs_os_warn("failed to set affinity of thread %d", thread->index);
+        }
+    }
+}
+
+/** Worker thread code. Processes jobs for systems */
+static
+void* ecs_worker(void *arg) {
+    ecs_thread_t *thread = arg;
+    ecs_world_t *world = thread->world;
+
+    set_affinity(thread);
 
-    ecs_os_mutex_lock(world->job_mutex);
-    if (world->jobs_finished != thread_count) {
-        do {
-            ecs_os_cond_wait(world->job_cond, world->job_mutex);
-        } while (world->jobs_finished != thread_count);
+    /* Threads meet at the barrier twice for each batch of jobs: once before
+     * the jobs start, and once after all jobs have finished. */
+    while (true) {
+        ecs_os_barrier_wait(world->thread_barrier);
+        if (world->quit_workers) {
+            break;
+        }
+
+        run_jobs(thread);
+
+        ecs_os_barrier_wait(world->thread_barrier);
     }
-    ecs_os_mutex_unlock(world->job_mutex);
+
+    return NULL;
 }
 
 /** Stop worker threads */
@@ -94,10 +146,8 @@ static
 void ecs_stop_threads(
     ecs_world_t *world)
 {
-    ecs_os_mutex_lock(world->thread_mutex);
     world->quit_workers = true;
-    ecs_os_cond_broadcast(world->thread_cond);
-    ecs_os_mutex_unlock(world->thread_mutex);
+    ecs_os_barrier_wait(world->thread_barrier);
 
     ecs_thread_t *buffer = ecs_vector_first(world->worker_threads);
     uint32_t i, count = ecs_vector_count(world->worker_threads);
@@ -106,15 +156,19 @@ void ecs_stop_threads(
         ecs_stage_deinit(world, buffer[i].stage);
     }
 
+    for (i = 0; i < count; i ++) {
+        ecs_vector_free(buffer[i].jobs);
+        ecs_vector_free(buffer[i].tasks);
+    }
+
     ecs_vector_free(world->worker_threads);
     ecs_vector_free(world->worker_stages);
     world->worker_stages = NULL;
     world->worker_threads = NULL;
     world->quit_workers = false;
-    world->threads_running = 0;
 }
 
-/** Start worker threads, wait until they are running */
+/** Start worker threads */
 void start_threads(
     ecs_world_t *world,
     uint32_t threads)
@@ -132,8 +186,16 @@ void start_threads(
         thread->magic = ECS_THREAD_MAGIC;
         thread->world = world;
         thread->thread = 0;
-        thread->job_count = 0;
+        thread->jobs = ecs_vector_new(&ptr_params, 0);
+        thread->tasks = NULL;
+        thread->job_head = 0;
         thread->index = i;
+        thread->cpus = NULL;
+
+        if (i < ecs_vector_count(world->thread_affinity)) {
+            ecs_vector_t **cpus = ecs_vector_first(world->thread_affinity);
+            thread->cpus = cpus[i];
+        }
 
         thread->stage = ecs_vector_add(&world->worker_stages, &stage_arr_params);
         ecs_stage_init(world, thread->stage);
@@ -143,47 +205,558 @@ void start_threads(
             ecs_assert(thread->thread != 0, ECS_THREAD_ERROR, NULL);
         }
     }
+
+    /* Thread 0 is the thread that calls ecs_progress. Pin it after starting
+     * the workers, so that they don't inherit its CPU set. */
+    set_affinity(ecs_vector_first(world->worker_threads));
+}
+
+/** Test if systems access the same component, while one of them writes it */
+static
+bool systems_conflict(
+    ecs_world_t *world,
+    EcsColSystem *system_1,
+    EcsColSystem *system_2)
+{
+    if (system_1->write_set) {
+        if (system_2->read_set && ecs_type_contains(
+            world, system_1->write_set, system_2->read_set, false, false))
+        {
+            return true;
+        }
+
+        if (system_2->write_set && ecs_type_contains(
+            world, system_1->write_set, system_2->write_set, false, false))
+        {
+            return true;
+        }
+    }
+
+    if (system_2->write_set && system_1->read_set) {
+        if (ecs_type_contains(
+            world, system_1->read_set, system_2->write_set, false, false))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Assign systems in a phase to batches. A system is added to the first batch
+ * after the batches of all preceding systems it conflicts with, which ensures
+ * that conflicting systems run in the order in which they were declared, while
+ * systems that do not conflict can run at the same time. */
+static
+void schedule_batches(
+    ecs_world_t *world,
+    ecs_vector_t *systems)
+{
+    ecs_entity_t *buffer = ecs_vector_first(systems);
+    uint32_t i, j, count = ecs_vector_count(systems);
+    EcsColSystem **system_data = ecs_os_alloca(EcsColSystem*, count);
+
+    for (i = 0; i < count; i ++) {
+        system_data[i] = ecs_get_ptr(world, buffer[i], EcsColSystem);
+        ecs_assert(system_data[i] != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        uint32_t batch = 0;
+        for (j = 0; j < i; j ++) {
+            if (system_data[j]->batch >= batch) {
+                if (systems_conflict(world, system_data[j], system_data[i])) {
+                    batch = system_data[j]->batch + 1;
+                }
+            }
+        }
+
+        system_data[i]->batch = batch;
+    }
 }
 
 /** Create jobs for system */
 static
 void create_jobs(
     EcsColSystem *system_data,
-    uint32_t thread_count)
+    uint32_t job_count)
 {
     if (system_data->jobs) {
         ecs_vector_free(system_data->jobs);
     }
 
-    system_data->jobs = ecs_vector_new(&job_arr_params, thread_count);
+    system_data->jobs = ecs_vector_new(&job_arr_params, job_count);
 
     uint32_t i;
-    for (i = 0; i < thread_count; i ++) {
+    for (i = 0; i < job_count; i ++) {
         ecs_vector_add(&system_data->jobs, &job_arr_params);
     }
 }
 
 
+/** Test if all jobs have been measured, and took long enough to be useful for
+ * determining their cost */
+static
+bool jobs_measured(
+    ecs_job_t *jobs,
+    uint32_t job_count)
+{
+    double total = 0;
+    uint32_t i;
+
+    for (i = 0; i < job_count; i ++) {
+        if (jobs[i].time_spent <= 0) {
+            return false;
+        }
+        total += jobs[i].time_spent;
+    }
+
+    return job_count && total >= ECS_JOB_MIN_MEASURED_TIME * job_count;
+}
+
+/** Test if the slowest job takes significantly longer than the average job */
+static
+bool jobs_imbalanced(
+    ecs_job_t *jobs,
+    uint32_t job_count)
+{
+    double total = 0, max = 0;
+    uint32_t i;
+
+    for (i = 0; i < job_count; i ++) {
+        double t = jobs[i].time_spent;
+        total += t;
+        if (t > max) {
+            max = t;
+        }
+    }
+
+    if (max < ECS_JOB_MIN_MEASURED_TIME) {
+        return false;
+    }
+
+    return max > (total / job_count) * ECS_JOB_IMBALANCE_THRESHOLD;
+}
+
+/** Split rows evenly over jobs */
+static
+void split_evenly(
+    ecs_job_t *jobs,
+    uint32_t job_count,
+    uint32_t total_rows)
+{
+    float rows_per_job = (float)total_rows / (float)job_count;
+    float residual = 0;
+    int32_t rows_per_job_i = rows_per_job;
+
+    uint32_t i, start_index = 0;
+
+    for (i = 0; i < job_count; i ++) {
+        int32_t rows = rows_per_job_i;
+        residual += rows_per_job - rows;
+        if (residual > 1) {
+            rows ++;
+            residual --;
+        }
+
+        jobs[i].offset = start_index;
+        jobs[i].limit = rows;
+
+        start_index += rows;
+    }
+
+    if (i && residual >= 0.9) {
+        jobs[i - 1].limit ++;
+    }
+}
+
+/** Split rows over jobs so that each job has roughly the same cost. The cost of
+ * a row is derived from the measured time of the previous job that contained
+ * the row. This accounts for the difference in cost between tables, as jobs 
+ * that iterate expensive tables (for example because of CASCADE or shared
+ * columns) take longer. When rows were added, the new rows are assumed to cost
+ * the same as the rows in the last job. */
+static
+void split_by_cost(
+    ecs_job_t *jobs,
+    uint32_t job_count,
+    ecs_job_t *prev,
+    uint32_t prev_count,
+    uint32_t total_rows)
+{
+    double last_cost = prev[prev_count - 1].time_spent / 
+        prev[prev_count - 1].limit;
+    double total_cost = 0;
+    uint32_t i, row = 0;
+
+    for (i = 0; i < prev_count && row < total_rows; i ++) {
+        uint32_t rows = prev[i].limit;
+        if (rows > total_rows - row) {
+            rows = total_rows - row;
+        }
+
+        total_cost += rows * (prev[i].time_spent / prev[i].limit);
+        row += rows;
+    }
+
+    total_cost += (total_rows - row) * last_cost;
+
+    double job_cost = total_cost / job_count;
+    uint32_t p = 0, p_row = 0;
+
+    row = 0;
+
+    for (i = 0; i < job_count; i ++) {
+        uint32_t jobs_left = job_count - i;
+
+        /* Leave at least one row for each of the remaining jobs */
+        uint32_t max_rows = total_rows - row - (jobs_left - 1);
+        uint32_t rows = 0;
+
+        if (jobs_left == 1) {
+            rows = max_rows;
+        } else {
+            double cost = 0;
+
+            while (cost < job_cost && rows < max_rows) {
+                double row_cost = last_cost;
+                uint32_t available = max_rows - rows;
+
+                if (p < prev_count) {
+                    row_cost = prev[p].time_spent / prev[p].limit;
+                    if (prev[p].limit - p_row < available) {
+                        available = prev[p].limit - p_row;
+                    }
+                }
+
+                double needed = ceil((job_cost - cost) / row_cost);
+                uint32_t n = available;
+                if (needed < available) {
+                    n = needed;
+                }
+
+                cost += n * row_cost;
+                rows += n;
+                p_row += n;
+
+                if (p < prev_count && p_row == prev[p].limit) {
+                    p ++;
+                    p_row = 0;
+                }
+            }
+        }
+
+        jobs[i].offset = row;
+        jobs[i].limit = rows;
+        row += rows;
+    }
+}
+
+/** Move job boundaries so that small tables are not split across jobs, and so
+ * that large tables are split in chunks that are a multiple of min_rows. A
+ * boundary inside a small table moves to the nearest edge of the table, which 
+ * can leave jobs empty. Empty jobs are removed, and the new number of jobs is
+ * returned. */
+static
+uint32_t align_jobs(
+    ecs_job_t *jobs,
+    uint32_t job_count,
+    const uint32_t *table_rows,
+    uint32_t table_count,
+    uint32_t min_rows)
+{
+    uint32_t t = 0, table_start = 0, table_end = 0;
+    uint32_t i, count = 0, start = 0;
+
+    for (i = 0; i < job_count; i ++) {
+        uint32_t end = jobs[i].offset + jobs[i].limit;
+
+        /* The end of the last job is the end of the last table */
+        if (i != job_count - 1) {
+            while (end >= table_end && t < table_count) {
+                table_start = table_end;
+                table_end += table_rows[t];
+                t ++;
+            }
+
+            if (end != table_start) {
+                if ((table_end - table_start) < min_rows * 2) {
+                    if ((end - table_start) < (table_end - end)) {
+                        end = table_start;
+                    } else {
+                        end = table_end;
+                    }
+                } else {
+                    uint32_t chunks = 
+                        (end - table_start + min_rows / 2) / min_rows;
+                    end = table_start + chunks * min_rows;
+                    if ((table_end - end) < min_rows) {
+                        end = table_end;
+                    }
+                }
+            }
+        }
+
+        if (end > start) {
+            jobs[count].offset = start;
+            jobs[count].limit = end - start;
+            count ++;
+            start = end;
+        }
+    }
+
+    return count;
+}
+
+/** Assign jobs to worker threads. Consecutive jobs are assigned to the same
+ * thread, so that threads (unless they steal) iterate over adjacent rows. Tasks
+ * always run on the main thread, other jobs skip the main thread when it is
+ * reserved. */
+static
+void queue_jobs(
+    ecs_world_t *world,
+    ecs_job_t *jobs,
+    uint32_t job_count)
+{
+    ecs_vector_t *threads = world->worker_threads;
+    uint32_t i, thread_count = ecs_vector_count(threads);
+    uint32_t first_thread = 0;
+
+    if (world->reserve_main_thread) {
+        first_thread = 1;
+        thread_count --;
+    }
+
+    for (i = 0; i < job_count; i++) {
+        ecs_job_t *job = &jobs[i];
+        ecs_thread_t *thr;
+        ecs_job_t **elem;
+
+        if (job->is_task) {
+            thr = ecs_vector_first(threads);
+            elem = ecs_vector_add(&thr->tasks, &ptr_params);
+        } else {
+            uint32_t thread_index = first_thread + i * thread_count / job_count;
+            thr = ecs_vector_get(threads, &thread_arr_params, thread_index);
+            elem = ecs_vector_add(&thr->jobs, &ptr_params);
+        }
+
+        *elem = job;
+    }
+}
+
+/** Sort merge items by the table they are copied to */
+static
+int compare_merge_item(
+    const void *p1,
+    const void *p2)
+{
+    uintptr_t t1 = (uintptr_t)((ecs_merge_item_t*)p1)->table;
+    uintptr_t t2 = (uintptr_t)((ecs_merge_item_t*)p2)->table;
+    return (t1 > t2) - (t1 < t2);
+}
+
+/** Add type to set of staged types. Returns false if the set is full. */
+static
+bool add_staged_type(
+    ecs_type_t *types,
+    uint32_t *count,
+    ecs_type_t type)
+{
+    uint32_t i;
+
+    if (!type) {
+        return true;
+    }
+
+    for (i = 0; i < *count; i ++) {
+        if (types[i] == type) {
+            return true;
+        }
+    }
+
+    if (*count == ECS_PIPELINE_MAX_STAGED_TYPES) {
+        return false;
+    }
+
+    types[(*count) ++] = type;
+    return true;
+}
+
+/** Collect the types of entities that have changes in a worker stage. Returns
+ * false if the changes cannot be described by a limited set of types. */
+static
+bool collect_staged_types(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t *types,
+    uint32_t *count)
+{
+    ecs_ei_iter_t ei_it = ecs_ei_iter(stage->entity_index);
+    while (ecs_ei_hasnext(&ei_it)) {
+        ecs_row_t *row = ecs_ei_next(&ei_it, NULL);
+        if (!add_staged_type(types, count, row->type)) {
+            return false;
+        }
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(stage->remove_merge);
+    while (ecs_map_hasnext(&it)) {
+        ecs_type_t *type = ecs_map_next(&it);
+        if (!add_staged_type(types, count, *type)) {
+            return false;
+        }
+    }
+
+    ecs_op_t *ops = ecs_vector_first(stage->ops);
+    uint32_t i, op_count = ecs_vector_count(stage->ops);
+    for (i = 0; i < op_count; i ++) {
+        ecs_op_t *op = &ops[i];
+        if (op->kind == EcsOpAddRemove) {
+            if (!add_staged_type(types, count, op->is.add_remove.to_add) ||
+                !add_staged_type(types, count, op->is.add_remove.to_remove))
+            {
+                return false;
+            }
+        } else if (op->kind == EcsOpSet) {
+            ecs_type_t type = ecs_type_from_entity(world, op->is.set.component);
+            if (!add_staged_type(types, count, type)) {
+                return false;
+            }
+        } else {
+            /* The components of a deleted entity are not known */
+            return false;
+        }
+    }
+
+    ops = ecs_vector_first(stage->sparse_ops);
+    op_count = ecs_vector_count(stage->sparse_ops);
+    for (i = 0; i < op_count; i ++) {
+        ecs_op_t *op = &ops[i];
+        if (!add_staged_type(types, count, op->is.add_remove.to_add) ||
+            !add_staged_type(types, count, op->is.add_remove.to_remove))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Test if a system accesses or matches with a component in staged types */
+static
+bool system_uses_staged(
+    ecs_world_t *world,
+    EcsColSystem *system_data,
+    ecs_type_t *types,
+    uint32_t type_count)
+{
+    uint32_t i, column_count = ecs_vector_count(system_data->base.columns);
+    ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
+
+    for (i = 0; i < column_count; i ++) {
+        ecs_system_column_t *column = &columns[i];
+        ecs_entity_t *components = &column->is.component;
+        uint32_t c, t, count = 1;
+
+        if (column->kind == EcsFromEmpty) {
+            continue;
+        }
+
+        if (column->oper_kind == EcsOperOr) {
+            components = ecs_vector_first(column->is.type);
+            count = ecs_vector_count(column->is.type);
+        }
+
+        for (c = 0; c < count; c ++) {
+            for (t = 0; t < type_count; t ++) {
+                if (ecs_type_has_entity_intern(
+                    world, types[t], components[c], false)) 
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    /* Components excluded by the system determine which entities the system
+     * iterates as much as the components it accesses */
+    ecs_type_t not_types[] = {
+        system_data->base.not_from_self,
+        system_data->base.not_from_owned,
+        system_data->base.not_from_shared,
+        system_data->base.not_from_component
+    };
+
+    for (i = 0; i < 4; i ++) {
+        uint32_t t;
+        if (!not_types[i]) {
+            continue;
+        }
+
+        for (t = 0; t < type_count; t ++) {
+            if (ecs_type_contains(world, types[t], not_types[i], false, false)) {
+                return true;
+            }
+        }
+    }
+
+    ecs_sparse_set_t **not_sparse = ecs_vector_first(system_data->base.not_sparse);
+    uint32_t s, sparse_count = ecs_vector_count(system_data->base.not_sparse);
+    for (s = 0; s < sparse_count; s ++) {
+        uint32_t t;
+        for (t = 0; t < type_count; t ++) {
+            if (ecs_type_has_entity_intern(
+                world, types[t], not_sparse[s]->component, false))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 /* -- Private functions -- */
 
-/** Create a job per available thread for system */
+/** Compute batches for systems in phases that run on worker threads */
+void ecs_schedule_batches(
+    ecs_world_t *world)
+{
+    schedule_batches(world, world->pre_update_systems);
+    schedule_batches(world, world->on_update_systems);
+    schedule_batches(world, world->on_validate_systems);
+    schedule_batches(world, world->post_update_systems);
+    world->valid_batches = true;
+}
+
+/** Split system in row ranges that can be distributed over threads */
 void ecs_schedule_jobs(
     ecs_world_t *world,
     ecs_entity_t system)
 {
     EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
     uint32_t thread_count = ecs_vector_count(world->worker_threads);
+    uint32_t job_count;
+    uint32_t min_rows = world->job_min_rows;
     uint32_t total_rows = 0;
     bool is_task = false;
 
+    if (world->reserve_main_thread) {
+        thread_count --;
+    }
+
+    job_count = thread_count * ECS_JOBS_PER_THREAD;
+
     ecs_matched_table_t *tables = ecs_vector_first(system_data->tables);
     uint32_t i, count = ecs_vector_count(system_data->tables);
+    uint32_t *table_rows = ecs_os_alloca(uint32_t, count);
 
     for (i = 0; i < count; i ++) {
         ecs_table_t *table = tables[i].table;
         if (table) {
-            total_rows += ecs_vector_count(table->columns[0].data);
+            table_rows[i] = ecs_vector_count(table->columns[0].data);
+            total_rows += table_rows[i];
         } else {
+            table_rows[i] = 0;
             is_task = true;
         }
 
@@ -192,89 +765,203 @@ void ecs_schedule_jobs(
     }
 
     if (is_task) {
-        thread_count = 1; /* Tasks are always scheduled to the main thread */
-    } else if (total_rows < thread_count) {
-        thread_count = total_rows;
-    }
+        job_count = 1; /* Tasks are always scheduled to the main thread */
+    } else {
+        if (min_rows && (total_rows / min_rows) < job_count) {
+            job_count = total_rows / min_rows;
+            if (!job_count) {
+                job_count = 1;
+            }
+        }
 
-    if (ecs_vector_count(system_data->jobs) != thread_count) {
-        create_jobs(system_data, thread_count);
+        if (total_rows < job_count) {
+            job_count = total_rows;
+        }
     }
 
-    float rows_per_thread = (float)total_rows / (float)thread_count;
-    float residual = 0;
-    int32_t rows_per_thread_i = rows_per_thread;
+    ecs_job_t *jobs = ecs_vector_first(system_data->jobs);
+    uint32_t prev_count = ecs_vector_count(system_data->jobs);
+    ecs_job_t *prev = NULL;
 
-    uint32_t start_index = 0;
+    if (!is_task && prev_count) {
+        uint32_t prev_rows = 0;
+        for (i = 0; i < prev_count; i ++) {
+            prev_rows += jobs[i].limit;
+        }
 
-    ecs_job_t *job = NULL;
+        /* If the rows and minimum did not change, only split the system again
+         * when the cost of its jobs has become unbalanced */
+        if (system_data->split_count == job_count && prev_rows == total_rows &&
+            system_data->split_min_rows == min_rows) 
+        {
+            if (!jobs_imbalanced(jobs, prev_count)) {
+                return;
+            }
+        }
 
-    for (i = 0; i < thread_count; i ++) {
-        job = ecs_vector_get(system_data->jobs, &job_arr_params, i);
-        int32_t rows_per_job = rows_per_thread_i;
-        residual += rows_per_thread - rows_per_job;
-        if (residual > 1) {
-            rows_per_job ++;
-            residual --;
+        /* Periodic systems don't run every frame, which makes the measured
+         * time of their jobs unreliable */
+        if (!system_data->period && jobs_measured(jobs, prev_count)) {
+            prev = ecs_os_alloca(ecs_job_t, prev_count);
+            memcpy(prev, jobs, sizeof(ecs_job_t) * prev_count);
         }
+    }
 
-        job->system = system;
-        job->system_data = system_data;
-        job->offset = start_index;
-        job->limit = rows_per_job;
+    if (prev_count != job_count) {
+        create_jobs(system_data, job_count);
+        jobs = ecs_vector_first(system_data->jobs);
+    }
 
-        start_index += rows_per_job;
+    if (prev) {
+        split_by_cost(jobs, job_count, prev, prev_count, total_rows);
+    } else {
+        split_evenly(jobs, job_count, total_rows);
     }
 
-    if (i && residual >= 0.9) {
-        job->limit ++;
+    system_data->split_count = job_count;
+    system_data->split_min_rows = min_rows;
+
+    if (min_rows && !is_task && job_count > 1) {
+        job_count = align_jobs(jobs, job_count, table_rows, count, min_rows);
+        ecs_vector_set_count(&system_data->jobs, &job_arr_params, job_count);
+    }
+
+    for (i = 0; i < job_count; i ++) {
+        jobs[i].system = system;
+        jobs[i].system_data = system_data;
+        jobs[i].merge_items = NULL;
+        jobs[i].time_spent = 0;
+        jobs[i].is_task = is_task;
+    }
+}
+
+/** Test if systems in a phase access components of entities that have changes
+ * in the worker stages. If they do not, the merge of the stages can be
+ * postponed until after the phase, as the systems would observe the same data
+ * before and after the merge. */
+bool ecs_phase_uses_staged(
+    ecs_world_t *world,
+    ecs_vector_t *systems)
+{
+    ecs_type_t types[ECS_PIPELINE_MAX_STAGED_TYPES];
+    uint32_t i, type_count = 0;
+
+    ecs_stage_t *stages = ecs_vector_first(world->worker_stages);
+    uint32_t stage_count = ecs_vector_count(world->worker_stages);
+    for (i = 0; i < stage_count; i ++) {
+        if (!collect_staged_types(world, &stages[i], types, &type_count)) {
+            return true;
+        }
+    }
+
+    if (!type_count) {
+        return false;
+    }
+
+    ecs_entity_t *buffer = ecs_vector_first(systems);
+    uint32_t count = ecs_vector_count(systems);
+    for (i = 0; i < count; i ++) {
+        EcsColSystem *system_data = ecs_get_ptr(world, buffer[i], EcsColSystem);
+        if (system_uses_staged(world, system_data, types, type_count)) {
+            return true;
+        }
     }
+
+    return false;
 }
 
-/** Assign jobs to worker threads, signal workers */
+/** Assign jobs of a system to worker threads */
 void ecs_prepare_jobs(
     ecs_world_t *world,
     ecs_entity_t system)
 {
     EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
-    ecs_vector_t *threads = world->worker_threads;
-    ecs_vector_t *jobs = system_data->jobs;
-    uint32_t i;
 
-    uint32_t thread_count = ecs_vector_count(jobs);
+    /* Jobs are run by worker threads, so assign the change tick here */
+    ecs_col_system_next_tick(world, system_data);
+
+    queue_jobs(world, ecs_vector_first(system_data->jobs), 
+        ecs_vector_count(system_data->jobs));
+}
+
+/** Copy staged data to the main stage on worker threads. Items are grouped by
+ * the table they are copied to, and jobs are aligned to these groups in the 
+ * same way as system jobs are aligned to tables, so that threads write to 
+ * separate tables where possible. */
+void ecs_run_merge_jobs(
+    ecs_world_t *world,
+    ecs_merge_item_t *items,
+    uint32_t count)
+{
+    uint32_t thread_count = ecs_vector_count(world->worker_threads);
+    uint32_t min_rows = world->job_min_rows;
+    uint32_t job_count, i, group_count = 0;
+
+    if (world->reserve_main_thread) {
+        thread_count --;
+    }
+
+    qsort(items, count, sizeof(ecs_merge_item_t), compare_merge_item);
+
+    uint32_t *group_rows = ecs_os_malloc(sizeof(uint32_t) * count);
+    for (i = 0; i < count; i ++) {
+        if (!i || items[i].table != items[i - 1].table) {
+            group_rows[group_count ++] = 0;
+        }
+        group_rows[group_count - 1] ++;
+    }
+
+    job_count = thread_count * ECS_JOBS_PER_THREAD;
+    if (min_rows && (count / min_rows) < job_count) {
+        job_count = count / min_rows;
+    }
+    if (!job_count) {
+        job_count = 1;
+    }
+
+    ecs_vector_set_count(&world->merge_jobs, &job_arr_params, job_count);
+    ecs_job_t *jobs = ecs_vector_first(world->merge_jobs);
+
+    split_evenly(jobs, job_count, count);
+
+    if (min_rows && job_count > 1) {
+        job_count = align_jobs(
+            jobs, job_count, group_rows, group_count, min_rows);
+    }
+
+    ecs_os_free(group_rows);
 
-    for (i = 0; i < thread_count; i++) {
-        ecs_thread_t *thr = ecs_vector_get(threads, &thread_arr_params, i);
-        uint32_t job_count = thr->job_count;
-        thr->jobs[job_count] = ecs_vector_get(jobs, &job_arr_params, i);
-        thr->job_count = job_count + 1;
+    for (i = 0; i < job_count; i ++) {
+        jobs[i].system = 0;
+        jobs[i].system_data = NULL;
+        jobs[i].merge_items = items;
+        jobs[i].time_spent = 0;
+        jobs[i].is_task = false;
     }
+
+    queue_jobs(world, jobs, job_count);
+    ecs_run_jobs(world);
 }
 
 void ecs_run_jobs(
     ecs_world_t *world)
 {
-    /* Make sure threads are ready to accept jobs */
-    wait_for_threads(world);
+    ecs_thread_t *threads = ecs_vector_first(world->worker_threads);
 
-    ecs_os_mutex_lock(world->thread_mutex);
-    world->jobs_finished = 0;
-    ecs_os_cond_broadcast(world->thread_cond);
-    ecs_os_mutex_unlock(world->thread_mutex);
+    /* Release worker threads, and run jobs for thread 0 in main thread */
+    ecs_os_barrier_wait(world->thread_barrier);
 
-    /* Run job for thread 0 in main thread */
-    ecs_thread_t *thread = ecs_vector_first(world->worker_threads);
-    ecs_job_t **jobs = thread->jobs;
-    uint32_t i, job_count = thread->job_count;
+    run_jobs(&threads[0]);
 
-    for (i = 0; i < job_count; i ++) {
-        ecs_run_w_filter(
-            (ecs_world_t*)thread, jobs[i]->system, world->delta_time, jobs[i]->offset, jobs[i]->limit, 0, NULL);
-    }
-    thread->job_count = 0;
+    /* Wait until all threads have finished their jobs */
+    ecs_os_barrier_wait(world->thread_barrier);
 
-    if (world->jobs_finished != ecs_vector_count(world->worker_threads) - 1) {
-        wait_for_jobs(world);
+    /* All queues are empty, reset them for the next batch of jobs */
+    uint32_t i, count = ecs_vector_count(world->worker_threads);
+    for (i = 0; i < count; i ++) {
+        ecs_vector_clear(threads[i].jobs);
+        ecs_vector_clear(threads[i].tasks);
+        threads[i].job_head = 0;
     }
 }
 
@@ -287,33 +974,96 @@ void ecs_set_threads(
 {
     ecs_assert(!threads || ecs_os_api.thread_new, ECS_MISSING_OS_API, "thread_new");
     ecs_assert(!threads || ecs_os_api.thread_join, ECS_MISSING_OS_API, "thread_join");
+    ecs_assert(!threads || ecs_os_api.ainc, ECS_MISSING_OS_API, "ainc");
+    ecs_assert(!threads || ecs_os_api.barrier_new, ECS_MISSING_OS_API, "barrier_new");
+    ecs_assert(!threads || ecs_os_api.barrier_free, ECS_MISSING_OS_API, "barrier_free");
+    ecs_assert(!threads || ecs_os_api.barrier_wait, ECS_MISSING_OS_API, "barrier_wait");
     ecs_assert(!threads || ecs_os_api.mutex_new, ECS_MISSING_OS_API, "mutex_new");
-    ecs_assert(!threads || ecs_os_api.mutex_free, ECS_MISSING_OS_API, "mutex_free");
-    ecs_assert(!threads || ecs_os_api.mutex_lock, ECS_MISSING_OS_API, "mutex_lock");
-    ecs_assert(!threads || ecs_os_api.mutex_unlock, ECS_MISSING_OS_API, "mutex_unlock");
-    ecs_assert(!threads || ecs_os_api.cond_new, ECS_MISSING_OS_API, "cond_new");
-    ecs_assert(!threads || ecs_os_api.cond_free, ECS_MISSING_OS_API, "cond_free");
-    ecs_assert(!threads || ecs_os_api.cond_wait, ECS_MISSING_OS_API, "cond_wait");
-    ecs_assert(!threads || ecs_os_api.cond_signal, ECS_MISSING_OS_API, "cond_signal");
-    ecs_assert(!threads || ecs_os_api.cond_broadcast, ECS_MISSING_OS_API, "cond_broadcast");
 
     if (!world->arg_threads) {
         if (ecs_vector_count(world->worker_threads)) {
             ecs_stop_threads(world);
-            ecs_os_cond_free(world->thread_cond);
-            ecs_os_mutex_free(world->thread_mutex);
-            ecs_os_cond_free(world->job_cond);
-            ecs_os_mutex_free(world->job_mutex);
+            ecs_os_barrier_free(world->thread_barrier);
+            ecs_os_mutex_free(world->type_mutex);
+            world->type_mutex = 0;
         }
 
         if (threads > 1) {
-            world->thread_cond = ecs_os_cond_new();
-            world->thread_mutex = ecs_os_mutex_new();
-            world->job_cond = ecs_os_cond_new();
-            world->job_mutex = ecs_os_mutex_new();
+            world->thread_barrier = ecs_os_barrier_new(
+                threads, world->thread_spin_time);
+            world->type_mutex = ecs_os_mutex_new();
             start_threads(world, threads);
         }
 
         world->valid_schedule = false;
     }
 }
+
+void ecs_set_job_min_rows(
+    ecs_world_t *world,
+    uint32_t min_rows)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world->job_min_rows = min_rows;
+    world->valid_schedule = false;
+}
+
+void ecs_set_thread_affinity(
+    ecs_world_t *world,
+    uint32_t thread,
+    const uint32_t *cpus,
+    uint32_t count)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(!count || cpus != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    /* Threads read their CPU set when they start, so restart running threads */
+    uint32_t thread_count = ecs_vector_count(world->worker_threads);
+    if (thread_count) {
+        ecs_set_threads(world, 0);
+    }
+
+    uint32_t i, prev_count = ecs_vector_count(world->thread_affinity);
+    if (thread >= prev_count) {
+        ecs_vector_set_count(
+            &world->thread_affinity, &ptr_params, thread + 1);
+
+        ecs_vector_t **sets = ecs_vector_first(world->thread_affinity);
+        for (i = prev_count; i <= thread; i ++) {
+            sets[i] = NULL;
+        }
+    }
+
+    ecs_vector_t **set = ecs_vector_get(
+        world->thread_affinity, &ptr_params, thread);
+
+    ecs_vector_free(*set);
+    *set = NULL;
+
+    if (count) {
+        ecs_vector_set_count(set, &cpu_arr_params, count);
+        memcpy(ecs_vector_first(*set), cpus, sizeof(uint32_t) * count);
+    }
+
+    if (thread_count) {
+        ecs_set_threads(world, thread_count);
+    }
+}
+
+void ecs_set_reserve_main_thread(
+    ecs_world_t *world,
+    bool reserve)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    world->reserve_main_thread = reserve;
+    world->valid_schedule = false;
+}
+
+void ecs_set_thread_spin_time(
+    ecs_world_t *world,
+    float spin_time)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(spin_time >= 0, ECS_INVALID_PARAMETER, NULL);
+    world->thread_spin_time = spin_time;
+}
@@ -22,6 +22,10 @@ const ecs_vector_params_t ptr_params = {
     .element_size = sizeof(void*)
 };
 
+const ecs_vector_params_t table_index_params = {
+    .element_size = sizeof(uint32_t)
+};
+
 /* -- Global variables -- */
 
 ecs_type_t TEcsComponent;
@@ -80,6 +84,103 @@ void set_table(
     ecs_map_set(stage->table_index, (uintptr_t)type, &table);
 }
 
+/** Add table to the component index. Table indices are added in creation order,
+ * so that each list in the index is ordered the same as the world tables. */
+static
+void index_table_at(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    uint32_t index)
+{
+    ecs_assert(ecs_chunked_get(world->main_stage.tables, ecs_table_t, index) == 
+        table, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_entity_t *array = ecs_vector_first(table->type);
+    uint32_t i, count = ecs_vector_count(table->type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = array[i] & ECS_ENTITY_MASK;
+        ecs_vector_t **tables_ptr = ecs_map_get_ptr(world->component_tables, e);
+        ecs_vector_t *tables = tables_ptr ? *tables_ptr : NULL;
+
+        uint32_t *elem = ecs_vector_add(&tables, &table_index_params);
+        *elem = index;
+
+        if (tables_ptr) {
+            *tables_ptr = tables;
+        } else {
+            ecs_map_set(world->component_tables, e, &tables);
+        }
+    }
+
+    /* Tables with prefabs can match components they do not own, so they are
+     * always returned when iterating the index */
+    if (table->flags & EcsTableHasPrefab) {
+        uint32_t *elem = ecs_vector_add(
+            &world->prefab_tables, &table_index_params);
+        *elem = index;
+    }
+}
+
+static
+void index_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    index_table_at(
+        world, table, ecs_chunked_count(world->main_stage.tables) - 1);
+}
+
+/** Rebuild the component index after tables have been removed, which changes
+ * the order in which tables are stored in the world */
+static
+void reindex_tables(
+    ecs_world_t *world)
+{
+    ecs_map_iter_t it = ecs_map_iter(world->component_tables);
+    while (ecs_map_hasnext(&it)) {
+        ecs_vector_t *tables = ecs_map_nextptr(&it);
+        ecs_vector_clear(tables);
+    }
+
+    ecs_vector_clear(world->prefab_tables);
+
+    ecs_chunked_t *tables = world->main_stage.tables;
+    uint32_t i, count = ecs_chunked_count(tables);
+    for (i = 0; i < count; i ++) {
+        index_table_at(world, ecs_chunked_get(tables, ecs_table_t, i), i);
+    }
+}
+
+static
+void queries_deinit(
+    ecs_world_t *world)
+{
+    ecs_query_t **buffer = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_query_deinit(buffer[i]);
+    }
+
+    ecs_vector_free(world->queries);
+}
+
+static
+void component_tables_deinit(
+    ecs_world_t *world)
+{
+    ecs_map_iter_t it = ecs_map_iter(world->component_tables);
+
+    while (ecs_map_hasnext(&it)) {
+        ecs_vector_t *tables = ecs_map_nextptr(&it);
+        ecs_vector_free(tables);
+    }
+
+    ecs_map_free(world->component_tables);
+    ecs_vector_free(world->prefab_tables);
+}
+
 /** Bootstrap builtin component types and commonly used types */
 static
 void bootstrap_types(
@@ -125,19 +226,37 @@ ecs_table_t* bootstrap_component_table(
     ecs_table_t *result = ecs_chunked_add(stage->tables, ecs_table_t);
     result->type = world->t_component;
     result->frame_systems = NULL;
+    result->queries = NULL;
+    result->add_edges = NULL;
+    result->remove_edges = NULL;
     result->flags = 0;
     result->flags |= EcsTableHasBuiltins;
-    result->columns = ecs_os_malloc(sizeof(ecs_table_column_t) * 3);
+    result->columns = ecs_os_calloc(sizeof(ecs_table_column_t), 3);
     ecs_assert(result->columns != NULL, ECS_OUT_OF_MEMORY, NULL);
 
+    ecs_vector_params_t component_params = {
+        .element_size = sizeof(EcsComponent),
+        .alignment = ECS_COLUMN_ALIGNMENT
+    };
+
+    ecs_vector_params_t id_params = {
+        .element_size = sizeof(EcsId),
+        .alignment = ECS_COLUMN_ALIGNMENT
+    };
+
     result->columns[0].data = ecs_vector_new(&handle_arr_params, 16);
     result->columns[0].size = sizeof(ecs_entity_t);
-    result->columns[1].data = ecs_vector_new(&handle_arr_params, 16);
+    result->columns[1].data = ecs_vector_new(&component_params, 16);
     result->columns[1].size = sizeof(EcsComponent);
-    result->columns[2].data = ecs_vector_new(&handle_arr_params, 16);
+    result->columns[1].alignment = ECS_COLUMN_ALIGNMENT;
+    result->columns[2].data = ecs_vector_new(&id_params, 16);
     result->columns[2].size = sizeof(EcsId);
+    result->columns[2].alignment = ECS_COLUMN_ALIGNMENT;
+
+    ecs_table_init_lookup(result);
 
     set_table(stage, world->t_component, result);
+    index_table(world, result);
 
     return result;
 }
@@ -158,13 +277,14 @@ void bootstrap_component(
 
     /* Create record in entity index */
     ecs_row_t row = {.type = world->t_component, .index = index};
-    ecs_map_set(stage->entity_index, entity, &row);
+    ecs_ei_set(stage->entity_index, entity, &row);
 
     /* Set size and id */
     EcsComponent *component_data = ecs_vector_first(table->columns[1].data);
     EcsId *id_data = ecs_vector_first(table->columns[2].data);
     
     component_data[index - 1].size = size;
+    component_data[index - 1].alignment = 0;
     id_data[index - 1] = id;
 }
 
@@ -196,6 +316,7 @@ void ecs_notify_systems_of_table(
     notify_create_table(world, world->on_update_systems, table);
     notify_create_table(world, world->manual_systems, table);
     notify_create_table(world, world->inactive_systems, table);
+    ecs_query_notify_of_table(world, table);
 }
 
 /** Create a new table and register it with the world and systems. A table in
@@ -220,6 +341,10 @@ ecs_table_t* create_table(
 
     set_table(stage, type, result);
 
+    if (stage == &world->main_stage) {
+        index_table(world, result);
+    }
+
     if (stage == &world->main_stage && !world->is_merging) {
         ecs_notify_systems_of_table(world, result);
     }
@@ -269,6 +394,72 @@ ecs_table_t* ecs_world_get_table(
     return table;
 }
 
+/** Find component in type that is used by the fewest tables */
+ecs_entity_t ecs_world_get_rarest_component(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+    ecs_entity_t result = 0;
+    uint32_t min_count = UINT32_MAX;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = array[i] & ECS_ENTITY_MASK;
+        ecs_vector_t *tables = NULL;
+        ecs_map_has(world->component_tables, e, &tables);
+
+        uint32_t table_count = ecs_vector_count(tables);
+        if (table_count < min_count) {
+            result = e;
+            min_count = table_count;
+
+            if (!table_count) {
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Get next table from the component index. Tables with prefabs are merged in,
+ * and tables are returned in the same order as they are stored in the world. */
+ecs_table_t* ecs_world_next_table(
+    ecs_world_t *world,
+    ecs_entity_t component,
+    uint32_t *table_index,
+    uint32_t *prefab_index)
+{
+    ecs_vector_t *tables = NULL;
+    ecs_map_has(world->component_tables, component, &tables);
+
+    uint32_t *t_array = ecs_vector_first(tables);
+    uint32_t *p_array = ecs_vector_first(world->prefab_tables);
+    uint32_t t_count = ecs_vector_count(tables);
+    uint32_t p_count = ecs_vector_count(world->prefab_tables);
+    uint32_t i = *table_index, j = *prefab_index;
+    uint32_t index;
+
+    if (i < t_count && (j >= p_count || t_array[i] <= p_array[j])) {
+        index = t_array[i ++];
+
+        /* Table has both the component and prefabs */
+        if (j < p_count && p_array[j] == index) {
+            j ++;
+        }
+    } else if (j < p_count) {
+        index = p_array[j ++];
+    } else {
+        return NULL;
+    }
+
+    *table_index = i;
+    *prefab_index = j;
+
+    return ecs_chunked_get(world->main_stage.tables, ecs_table_t, index);
+}
+
 ecs_vector_t** ecs_system_array(
     ecs_world_t *world,
     EcsSystemKind kind)
@@ -366,6 +557,9 @@ void ecs_world_activate_system(
     /* Signal that system has been either activated or deactivated */
     ecs_system_activate(world, system, active);
 
+    /* Systems in phase changed, batches need to be recomputed */
+    world->valid_batches = false;
+
     return;
 }
 
@@ -431,6 +625,8 @@ void col_systems_deinit(
         ecs_os_free(ptr->base.signature);
 
         ecs_vector_free(ptr->base.columns);
+        ecs_vector_free(ptr->base.and_sparse);
+        ecs_vector_free(ptr->base.not_sparse);
         ecs_vector_free(ptr->jobs);
 
         uint32_t t;
@@ -481,6 +677,17 @@ void row_index_deinit(
     ecs_map_free(sys_index);
 }
 
+/* Only free the type index. Type handles themselves are not freed, as an
+ * application may still use them after the world is deleted, for example when
+ * deserializing a snapshot into a new world. */
+static
+void types_deinit(
+    ecs_world_t *world)
+{
+    ecs_vector_free(world->types);
+    ecs_map_free(world->type_index);
+}
+
 static
 void deinit_tables(
     ecs_world_t *world)
@@ -686,15 +893,30 @@ ecs_world_t *ecs_init(void) {
     world->type_sys_remove_index = ecs_map_new(0, sizeof(ecs_vector_t*));
     world->type_sys_set_index = ecs_map_new(0, sizeof(ecs_vector_t*));
     world->type_handles = ecs_map_new(0, sizeof(ecs_entity_t));
+    world->type_index = ecs_map_new(0, sizeof(ecs_type_t));
+    world->component_tables = ecs_map_new(0, sizeof(ecs_vector_t*));
+    world->prefab_tables = NULL;
+    world->queries = NULL;
+    world->types = ecs_vector_new(&ptr_params, 0);
+    world->sparse_sets = NULL;
+    world->sparse_type = NULL;
     world->prefab_parent_index = ecs_map_new(0, sizeof(ecs_entity_t));
     world->on_activate_components = ecs_map_new(0, sizeof(ecs_on_demand_in_t));
     world->on_enable_components = ecs_map_new(0, sizeof(ecs_on_demand_in_t));
 
     world->worker_stages = NULL;
     world->worker_threads = NULL;
-    world->jobs_finished = 0;
-    world->threads_running = 0;
+    world->type_mutex = 0;
+    world->thread_spin_time = ECS_THREAD_SPIN_TIME;
+    world->job_min_rows = ECS_JOB_MIN_ROWS;
+    world->thread_affinity = NULL;
+    world->merge_items = NULL;
+    world->merge_jobs = NULL;
+    world->reserve_main_thread = false;
+    world->deferred_mode = false;
+    world->pipelined_merge = false;
     world->valid_schedule = false;
+    world->valid_batches = false;
     world->quit_workers = false;
     world->in_progress = false;
     world->is_merging = false;
@@ -716,7 +938,12 @@ ecs_world_t *ecs_init(void) {
     world->system_time_total = 0;
     world->merge_time_total = 0;
     world->frame_count_total = 0;
+    world->reclaimed_bytes_total = 0;
+    world->merge_count_total = 0;
+    world->merge_skip_count_total = 0;
     world->world_time_total = 0;
+    world->compact_interval = 0;
+    world->change_tick = 1;
 
     world->context = NULL;
 
@@ -870,6 +1097,15 @@ int ecs_fini(
         ecs_set_threads(world, 0);
     }
 
+    ecs_vector_t **cpus = ecs_vector_first(world->thread_affinity);
+    uint32_t cpus_count = ecs_vector_count(world->thread_affinity);
+    for (i = 0; i < cpus_count; i ++) {
+        ecs_vector_free(cpus[i]);
+    }
+    ecs_vector_free(world->thread_affinity);
+    ecs_vector_free(world->merge_items);
+    ecs_vector_free(world->merge_jobs);
+
     deinit_tables(world);
 
     col_systems_deinit_handlers(world, world->on_update_systems);
@@ -906,6 +1142,10 @@ int ecs_fini(
 
     ecs_stage_deinit(world, &world->main_stage);
     ecs_stage_deinit(world, &world->temp_stage);
+    types_deinit(world);
+    component_tables_deinit(world);
+    queries_deinit(world);
+    ecs_sparse_free_sets(world->sparse_sets);
 
     on_demand_in_map_deinit(world->on_activate_components);
     on_demand_in_map_deinit(world->on_enable_components);
@@ -945,7 +1185,11 @@ void ecs_dim(
     uint32_t entity_count)
 {
     assert(world->magic == ECS_WORLD_MAGIC);
-    ecs_map_set_size(world->main_stage.entity_index, entity_count);
+    ecs_ei_t *entity_index = world->main_stage.entity_index;
+    uint32_t count = ecs_ei_count(entity_index);
+    if (entity_count > count) {
+        ecs_ei_grow(entity_index, world->last_handle + 1, entity_count - count);
+    }
 }
 
 void _ecs_dim_type(
@@ -964,18 +1208,18 @@ void _ecs_dim_type(
 
 static
 ecs_entity_t ecs_lookup_child_in_columns(
-    ecs_type_t type,
+    ecs_table_t *table,
     ecs_table_column_t *columns,
     ecs_entity_t parent,
     const char *id)
 {
     int16_t column_index;
 
-    if ((column_index = ecs_type_index_of(type, EEcsId)) == -1) {
+    if ((column_index = ecs_table_column_index(table, EEcsId)) == -1) {
         return 0;
     }
 
-    if (parent && ecs_type_index_of(type, parent) == -1) {
+    if (parent && ecs_table_column_index(table, parent) == -1) {
         return 0;
     }
 
@@ -1012,7 +1256,8 @@ ecs_entity_t ecs_lookup_child(
             uint64_t key;
             ecs_table_column_t *columns = ecs_map_nextptr_w_key(&it, &key);
             ecs_type_t key_type = (ecs_type_t)(uintptr_t)key;
-            result = ecs_lookup_child_in_columns(key_type, columns, parent, id);
+            ecs_table_t *table = ecs_world_get_table(world, stage, key_type);
+            result = ecs_lookup_child_in_columns(table, columns, parent, id);
             if (result) {
                 break;
             }
@@ -1026,7 +1271,7 @@ ecs_entity_t ecs_lookup_child(
         for (t = 0; t < count; t ++) {
             ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, t);
             result = ecs_lookup_child_in_columns(
-                table->type, table->columns, parent, id);
+                table, table->columns, parent, id);
             if (result) {
                 break;
             }
@@ -1110,9 +1355,88 @@ void revalidate_system_refs(
     revalidate_system_array(world, world->post_update_systems);
     revalidate_system_array(world, world->pre_store_systems);
     revalidate_system_array(world, world->on_store_systems);    
+    revalidate_system_array(world, world->manual_systems);
     revalidate_system_array(world, world->inactive_systems);   
 }
 
+/** Shrink table columns and release empty tables. If release_marked is true,
+ * only tables that were already empty at the previous compaction are released,
+ * so that tables that are only empty for a short time are kept. */
+static
+uint64_t compact_world(
+    ecs_world_t *world,
+    bool release_marked)
+{
+    ecs_stage_t *stage = &world->main_stage;
+    ecs_chunked_t *tables = stage->tables;
+    const uint32_t *indices = ecs_chunked_indices(tables);
+    uint32_t i, count = ecs_chunked_count(tables);
+    ecs_vector_t *released = NULL;
+    uint64_t reclaimed = 0;
+    bool freed_columns = false;
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+        bool is_empty = !ecs_vector_count(table->columns[0].data);
+
+        /* Reclaiming an empty table that is kept frees its column data */
+        bool frees_columns = is_empty && table->columns[0].data;
+
+        if (!is_empty || table->flags & EcsTableHasBuiltins) {
+            reclaimed += ecs_table_reclaim(world, table);
+            freed_columns |= frees_columns;
+            continue;
+        }
+
+        if (release_marked && !(table->flags & EcsTableWasEmpty)) {
+            table->flags |= EcsTableWasEmpty;
+            reclaimed += ecs_table_reclaim(world, table);
+            freed_columns |= frees_columns;
+            continue;
+        }
+
+        table->flags |= EcsTableIsReleased;
+        uint32_t *elem = ecs_vector_add(&released, &table_index_params);
+        *elem = indices[i];
+    }
+
+    uint32_t released_count = ecs_vector_count(released);
+    if (released_count) {
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+            if (!(table->flags & EcsTableIsReleased)) {
+                ecs_table_remove_released_edges(table);
+            }
+        }
+
+        uint32_t *buffer = ecs_vector_first(released);
+        for (i = 0; i < released_count; i ++) {
+            ecs_table_t *table = ecs_chunked_get_sparse(
+                tables, ecs_table_t, buffer[i]);
+
+            ecs_map_remove(stage->table_index, (uintptr_t)table->type);
+            reclaimed += ecs_table_release(world, table);
+            ecs_chunked_remove(tables, ecs_table_t, buffer[i]);
+        }
+
+        reindex_tables(world);
+
+        world->valid_schedule = false;
+    }
+
+    /* References may point to columns of released tables, or to columns of
+     * which the data was freed */
+    if (released_count || freed_columns) {
+        revalidate_system_refs(world);
+    }
+
+    ecs_vector_free(released);
+
+    world->reclaimed_bytes_total += reclaimed;
+
+    return reclaimed;
+}
+
 static
 void run_single_thread_stage(
     ecs_world_t *world,
@@ -1149,35 +1473,92 @@ void run_single_thread_stage(
 static
 void run_multi_thread_stage(
     ecs_world_t *world,
-    ecs_vector_t *systems)
+    ecs_vector_t *systems,
+    ecs_vector_t *next_systems)
 {
     /* Run periodic table systems */
     uint32_t i, system_count = ecs_vector_count(systems);
     if (system_count) {
         bool valid_schedule = world->valid_schedule;
         ecs_entity_t *buffer = ecs_vector_first(systems);
+        uint32_t batch, batch_count = 0;
 
         world->in_progress = true;
 
+        if (!world->valid_batches) {
+            ecs_schedule_batches(world);
+        }
+
         for (i = 0; i < system_count; i ++) {
+            EcsColSystem *system_data = ecs_get_ptr(
+                world, buffer[i], EcsColSystem);
+
             if (!valid_schedule) {
                 ecs_schedule_jobs(world, buffer[i]);
             }
-            ecs_prepare_jobs(world, buffer[i]);
+
+            if (system_data->batch >= batch_count) {
+                batch_count = system_data->batch + 1;
+            }
         }
 
         ecs_time_t start;
         ecs_time_measure(&start);
 
-        ecs_run_jobs(world);
+        /* Run batches one after another. Systems within a batch do not access
+         * components that are written by other systems in the batch, and
+         * their jobs can be processed by threads in any order. */
+        for (batch = 0; batch < batch_count; batch ++) {
+            for (i = 0; i < system_count; i ++) {
+                EcsColSystem *system_data = ecs_get_ptr(
+                    world, buffer[i], EcsColSystem);
+
+                if (system_data->batch == batch) {
+                    ecs_prepare_jobs(world, buffer[i]);
+                }
+            }
+
+            ecs_run_jobs(world);
+        }
 
         world->system_time_total += ecs_time_measure(&start);
 
         if (world->auto_merge) {
-            world->in_progress = false;
-            ecs_merge(world);
-            world->in_progress = true;
+            /* In pipelined mode, the merge is postponed if the next phase does
+             * not access data that is changed in the stages */
+            if (world->pipelined_merge && next_systems && 
+                !ecs_phase_uses_staged(world, next_systems)) 
+            {
+                world->merge_skip_count_total ++;
+            } else {
+                world->in_progress = false;
+                ecs_merge(world);
+                world->in_progress = true;
+            }
+        }
+    }
+}
+
+/** Run phases that can run on multiple threads. The merge at the end of a
+ * phase is tested against the next phase that has systems. Phases are passed
+ * by address, as a merge can activate systems, which reallocates the system
+ * vectors of the phases that have not run yet. */
+static
+void run_multi_thread_phases(
+    ecs_world_t *world,
+    ecs_vector_t **phases[],
+    uint32_t count)
+{
+    uint32_t i, j;
+    for (i = 0; i < count; i ++) {
+        ecs_vector_t *next = NULL;
+        for (j = i + 1; j < count && !next; j ++) {
+            if (ecs_vector_count(*phases[j])) {
+                next = *phases[j];
+            }
         }
+
+        run_multi_thread_stage(world, *phases[i], next);
     }
 }
 
@@ -1273,10 +1654,14 @@ bool ecs_progress(
     run_single_thread_stage(world, world->post_load_systems, true);
 
     if (has_threads) {
-        run_multi_thread_stage(world, world->pre_update_systems);
-        run_multi_thread_stage(world, world->on_update_systems);
-        run_multi_thread_stage(world, world->on_validate_systems);
-        run_multi_thread_stage(world, world->post_update_systems);
+        ecs_vector_t **phases[] = {
+            &world->pre_update_systems,
+            &world->on_update_systems,
+            &world->on_validate_systems,
+            &world->post_update_systems
+        };
+
+        run_multi_thread_phases(world, phases, 4);
     } else {
         run_single_thread_stage(world, world->pre_update_systems, true);
         run_single_thread_stage(world, world->on_update_systems, true);
@@ -1290,11 +1675,18 @@ bool ecs_progress(
     /* -- System execution stops here -- */
 
     world->frame_count_total ++;
-    
-    stop_measure_frame(world, delta_time);
 
     world->in_progress = false;
 
+    /* Compact before measuring the frame, so that compaction uses the time
+     * that is otherwise spent sleeping to meet the target FPS */
+    uint32_t compact_interval = world->compact_interval;
+    if (compact_interval && !(world->frame_count_total % compact_interval)) {
+        compact_world(world, true);
+    }
+    
+    stop_measure_frame(world, delta_time);
+
     return !world->should_quit;
 }
 
@@ -1340,6 +1732,7 @@ void ecs_merge(
     bool measure_frame_time = world->measure_frame_time;
 
     world->is_merging = true;
+    world->merge_count_total ++;
 
     ecs_time_t t_start;
     if (measure_frame_time) {
@@ -1349,18 +1742,22 @@ void ecs_merge(
     ecs_stage_merge(world, &world->temp_stage);
 
     uint32_t i, count = ecs_vector_count(world->worker_stages);
-    if (count) {
-        ecs_stage_t *buffer = ecs_vector_first(world->worker_stages);
-        for (i = 0; i < count; i ++) {
-            ecs_stage_merge(world, &buffer[i]);
-        }
+    ecs_stage_t *buffer = ecs_vector_first(world->worker_stages);
+    for (i = 0; i < count; i ++) {
+        ecs_stage_merge(world, &buffer[i]);
+    }
+
+    world->is_merging = false;
+
+    /* Operations recorded in deferred mode are replayed as regular operations
+     * on the main stage, which is why this happens after merging */
+    for (i = 0; i < count; i ++) {
+        ecs_stage_replay(world, &buffer[i]);
     }
 
     if (measure_frame_time) {
         world->merge_time_total += ecs_time_measure(&t_start);
     }
-
-    world->is_merging = false;
 }
 
 void ecs_set_automerge(
@@ -1371,6 +1768,39 @@ void ecs_set_automerge(
     world->auto_merge = auto_merge;
 }
 
+uint64_t ecs_world_compact(
+    ecs_world_t *world)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    return compact_world(world, false);
+}
+
+void ecs_set_compact_interval(
+    ecs_world_t *world,
+    uint32_t frames)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    world->compact_interval = frames;
+}
+
+void ecs_set_deferred_mode(
+    ecs_world_t *world,
+    bool enable)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    world->deferred_mode = enable;
+}
+
+void ecs_set_pipelined_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    world->pipelined_merge = enable;
+}
+
 void ecs_measure_frame_time(
     ecs_world_t *world,
     bool enable)
@@ -1502,6 +1932,9 @@ void ecs_set_entity_range(
 
     world->min_handle = id_start;
     world->max_handle = id_end;
+
+    /* Recycled ids outside of the new range can no longer be issued */
+    ecs_ei_filter_recycled(world->main_stage.entity_index, id_start, id_end);
 }
 
 bool ecs_enable_range_check(
@@ -62,7 +62,7 @@ int ecs_component_writer_register_component(
         }
 
         _ecs_add(world, id, world->t_component);
-        ecs_set(world, id, EcsComponent, {writer->size});
+        ecs_set(world, id, EcsComponent, {.size = writer->size});
         ecs_set(world, id, EcsId, {name});
 
         /* Don't overwrite component name */
@@ -187,7 +187,7 @@ void ecs_table_writer_register_table(
     ecs_entity_t *entities = ecs_vector_first(entity_vector);
     int32_t i, count = ecs_vector_count(entity_vector);
     for (i = 0; i < count; i ++) {
-        ecs_map_remove(world->main_stage.entity_index, entities[i]);
+        ecs_ei_remove(world->main_stage.entity_index, entities[i]);
     }
 
     ecs_assert(writer->table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -207,7 +207,7 @@ void ecs_table_writer_finalize_table(
 
     for (i = 0; i < count; i ++) {
         ecs_row_t row;
-        if (ecs_map_has(world->main_stage.entity_index, entities[i], &row)) {
+        if (ecs_ei_has(world->main_stage.entity_index, entities[i], &row)) {
             if (row.type != writer->table->type) {
                 ecs_table_t *table = ecs_world_get_table(world, &world->main_stage, row.type);
                 ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -222,10 +222,12 @@ void ecs_table_writer_finalize_table(
             .type = writer->table->type
         };
 
-        ecs_map_set(world->main_stage.entity_index, entities[i], &row);
+        ecs_ei_set(world->main_stage.entity_index, entities[i], &row);
 
-        if (entities[i] >= world->last_handle) {
-            world->last_handle = entities[i] + 1;
+        ecs_entity_t id = ecs_ei_id(
+            world->main_stage.entity_index, entities[i]);
+        if (id >= world->last_handle) {
+            world->last_handle = id + 1;
         }
     }   
 }
@@ -241,7 +243,10 @@ void ecs_table_writer_prepare_column(
     writer->column_size = size;
 
     if (size) {
-        ecs_vector_params_t params = {.element_size = writer->column_size};
+        ecs_vector_params_t params = {
+            .element_size = writer->column_size,
+            .alignment = writer->column->alignment
+        };
         ecs_vector_set_count(&writer->column->data, &params, writer->row_count);
     }
 
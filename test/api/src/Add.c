@@ -596,3 +596,77 @@ void Add_remove_entity() {
     
     ecs_fini(world);
 }
+
+void Add_add_remove_preserves_values() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    int i;
+    for (i = 0; i < 3; i ++) {
+        ecs_add(world, e, Mass);
+        test_assert(ecs_has(world, e, Mass));
+
+        ecs_remove(world, e, Mass);
+        test_assert(!ecs_has(world, e, Mass));
+
+        Position *p = ecs_get_ptr(world, e, Position);
+        test_assert(p != NULL);
+        test_int(p->x, 10);
+        test_int(p->y, 20);
+
+        Velocity *v = ecs_get_ptr(world, e, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, 1);
+        test_int(v->y, 2);
+    }
+    
+    ecs_fini(world);
+}
+
+void Add_add_same_type_2_entities() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+
+    /* Second add takes the same transition as the first */
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_set(world, e2, Velocity, {3, 4});
+
+    test_int(ecs_count(world, Velocity), 2);
+
+    Position *p = ecs_get_ptr(world, e1, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get_ptr(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    Velocity *v = ecs_get_ptr(world, e2, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 3);
+    test_int(v->y, 4);
+
+    /* Remove last component, and add it back */
+    ecs_remove(world, e1, Velocity);
+    ecs_remove(world, e1, Position);
+    test_assert(ecs_is_empty(world, e1));
+
+    ecs_add(world, e1, Position);
+    test_assert(ecs_has(world, e1, Position));
+    test_assert(!ecs_has(world, e1, Velocity));
+    
+    ecs_fini(world);
+}
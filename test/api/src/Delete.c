@@ -193,3 +193,216 @@ void Delete_delete_w_on_remove() {
     
     ecs_fini(world);
 }
+
+void Delete_delete_recycle_id() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+    test_assert(e2 != 0);
+    test_assert(e2 != e);
+    test_int((uint32_t)e2, (uint32_t)e);
+    test_assert(ecs_has(world, e2, Position));
+
+    /* Old handle does not refer to the new entity */
+    test_assert(ecs_is_empty(world, e));
+    test_assert(!ecs_has(world, e, Position));
+    test_assert(ecs_get_ptr(world, e, Position) == NULL);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_stale_handle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_delete(world, e);
+
+    /* Deleting with the old handle again must not recycle the id twice */
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_entity_t e3 = ecs_new(world, Position);
+    test_int((uint32_t)e2, (uint32_t)e);
+    test_assert((uint32_t)e3 != (uint32_t)e);
+
+    /* Deleting the stale handle does not delete the new entity */
+    ecs_delete(world, e);
+    test_assert(ecs_has(world, e2, Position));
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEntity, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_progress(world, 0);
+
+    test_assert(ecs_is_empty(world, e));
+
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_assert(e2 != e);
+    test_int((uint32_t)e2, (uint32_t)e);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_w_entity_range() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_delete(world, e);
+
+    /* Recycled id is outside of the range and may not be reused */
+    ecs_set_entity_range(world, 5000, 0);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+    test_int(e2, 5000);
+
+    ecs_delete(world, e2);
+
+    ecs_entity_t e3 = ecs_new(world, Position);
+    test_int((uint32_t)e3, 5000);
+    test_assert(e3 != e2);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_w_id_above_32_bits() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    /* Id is equal to the handle the next recycle of e would issue */
+    ecs_entity_t e_hi = e | ((ecs_entity_t)1 << 32);
+    ecs_set(world, e_hi, Position, {10, 20});
+
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+    test_int((uint32_t)e2, (uint32_t)e);
+    test_assert(e2 != e);
+    test_assert(e2 != e_hi);
+
+    Position *p = ecs_get_ptr(world, e_hi, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_delete(world, e2);
+    test_assert(ecs_has(world, e_hi, Position));
+    
+    ecs_fini(world);
+}
+
+static
+void DeleteEvenOrLast(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        int x = p[i].x;
+        if (!(x % 2) || x >= 17) {
+            ecs_delete(rows->world, rows->entities[i]);
+        }
+    }
+}
+
+void Delete_delete_many_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEvenOrLast, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 20);
+    test_assert(e != 0);
+
+    int i;
+    for (i = 0; i < 20; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    ecs_progress(world, 0);
+
+    test_int( ecs_count(world, Position), 8);
+
+    for (i = 0; i < 20; i ++) {
+        if (!(i % 2) || i >= 17) {
+            test_assert( ecs_is_empty(world, e + i));
+        } else {
+            Position *p = ecs_get_ptr(world, e + i, Position);
+            test_assert(p != NULL);
+            test_int(p->x, i);
+            test_int(p->y, i * 2);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+static int removed_count;
+static int removed_sum;
+
+static
+void OnRemoveSum(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        removed_count ++;
+        removed_sum += p[i].x;
+    }
+}
+
+void Delete_delete_many_in_progress_w_on_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEvenOrLast, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, OnRemoveSum, EcsOnRemove, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 20);
+    test_assert(e != 0);
+
+    int i, sum = 0;
+    for (i = 0; i < 20; i ++) {
+        ecs_set(world, e + i, Position, {i, 0});
+        if (!(i % 2) || i >= 17) {
+            sum += i;
+        }
+    }
+
+    removed_count = 0;
+    removed_sum = 0;
+
+    ecs_progress(world, 0);
+
+    test_int( ecs_count(world, Position), 8);
+    test_int(removed_count, 12);
+    test_int(removed_sum, sum);
+
+    ecs_fini(world);
+}
@@ -387,3 +387,83 @@ void FilterIter_iter_snapshot_filtered_table() {
     
     ecs_fini(world);
 }
+
+void FilterIter_iter_w_prefab() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_PREFAB(world, Prefab, Velocity);
+    ECS_TYPE(world, Type, INSTANCEOF | Prefab, Position);
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    ecs_new_w_count(world, Movable, 2);
+    ecs_new_w_count(world, Type, 3);
+    ecs_new_w_count(world, Position, 4);
+
+    ecs_filter_iter_t it = ecs_filter_iter(world, &(ecs_filter_t){
+        .include = ecs_type(Movable)
+    });
+
+    int table_count = 0;
+    int entity_count = 0;
+
+    while (ecs_filter_next(&it)) {
+        table_count ++;
+        entity_count += it.rows.count;
+    }
+
+    /* The table with INSTANCEOF|Prefab inherits Velocity from the prefab */
+    test_int(table_count, 2);
+    test_int(entity_count, 5);
+    test_int(ecs_count(world, Movable), 5);
+
+    ecs_fini(world);
+}
+
+void FilterIter_iter_rarest_component() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_COMPONENT(world, Rotation);
+
+    ECS_TYPE(world, Type_1, Position, Velocity);
+    ECS_TYPE(world, Type_2, Position, Mass);
+    ECS_TYPE(world, Type_3, Position, Rotation);
+    ECS_TYPE(world, Type_4, Position, Velocity, Mass);
+    ECS_TYPE(world, Type_5, Position, Mass, Rotation);
+
+    ecs_new_w_count(world, Position, 1);
+    ecs_new_w_count(world, Type_1, 2);
+    ecs_new_w_count(world, Type_2, 3);
+    ecs_new_w_count(world, Type_3, 4);
+    ecs_new_w_count(world, Type_4, 5);
+    ecs_new_w_count(world, Type_5, 6);
+
+    ecs_filter_iter_t it = ecs_filter_iter(world, &(ecs_filter_t){
+        .include = ecs_type(Type_2)
+    });
+
+    /* Tables are returned in the order in which they were created */
+    test_assert(ecs_filter_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Type_2));
+    test_int(it.rows.count, 3);
+
+    test_assert(ecs_filter_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Type_4));
+    test_int(it.rows.count, 5);
+
+    test_assert(ecs_filter_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Type_5));
+    test_int(it.rows.count, 6);
+
+    test_assert(!ecs_filter_next(&it));
+
+    test_int(ecs_count(world, Type_2), 14);
+    test_int(ecs_count(world, Position), 21);
+
+    ecs_fini(world);
+}
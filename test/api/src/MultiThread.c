@@ -1049,3 +1049,1038 @@ void MultiThread_reactive_system() {
 
     ecs_fini(world);
 }
+
+void MultiThread_2_thread_20_systems() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    int i, ENTITIES = 100, SYSTEMS = 20;
+
+    for (i = 0; i < SYSTEMS; i ++) {
+        ecs_new_system(world, NULL, EcsOnUpdate, "Position", Progress);
+    }
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_threads(world, 2);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, SYSTEMS);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_uneven_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+    ECS_TYPE(world, TypeA, Position, TagA);
+    ECS_TYPE(world, TypeB, Position, TagB);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+
+    int i, ENTITIES = 0;
+
+    ecs_entity_t e1 = ecs_new_w_count(world, Position, 1);
+    ecs_entity_t e2 = ecs_new_w_count(world, TypeA, 500);
+    ecs_entity_t e3 = ecs_new_w_count(world, TypeB, 3);
+
+    ecs_set(world, e1, Position, {0});
+    for (i = 0; i < 500; i ++) {
+        ecs_set(world, e2 + i, Position, {0});
+    }
+    for (i = 0; i < 3; i ++) {
+        ecs_set(world, e3 + i, Position, {0});
+    }
+
+    ENTITIES = ecs_count(world, Position);
+    test_int(ENTITIES, 504);
+
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    test_int(ecs_get(world, e1, Position).x, 2);
+    for (i = 0; i < 500; i ++) {
+        test_int(ecs_get(world, e2 + i, Position).x, 2);
+    }
+    for (i = 0; i < 3; i ++) {
+        test_int(ecs_get(world, e3 + i, Position).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+static uint16_t task_thread_index;
+
+static
+void MtTaskThreadIndex(ecs_rows_t *rows) {
+    task_thread_index = ecs_get_thread_index(rows->world);
+}
+
+void MultiThread_task_on_main_thread() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, MtTaskThreadIndex, EcsOnUpdate, 0);
+
+    ecs_new_w_count(world, Position, 1000);
+
+    ecs_set_threads(world, 4);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        task_thread_index = 1;
+        ecs_progress(world, 0);
+        test_int(task_thread_index, 0);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void WritePosition(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+void ReadPositionWriteVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v[i].x = p[i].x;
+    }
+}
+
+static
+void WriteVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Velocity, v, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v[i].y ++;
+    }
+}
+
+void MultiThread_6_thread_conflicting_systems() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ECS_SYSTEM(world, WritePosition, EcsOnUpdate, [out] Position);
+    ECS_SYSTEM(world, ReadPositionWriteVelocity, EcsOnUpdate, [in] Position, [out] Velocity);
+
+    int i, ENTITIES = 1000;
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e + i, Position, {0});
+        ecs_set(world, e + i, Velocity, {0});
+    }
+
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+        test_int(ecs_get(world, e + i, Velocity).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_nonconflicting_systems() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ECS_SYSTEM(world, WritePosition, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, WriteVelocity, EcsOnUpdate, Velocity);
+
+    int i, ENTITIES = 1000;
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e + i, Position, {0});
+        ecs_set(world, e + i, Velocity, {0});
+    }
+
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+        test_int(ecs_get(world, e + i, Velocity).y, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_system_activated_between_phases() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_SYSTEM(world, WritePosition, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, ReadPositionWriteVelocity, EcsOnUpdate, [in] Position, Velocity);
+
+    int i, ENTITIES = 1000;
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 1);
+        ecs_add(world, e + i, Velocity);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+        test_int(ecs_get(world, e + i, Velocity).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_200_systems() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ECS_TYPE(world, Type, Position, Tag);
+
+    int i, ENTITIES = 100, SYSTEMS = 200;
+
+    for (i = 0; i < SYSTEMS; i ++) {
+        ecs_new_system(world, NULL, EcsOnUpdate, "Position", Progress);
+    }
+
+    ecs_entity_t e1 = ecs_new_w_count(world, Position, ENTITIES);
+    ecs_entity_t e2 = ecs_new_w_count(world, Type, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e1 + i, Position, {0});
+        ecs_set(world, e2 + i, Position, {0});
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e1 + i, Position).x, SYSTEMS * 2);
+        test_int(ecs_get(world, e2 + i, Position).x, SYSTEMS * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_no_spin() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, WritePosition, EcsPostUpdate, Position);
+
+    int i, ENTITIES = 100;
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_thread_spin_time(world, 0);
+    ecs_set_threads(world, 6);
+
+    for (i = 0; i < 10; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 20);
+    }
+
+    ecs_fini(world);
+}
+
+static int expensive_invocations;
+
+static
+void ExpensiveProgress(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    ecs_type_t type = ecs_table_type(rows);
+    ecs_entity_t tag = ecs_column_entity(rows, 2);
+    bool expensive = ecs_type_has_entity(rows->world, type, tag);
+
+    if (expensive) {
+        ecs_os_ainc(&expensive_invocations);
+    }
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        if (expensive) {
+            volatile int j;
+            for (j = 0; j < 100000; j ++) { }
+        }
+
+        p[i].x ++;
+    }
+}
+
+void MultiThread_6_thread_unbalanced_cost() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Expensive);
+    ECS_TYPE(world, Type, Position, Expensive);
+    ECS_SYSTEM(world, ExpensiveProgress, EcsOnUpdate, Position, .Expensive);
+
+    int i, f, ENTITIES = 200, FRAMES = 10;
+
+    ecs_entity_t e1 = ecs_new_w_count(world, Position, ENTITIES);
+    ecs_entity_t e2 = ecs_new_w_count(world, Type, ENTITIES / 10);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_set(world, e1 + i, Position, {0});
+    }
+
+    for (i = 0; i < ENTITIES / 10; i ++) {
+        ecs_set(world, e2 + i, Position, {0});
+    }
+
+    /* Don't align jobs with tables, so that the expensive rows can be split
+     * over multiple jobs */
+    ecs_set_job_min_rows(world, 0);
+    ecs_set_threads(world, 6);
+
+    expensive_invocations = 0;
+    ecs_progress(world, 0);
+    int first_invocations = expensive_invocations;
+
+    for (f = 1; f < FRAMES; f ++) {
+        expensive_invocations = 0;
+        ecs_progress(world, 0);
+    }
+
+    /* Jobs are split by cost after the first frame, which assigns more jobs to
+     * the expensive rows */
+    test_assert(expensive_invocations > first_invocations);
+
+    /* Add rows after cost has been measured */
+    ecs_entity_t e3 = ecs_new_w_count(world, Type, ENTITIES / 10);
+    for (i = 0; i < ENTITIES / 10; i ++) {
+        ecs_set(world, e3 + i, Position, {0});
+    }
+
+    for (f = 0; f < FRAMES; f ++) {
+        ecs_progress(world, 0);
+    }
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, e1 + i, Position).x, FRAMES * 2);
+    }
+
+    for (i = 0; i < ENTITIES / 10; i ++) {
+        test_int(ecs_get(world, e2 + i, Position).x, FRAMES * 2);
+        test_int(ecs_get(world, e3 + i, Position).x, FRAMES);
+    }
+
+    ecs_fini(world);
+}
+
+static int small_table_invocations;
+
+static
+void CountSmallTables(ecs_rows_t *rows) {
+    if (rows->count < 64) {
+        ecs_os_ainc(&small_table_invocations);
+    }
+}
+
+static
+void create_small_tables(
+    ecs_world_t *world,
+    ecs_type_t type,
+    ecs_entity_t *tags,
+    int table_count,
+    int entity_count)
+{
+    int i, j, t;
+    for (i = 0; i < table_count; i ++) {
+        for (j = 0; j < entity_count; j ++) {
+            ecs_entity_t e = _ecs_new(world, type);
+            for (t = 0; t < 5; t ++) {
+                if ((i + 1) & (1 << t)) {
+                    ecs_add_entity(world, e, tags[t]);
+                }
+            }
+        }
+    }
+}
+
+void MultiThread_6_thread_small_and_large_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag0);
+    ECS_TAG(world, Tag1);
+    ECS_TAG(world, Tag2);
+    ECS_TAG(world, Tag3);
+    ECS_TAG(world, Tag4);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, CountSmallTables, EcsOnUpdate, Position);
+
+    ecs_entity_t tags[] = {Tag0, Tag1, Tag2, Tag3, Tag4};
+    create_small_tables(world, ecs_type(Position), tags, 20, 5);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    test_int(ecs_count(world, Position), 1100);
+
+    ecs_set_threads(world, 6);
+
+    small_table_invocations = 0;
+    ecs_progress(world, 0);
+    test_int(small_table_invocations, 20);
+
+    small_table_invocations = 0;
+    ecs_progress(world, 0);
+    test_int(small_table_invocations, 20);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_no_min_rows() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag0);
+    ECS_TAG(world, Tag1);
+    ECS_TAG(world, Tag2);
+    ECS_TAG(world, Tag3);
+    ECS_TAG(world, Tag4);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+
+    ecs_entity_t tags[] = {Tag0, Tag1, Tag2, Tag3, Tag4};
+    create_small_tables(world, ecs_type(Position), tags, 20, 5);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_job_min_rows(world, 0);
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 100; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+static int unaligned_invocations;
+
+static
+void CountUnaligned(ecs_rows_t *rows) {
+    if (rows->offset % 40) {
+        ecs_os_ainc(&unaligned_invocations);
+    }
+}
+
+void MultiThread_6_thread_set_min_rows_after_schedule() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, CountUnaligned, EcsOnUpdate, Position);
+
+    ecs_new_w_count(world, Position, 1000);
+
+    ecs_set_job_min_rows(world, 0);
+    ecs_set_threads(world, 6);
+
+    unaligned_invocations = 0;
+    ecs_progress(world, 0);
+    test_assert(unaligned_invocations != 0);
+
+    /* The number of jobs and rows do not change, but the jobs must be aligned
+     * with the new minimum */
+    ecs_set_job_min_rows(world, 40);
+
+    unaligned_invocations = 0;
+    ecs_progress(world, 0);
+    test_int(unaligned_invocations, 0);
+
+    ecs_fini(world);
+}
+
+static int main_thread_invocations;
+
+static
+void CountMainThread(ecs_rows_t *rows) {
+    if (!ecs_get_thread_index(rows->world)) {
+        ecs_os_ainc(&main_thread_invocations);
+    }
+}
+
+void MultiThread_6_thread_reserve_main_thread() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, CountMainThread, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, MtTaskThreadIndex, EcsOnUpdate, 0);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_reserve_main_thread(world, true);
+    ecs_set_threads(world, 6);
+
+    main_thread_invocations = 0;
+    task_thread_index = 1;
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    test_int(main_thread_invocations, 0);
+    test_int(task_thread_index, 0);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_2_thread_reserve_main_thread() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+    ECS_SYSTEM(world, CountMainThread, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_threads(world, 2);
+    ecs_set_reserve_main_thread(world, true);
+
+    main_thread_invocations = 0;
+
+    ecs_progress(world, 0);
+
+    test_int(main_thread_invocations, 0);
+
+    for (i = 0; i < 100; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 1);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_affinity() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    uint32_t cpus[] = {0};
+    for (i = 0; i < 4; i ++) {
+        ecs_set_thread_affinity(world, i, cpus, 1);
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 1);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_affinity_after_start() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Progress, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {0});
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_progress(world, 0);
+
+    uint32_t cpus[] = {0};
+    ecs_set_thread_affinity(world, 2, cpus, 1);
+    test_int(ecs_get_threads(world), 4);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 1000; i ++) {
+        test_int(ecs_get(world, e + i, Position).x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void AddVelocityFromPosition(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], Velocity, {p[i].x, p[i].y});
+    }
+}
+
+static
+void test_parallel_merge(
+    int threads,
+    int entity_count)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+    ECS_TYPE(world, TypeA, Position, TagA);
+    ECS_SYSTEM(world, AddVelocityFromPosition, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e1 = ecs_new_w_count(world, Position, entity_count);
+    ecs_entity_t e2 = ecs_new_w_count(world, TypeA, entity_count);
+
+    int i;
+    for (i = 0; i < entity_count; i ++) {
+        ecs_set(world, e1 + i, Position, {i, i * 2});
+        ecs_set(world, e2 + i, Position, {-i, -i * 2});
+    }
+
+    ecs_set_threads(world, threads);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < entity_count; i ++) {
+        test_assert( ecs_has(world, e1 + i, Velocity));
+        test_int( ecs_get(world, e1 + i, Velocity).x, i);
+        test_int( ecs_get(world, e1 + i, Velocity).y, i * 2);
+
+        test_assert( ecs_has(world, e2 + i, Velocity));
+        test_assert( ecs_has(world, e2 + i, TagA));
+        test_int( ecs_get(world, e2 + i, Velocity).x, -i);
+        test_int( ecs_get(world, e2 + i, Velocity).y, -i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_parallel_merge() {
+    test_parallel_merge(6, 5000);
+}
+
+void MultiThread_2_thread_parallel_merge() {
+    test_parallel_merge(2, 5000);
+}
+
+static
+void SetVelocityTwiceRemoveTag(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+    ECS_COLUMN_ENTITY(rows, TagA, 3);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_entity_t e = rows->entities[i];
+        ecs_set(rows->world, e, Velocity, {0, 0});
+        ecs_set(rows->world, e, Velocity, {p[i].x, p[i].y});
+        ecs_remove_entity(rows->world, e, TagA);
+
+        /* Values are not visible before the merge in deferred mode */
+        test_assert(!ecs_has(rows->world, e, Velocity));
+    }
+}
+
+void MultiThread_6_thread_deferred_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+    ECS_TYPE(world, TypeA, Position, TagA);
+    ECS_SYSTEM(world, SetVelocityTwiceRemoveTag, EcsOnUpdate, Position, .Velocity, .TagA);
+
+    ecs_entity_t e = ecs_new_w_count(world, TypeA, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    ecs_set_deferred_mode(world, true);
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < 1000; i ++) {
+        test_assert( ecs_has(world, e + i, Velocity));
+        test_assert( !ecs_has(world, e + i, TagA));
+        test_int( ecs_get(world, e + i, Velocity).x, i);
+        test_int( ecs_get(world, e + i, Velocity).y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void DeleteEven(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        if (!((int)p[i].x % 2)) {
+            ecs_delete(rows->world, rows->entities[i]);
+        }
+    }
+}
+
+void MultiThread_6_thread_deferred_delete() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEven, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, 0});
+    }
+
+    ecs_set_deferred_mode(world, true);
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+
+    test_int(ecs_count(world, Position), 500);
+
+    for (i = 0; i < 1000; i ++) {
+        test_assert( ecs_has(world, e + i, Position) == (i % 2));
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_deferred_delete_w_data() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEven, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    ecs_set_deferred_mode(world, true);
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+
+    test_int(ecs_count(world, Position), 500);
+
+    for (i = 1; i < 1000; i += 2) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    /* Deleted ids are recycled */
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_assert((uint32_t)e2 < (uint32_t)(e + 1000));
+
+    ecs_fini(world);
+}
+
+static
+void DeleteAndSetVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_entity_t e = rows->entities[i];
+        ecs_set(rows->world, e, Velocity, {1, 1});
+        ecs_delete(rows->world, e);
+        ecs_set(rows->world, e, Velocity, {p[i].x, 0});
+    }
+}
+
+void MultiThread_6_thread_deferred_delete_then_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, DeleteAndSetVelocity, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {i, 0});
+    }
+
+    ecs_set_deferred_mode(world, true);
+    ecs_set_threads(world, 6);
+
+    ecs_progress(world, 0);
+
+    test_int(ecs_count(world, Position), 0);
+    test_int(ecs_count(world, Velocity), 100);
+
+    for (i = 0; i < 100; i ++) {
+        test_assert( !ecs_has(world, e + i, Position));
+        test_int( ecs_get(world, e + i, Velocity).x, i);
+    }
+
+    ecs_fini(world);
+}
+
+static int velocity_added;
+static int velocity_count_in_mass;
+static ecs_world_t *pipelined_world;
+
+static
+void AddVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_add(rows->world, rows->entities[i], Velocity);
+    }
+}
+
+static
+void CountVelocityInMass(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+    /* Count entities in main stage */
+    velocity_count_in_mass = ecs_count(pipelined_world, Velocity);
+}
+
+static
+void CountVelocity(ecs_rows_t *rows) {
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_os_ainc(&velocity_added);
+    }
+}
+
+void MultiThread_6_thread_pipelined_merge() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_SYSTEM(world, AddVelocity, EcsPreUpdate, Position, .Velocity);
+    ECS_SYSTEM(world, CountVelocityInMass, EcsOnUpdate, Mass, .Velocity);
+
+    ecs_new_w_count(world, Position, 100);
+    ecs_new(world, Mass);
+
+    ecs_set_pipelined_merge(world, true);
+    ecs_set_threads(world, 6);
+
+    pipelined_world = world;
+    velocity_count_in_mass = -1;
+
+    ecs_progress(world, 0);
+
+    /* CountVelocityInMass does not access Velocity or Position, so the merge
+     * of the PreUpdate phase is postponed until after the OnUpdate phase */
+    test_int(velocity_count_in_mass, 0);
+    test_int(ecs_count(world, Velocity), 100);
+
+    /* Without pipelining, the merge happens before the OnUpdate phase */
+    ecs_set_pipelined_merge(world, false);
+    ecs_new_w_count(world, Position, 100);
+
+    ecs_progress(world, 0);
+
+    test_int(velocity_count_in_mass, 200);
+    test_int(ecs_count(world, Velocity), 200);
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_pipelined_merge_conflict() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_SYSTEM(world, AddVelocity, EcsPreUpdate, Position, .Velocity);
+    ECS_SYSTEM(world, CountVelocity, EcsOnUpdate, Velocity);
+
+    ecs_new_w_count(world, Position, 100);
+
+    ecs_set_pipelined_merge(world, true);
+    ecs_set_threads(world, 6);
+
+    velocity_added = 0;
+
+    ecs_progress(world, 0);
+
+    /* CountVelocity matches with the staged Velocity component, so the
+     * PreUpdate phase must be merged before it runs */
+    test_int(velocity_added, 100);
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_pipelined_merge_not_operator() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, AddVelocity, EcsPreUpdate, Position, .Velocity);
+    ECS_SYSTEM(world, CountVelocity, EcsOnUpdate, Position, !Velocity);
+
+    ecs_new_w_count(world, Position, 100);
+
+    ecs_set_pipelined_merge(world, true);
+    ecs_set_threads(world, 6);
+
+    velocity_added = 0;
+
+    ecs_progress(world, 0);
+
+    /* All entities have Velocity after the merge, so none should match */
+    test_int(velocity_added, 0);
+
+    ecs_fini(world);
+}
+
+#define TAG_COUNT (8)
+
+static ecs_type_t tag_types[TAG_COUNT];
+
+static
+void AddTagCombination(ecs_rows_t *rows) {
+    int i, t;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_entity_t e = rows->entities[i];
+        for (t = 0; t < TAG_COUNT; t ++) {
+            if (e & (1 << t)) {
+                _ecs_add(rows->world, e, tag_types[t]);
+            }
+        }
+    }
+}
+
+void MultiThread_8_thread_create_types() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, AddTagCombination, EcsOnUpdate, Position);
+
+    int i, t;
+    for (t = 0; t < TAG_COUNT; t ++) {
+        ecs_entity_t tag = ecs_new(world, 0);
+        tag_types[t] = ecs_type_from_entity(world, tag);
+    }
+
+    ecs_entity_t start = ecs_new_w_count(world, Position, 1000);
+
+    ecs_set_threads(world, 8);
+    ecs_progress(world, 0);
+
+    /* Worker stages register tag combinations in the shared type index */
+    for (i = 0; i < 1000; i ++) {
+        ecs_entity_t e = start + i;
+        for (t = 0; t < TAG_COUNT; t ++) {
+            test_bool(_ecs_has(world, e, tag_types[t]), (e & (1 << t)) != 0);
+        }
+    }
+
+    /* Entities with the same combination must share the same type */
+    for (i = 0; i < 1000 - 256; i ++) {
+        test_assert(ecs_get_type(world, start + i) ==
+            ecs_get_type(world, start + i + 256));
+    }
+
+    ecs_fini(world);
+}
@@ -177,3 +177,81 @@ void New_redefine_component() {
     
     ecs_fini(world);
 }
+
+void New_component_column_aligned() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+
+    /* The first entity in a table is stored at the start of the column */
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Position) % 64 == 0);
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Velocity) % 64 == 0);
+
+    /* Columns remain aligned when they grow */
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_entity_t e2 = ecs_new(world, Position);
+        ecs_add(world, e2, Velocity);
+    }
+
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Position) % 64 == 0);
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Velocity) % 64 == 0);
+
+    ecs_fini(world);
+}
+
+typedef struct Block {
+    float data[64];
+} Block;
+
+void New_aligned_component() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ALIGNED_COMPONENT(world, Block, 256);
+
+    EcsComponent *cdata = ecs_get_ptr(world, ecs_entity(Block), EcsComponent);
+    test_assert(cdata != NULL);
+    test_int(cdata->size, sizeof(Block));
+    test_int(cdata->alignment, 256);
+
+    ecs_entity_t e = ecs_new(world, Block);
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Block) % 256 == 0);
+
+    ecs_entity_t last = 0;
+    int i;
+    for (i = 0; i < 100; i ++) {
+        last = ecs_set(world, 0, Block, {{(float)i}});
+    }
+
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Block) % 256 == 0);
+    Block *b = ecs_get_ptr(world, last, Block);
+    test_assert((uintptr_t)b % 256 == 0);
+    test_flt(b->data[0], 99);
+
+    ecs_fini(world);
+}
+
+void New_aligned_component_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ALIGNED_COMPONENT(world, Block, 256);
+    ECS_COMPONENT(world, Position);
+    ECS_TYPE(world, Type, Block, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 100);
+    test_assert(e != 0);
+
+    Block *b = ecs_get_ptr(world, e, Block);
+    test_assert((uintptr_t)b % 256 == 0);
+
+    Block *b_last = ecs_get_ptr(world, e + 99, Block);
+    test_assert(b_last == &b[99]);
+
+    test_assert((uintptr_t)ecs_get_ptr(world, e, Position) % 64 == 0);
+
+    ecs_fini(world);
+}
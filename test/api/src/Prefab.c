@@ -2709,3 +2709,128 @@ void Prefab_create_multiple_nested_w_on_add_in_progress() {
 
     ecs_fini(world);
 }
+
+static
+void Prefab_w_shared_Mass(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Mass, m, 1);
+    ECS_COLUMN(rows, Position, p, 2);
+
+    test_assert(ecs_is_shared(rows, 1));
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x = *m;
+        p[i].y = *m * 2;
+    }
+}
+
+void Prefab_ref_after_realloc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+    ECS_PREFAB(world, Prefab, Mass);
+    ECS_SYSTEM(world, Prefab_w_shared_Mass, EcsManual, Mass, Position);
+
+    ecs_set(world, Prefab, Mass, {5});
+
+    ecs_entity_t e = ecs_new_instance(world, Prefab, 0);
+    ecs_add(world, e, Position);
+
+    ecs_run(world, Prefab_w_shared_Mass, 1, NULL);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 5);
+    test_int(p->y, 10);
+
+    /* Grow the table of the prefab, which reallocs the column with its Mass.
+     * Ids are not copied, so they must outlive the world. */
+    static char ids[100][16];
+    int i;
+    for (i = 0; i < 100; i ++) {
+        sprintf(ids[i], "Prefab_%d", i);
+        ecs_new_prefab(world, ids[i], "Mass");
+    }
+
+    ecs_set(world, Prefab, Mass, {3});
+
+    /* The reference is valid without progressing the world */
+    ecs_run(world, Prefab_w_shared_Mass, 1, NULL);
+
+    p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 3);
+    test_int(p->y, 6);
+
+    ecs_fini(world);
+}
+
+static float prefab_position_x;
+
+static
+void Prefab_read_shared_Position(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    test_assert(ecs_is_shared(rows, 1));
+    prefab_position_x = p->x;
+}
+
+void Prefab_ref_after_prefab_moved() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_PREFAB(world, P1, Position);
+    ECS_PREFAB(world, P2, Position);
+    ECS_TYPE(world, Type, INSTANCEOF | P1, Velocity);
+    ECS_SYSTEM(world, Prefab_read_shared_Position, EcsOnUpdate, Position, Velocity);
+
+    ecs_set(world, P1, Position, {10, 20});
+    ecs_set(world, P2, Position, {30, 40});
+    ecs_new(world, Type);
+
+    ecs_progress(world, 1);
+    test_int(prefab_position_x, 10);
+
+    /* Move P1 to another table. P2 takes the row of P1 in the old table. */
+    ecs_add(world, P1, Mass);
+
+    ecs_progress(world, 1);
+    test_int(prefab_position_x, 10);
+
+    ecs_set(world, P1, Position, {11, 21});
+
+    ecs_progress(world, 1);
+    test_int(prefab_position_x, 11);
+
+    ecs_fini(world);
+}
+
+void Prefab_ref_after_prefab_moved_from_own_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_PREFAB(world, P1, Position);
+    ECS_TYPE(world, Type, INSTANCEOF | P1, Velocity);
+    ECS_SYSTEM(world, Prefab_read_shared_Position, EcsOnUpdate, Position, Velocity);
+
+    ecs_set(world, P1, Position, {10, 20});
+    ecs_new(world, Type);
+
+    ecs_progress(world, 1);
+    test_int(prefab_position_x, 10);
+
+    /* Move P1 to another table, which leaves its old table empty */
+    ecs_add(world, P1, Mass);
+
+    ecs_set(world, P1, Position, {11, 21});
+
+    ecs_progress(world, 1);
+    test_int(prefab_position_x, 11);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,267 @@
+#include <api.h>
+
+void Query_query_one_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 3);
+    test_assert(e != 0);
+
+    int i;
+    for (i = 0; i < 3; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_assert(q != NULL);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    int table_count = 0;
+    int entity_count = 0;
+
+    while (ecs_query_next(&it)) {
+        table_count ++;
+        entity_count += it.rows.count;
+
+        test_assert(ecs_table_type(&it.rows) == ecs_type(Position));
+        Position *row = ecs_table_column(&it.rows, 0);
+        test_assert(row != NULL);
+
+        for (i = 0; i < it.rows.count; i ++) {
+            test_int(row[i].x, i);
+            test_int(row[i].y, i * 2);
+        }
+    }
+
+    test_int(table_count, 1);
+    test_int(entity_count, 3);
+
+    ecs_fini(world);
+}
+
+void Query_query_two_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    ecs_new_w_count(world, Position, 3);
+    ecs_new_w_count(world, Movable, 2);
+    ecs_new_w_count(world, Velocity, 1);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    int table_count = 0;
+    int entity_count = 0;
+
+    while (ecs_query_next(&it)) {
+        table_count ++;
+        entity_count += it.rows.count;
+    }
+
+    test_int(table_count, 2);
+    test_int(entity_count, 5);
+
+    ecs_fini(world);
+}
+
+void Query_query_new_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_int(ecs_query_table_count(q), 0);
+
+    ecs_new_w_count(world, Position, 3);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_new_w_count(world, Movable, 2);
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_new_w_count(world, Velocity, 1);
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    int entity_count = 0;
+
+    while (ecs_query_next(&it)) {
+        entity_count += it.rows.count;
+    }
+
+    test_int(entity_count, 5);
+
+    ecs_fini(world);
+}
+
+void Query_query_skip_empty_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    /* Moving the entity leaves an empty table with only Position */
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    test_assert(ecs_query_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Movable));
+    test_int(it.rows.count, 1);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_query_table_becomes_empty() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    test_assert(ecs_query_next(&it));
+    test_int(it.rows.count, 1);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_delete(world, e);
+
+    it = ecs_query_iter(q);
+    test_assert(!ecs_query_next(&it));
+    test_int(ecs_query_table_count(q), 1);
+
+    e = ecs_new(world, Position);
+
+    it = ecs_query_iter(q);
+    test_assert(ecs_query_next(&it));
+    test_int(it.rows.count, 1);
+    test_assert(it.rows.entities[0] == e);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_query_exclude() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    ecs_new_w_count(world, Position, 3);
+    ecs_new_w_count(world, Movable, 2);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position),
+        .exclude = ecs_type(Velocity)
+    });
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    test_assert(ecs_query_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Position));
+    test_int(it.rows.count, 3);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_query_free() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+
+    ecs_query_t *q_1 = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    ecs_query_t *q_2 = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    ecs_query_free(q_1);
+
+    /* Table activation should only notify remaining query */
+    ecs_delete(world, e);
+    ecs_new(world, Position);
+    ecs_new(world, Velocity);
+
+    test_int(ecs_query_table_count(q_2), 1);
+
+    ecs_query_iter_t it = ecs_query_iter(q_2);
+    test_assert(ecs_query_next(&it));
+    test_int(it.rows.count, 1);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+static
+void AddVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_add(rows->world, rows->entities[i], Velocity);
+    }
+}
+
+void Query_query_new_table_after_merge() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, AddVelocity, EcsOnUpdate, Position, .Velocity);
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+
+    ecs_new_w_count(world, Position, 3);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Velocity)
+    });
+    test_int(ecs_query_table_count(q), 0);
+
+    /* Table is created in the stage, and added to the query when merged */
+    ecs_progress(world, 1);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    test_assert(ecs_query_next(&it));
+    test_assert(ecs_table_type(&it.rows) == ecs_type(Movable));
+    test_int(it.rows.count, 3);
+    test_assert(!ecs_query_next(&it));
+
+    ecs_fini(world);
+}
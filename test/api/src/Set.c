@@ -320,3 +320,75 @@ void Set_set_null() {
 
     ecs_fini(world);
 }
+
+void Set_set_hi_component_id() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Mass);
+
+    /* Use up ids, so the next components get ids above the direct index */
+    ecs_new_w_count(world, 0, 300);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    test_assert(ecs_entity(Position) > 256);
+    test_assert(ecs_entity(Velocity) > 256);
+
+    ecs_entity_t e = ecs_set(world, 0, Mass, {5});
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    Mass *m = ecs_get_ptr(world, e, Mass);
+    test_assert(m != NULL);
+    test_int(*m, 5);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    Velocity *v = ecs_get_ptr(world, e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_remove(world, e, Position);
+    test_assert(ecs_get_ptr(world, e, Position) == NULL);
+    test_assert(ecs_get_ptr(world, e, Velocity) != NULL);
+
+    ecs_fini(world);
+}
+
+void Set_set_many_components() {
+    ecs_world_t *world = ecs_init();
+
+    /* Component ids are not copied, so they must outlive the world */
+    static char ids[40][16];
+    ecs_entity_t components[40];
+    ecs_entity_t e = ecs_new(world, 0);
+
+    int i;
+    for (i = 0; i < 40; i ++) {
+        sprintf(ids[i], "C%d", i);
+        components[i] = ecs_new_component(world, ids[i], sizeof(int));
+
+        /* Spread components over direct index and hashed lookup */
+        ecs_new_w_count(world, 0, 10);
+    }
+
+    for (i = 0; i < 40; i ++) {
+        ecs_type_t type = ecs_type_from_entity(world, components[i]);
+        int value = i * 10;
+        _ecs_set_ptr(world, e, components[i], sizeof(int), &value);
+        test_assert(_ecs_has(world, e, type));
+    }
+
+    for (i = 0; i < 40; i ++) {
+        ecs_type_t type = ecs_type_from_entity(world, components[i]);
+        int *ptr = _ecs_get_ptr(world, e, type);
+        test_assert(ptr != NULL);
+        test_int(*ptr, i * 10);
+    }
+
+    ecs_fini(world);
+}
@@ -574,3 +574,45 @@ void Snapshot_snapshot_copy_w_filter() {
 
     ecs_fini(world);
 }
+
+void Snapshot_snapshot_restore_after_compact() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {1, 2});
+
+    ecs_snapshot_t *s = ecs_snapshot_take(world, NULL);
+
+    ecs_delete(world, e2);
+    test_assert(ecs_world_compact(world) > 0);
+
+    ecs_entity_t e3 = ecs_set(world, 0, Velocity, {5, 6});
+    test_assert(e3 != 0);
+
+    ecs_snapshot_restore(world, s);
+
+    test_int( ecs_count(world, Position), 2);
+    test_int( ecs_count(world, Velocity), 1);
+    test_assert( ecs_has(world, e1, Position));
+    test_assert( ecs_has(world, e2, Position));
+    test_assert( ecs_has(world, e2, Velocity));
+    test_assert( ecs_is_empty(world, e3));
+
+    Position *p = ecs_get_ptr(world, e1, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get_ptr(world, e2, Position);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    Velocity *v = ecs_get_ptr(world, e2, Velocity);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,397 @@
+#include <api.h>
+
+static
+void install_test_abort() {
+    ecs_os_set_api_defaults();
+    ecs_os_api_t os_api = ecs_os_api;
+    os_api.abort = test_abort;
+    ecs_os_set_api(&os_api);
+}
+
+static
+void AddTag(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Tag, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        test_assert( !ecs_has(rows->world, rows->entities[i], Tag));
+        ecs_add(rows->world, rows->entities[i], Tag);
+        test_assert( !ecs_has(rows->world, rows->entities[i], Tag));
+    }
+}
+
+static
+void Count(ecs_rows_t *rows) {
+    int *count = ecs_get_context(rows->world);
+    *count += rows->count;
+}
+
+void Sparse_add_remove_tag() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e = ecs_new(world, 0);
+    test_assert(e != 0);
+
+    ecs_add(world, e, Tag);
+    test_assert( ecs_has(world, e, Tag));
+
+    ecs_remove(world, e, Tag);
+    test_assert( !ecs_has(world, e, Tag));
+
+    ecs_add(world, e, Tag);
+    test_assert( ecs_has(world, e, Tag));
+
+    ecs_fini(world);
+}
+
+void Sparse_type_unchanged() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ECS_TYPE(world, Type, Position, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_type_t type = ecs_get_type(world, e);
+
+    ecs_add(world, e, Tag);
+    test_assert( ecs_has(world, e, Tag));
+    test_assert( ecs_has(world, e, Type));
+    test_assert(ecs_get_type(world, e) == type);
+
+    ecs_remove(world, e, Tag);
+    test_assert( !ecs_has(world, e, Tag));
+    test_assert( !ecs_has(world, e, Type));
+    test_assert(ecs_get_type(world, e) == type);
+
+    ecs_entity_t e2 = ecs_new(world, Type);
+    test_assert( ecs_has(world, e2, Position));
+    test_assert( ecs_has(world, e2, Tag));
+    test_assert(ecs_get_type(world, e2) == type);
+
+    ecs_fini(world);
+}
+
+void Sparse_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ECS_TYPE(world, Type, Position, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_entity_t e3 = ecs_new(world, 0);
+
+    test_int(ecs_count(world, Tag), 0);
+
+    ecs_add(world, e1, Tag);
+    ecs_add(world, e2, Tag);
+    ecs_add(world, e3, Tag);
+
+    test_int(ecs_count(world, Tag), 3);
+    test_int(ecs_count(world, Type), 2);
+    test_int(ecs_count(world, Position), 2);
+
+    ecs_remove(world, e2, Tag);
+    test_int(ecs_count(world, Tag), 2);
+    test_int(ecs_count(world, Type), 1);
+
+    ecs_fini(world);
+}
+
+void Sparse_system_w_sparse_tag() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, Count, EcsOnUpdate, Position, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_entity_t e3 = ecs_new(world, Position);
+    ecs_new(world, Position);
+
+    int count = 0;
+    ecs_set_context(world, &count);
+
+    ecs_progress(world, 1);
+    test_int(count, 0);
+
+    ecs_add(world, e1, Tag);
+    ecs_add(world, e3, Tag);
+
+    ecs_progress(world, 1);
+    test_int(count, 2);
+
+    ecs_add(world, e2, Tag);
+    ecs_remove(world, e3, Tag);
+
+    count = 0;
+    ecs_progress(world, 1);
+    test_int(count, 2);
+
+    ecs_fini(world);
+}
+
+void Sparse_system_w_not_sparse_tag() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, Count, EcsOnUpdate, Position, !Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_new(world, Position);
+    ecs_new(world, Position);
+
+    int count = 0;
+    ecs_set_context(world, &count);
+
+    ecs_progress(world, 1);
+    test_int(count, 3);
+
+    ecs_add(world, e1, Tag);
+
+    count = 0;
+    ecs_progress(world, 1);
+    test_int(count, 2);
+
+    ecs_fini(world);
+}
+
+void Sparse_system_w_sparse_tag_and_component() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, ProbeSystem, EcsOnUpdate, Position, Tag);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {1, 2});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {3, 4});
+    ecs_entity_t e3 = ecs_set(world, 0, Position, {5, 6});
+
+    ecs_add(world, e2, Tag);
+    ecs_add(world, e3, Tag);
+    test_assert(e1 != 0);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+
+    test_int(ctx.count, 2);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.column_count, 2);
+    test_int(ctx.e[0], e2);
+    test_int(ctx.e[1], e3);
+    test_int(ctx.c[0][0], ecs_entity(Position));
+    test_int(ctx.s[0][0], 0);
+    test_int(ctx.c[0][1], Tag);
+    test_int(ctx.s[0][1], 0);
+
+    ecs_fini(world);
+}
+
+void Sparse_toggle_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, AddTag, EcsOnUpdate, Position, .Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_type_t type = ecs_get_type(world, e1);
+
+    ecs_progress(world, 1);
+
+    test_assert( ecs_has(world, e1, Tag));
+    test_assert( ecs_has(world, e2, Tag));
+    test_assert(ecs_get_type(world, e1) == type);
+    test_assert(ecs_get_type(world, e2) == type);
+    test_int(ecs_count(world, Tag), 2);
+
+    ecs_fini(world);
+}
+
+void Sparse_delete_removes_tag() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_add(world, e1, Tag);
+    ecs_add(world, e2, Tag);
+    test_int(ecs_count(world, Tag), 2);
+
+    ecs_delete(world, e1);
+    test_assert( !ecs_has(world, e1, Tag));
+    test_int(ecs_count(world, Tag), 1);
+
+    ecs_delete_w_filter(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_assert( !ecs_has(world, e2, Tag));
+    test_int(ecs_count(world, Tag), 0);
+
+    ecs_fini(world);
+}
+
+void Sparse_snapshot_restore() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, Count, EcsOnUpdate, Position, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_add(world, e1, Tag);
+
+    ecs_snapshot_t *s = ecs_snapshot_take(world, NULL);
+
+    ecs_remove(world, e1, Tag);
+    ecs_add(world, e2, Tag);
+    test_assert( !ecs_has(world, e1, Tag));
+    test_assert( ecs_has(world, e2, Tag));
+
+    ecs_snapshot_restore(world, s);
+
+    test_assert( ecs_has(world, e1, Tag));
+    test_assert( !ecs_has(world, e2, Tag));
+    test_int(ecs_count(world, Tag), 1);
+
+    int count = 0;
+    ecs_set_context(world, &count);
+
+    ecs_progress(world, 1);
+    test_int(count, 1);
+
+    ecs_fini(world);
+}
+
+void Sparse_clone() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_add(world, e1, Tag);
+
+    ecs_entity_t e2 = ecs_clone(world, e1, false);
+    test_assert(e2 != 0);
+    test_assert( ecs_has(world, e2, Position));
+    test_assert( ecs_has(world, e2, Tag));
+    test_int(ecs_count(world, Tag), 2);
+
+    ecs_fini(world);
+}
+
+void Sparse_add_remove_w_filter() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+    ecs_entity_t e3 = ecs_new(world, Velocity);
+
+    ecs_add_remove_w_filter(world, Tag, 0, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    test_assert( ecs_has(world, e1, Tag));
+    test_assert( ecs_has(world, e2, Tag));
+    test_assert( !ecs_has(world, e3, Tag));
+
+    ecs_add_remove_w_filter(world, 0, Tag, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    test_assert( !ecs_has(world, e1, Tag));
+    test_assert( !ecs_has(world, e2, Tag));
+    test_int(ecs_count(world, Tag), 0);
+
+    ecs_fini(world);
+}
+
+void Sparse_2_threads_toggle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ecs_set_sparse(world, Tag);
+
+    ECS_SYSTEM(world, AddTag, EcsOnUpdate, Position, .Tag);
+    ECS_SYSTEM(world, Count, EcsPostUpdate, Position, Tag);
+
+    ecs_entity_t start = ecs_new_w_count(world, Position, 100);
+
+    int count = 0;
+    ecs_set_context(world, &count);
+
+    ecs_set_threads(world, 2);
+
+    ecs_progress(world, 1);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert( ecs_has(world, start + i, Tag));
+    }
+
+    test_int(count, 100);
+
+    ecs_fini(world);
+}
+
+void Sparse_set_sparse_after_system() {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ECS_SYSTEM(world, Count, EcsOnUpdate, Position, Tag);
+
+    test_expect_abort();
+
+    ecs_set_sparse(world, Tag);
+}
+
+void Sparse_set_sparse_after_not_system() {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+    ECS_SYSTEM(world, Count, EcsOnUpdate, Position, !Tag);
+
+    test_expect_abort();
+
+    ecs_set_sparse(world, Tag);
+}
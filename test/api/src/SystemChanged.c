@@ -0,0 +1,430 @@
+#include <api.h>
+
+static
+void Read(ecs_rows_t *rows) {
+    ProbeSystem(rows);
+}
+
+static
+void ReadAll(ecs_rows_t *rows) {
+    ProbeSystem(rows);
+}
+
+static
+void Write(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+void SetPosition(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Position, 2);
+    ecs_entity_t e = *(ecs_entity_t*)rows->param;
+    ecs_set(rows->world, e, Position, {10, 20});
+}
+
+void SystemChanged_run_first_frame() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 2);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_skip_unchanged() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 4);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_new() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_new(world, Position);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 3);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_add() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+    ecs_entity_t e = ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    /* Entity moves to a new table, which has not yet been seen by system */
+    ecs_add(world, e, Velocity);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 3);
+    test_int(ctx.e[2], e);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_out_system() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Write, EcsPreUpdate, [out] Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 3);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_skip_after_in_system() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ECS_SYSTEM(world, ReadAll, EcsPreUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+
+    /* Read is invoked once for itself, ReadAll is invoked every frame */
+    test_int(ctx.invoked, 4);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_write_in_later_phase() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ECS_SYSTEM(world, Write, EcsPostUpdate, [out] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    /* Write ran after Read in the previous frame */
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+
+    ecs_enable(world, Write, false);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 3);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 3);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_skip_own_write() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Write, EcsOnUpdate, Position);
+    ecs_set_system_changed_only(world, Write, true);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {0, 0});
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 1);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_skip_other_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_entity_t e_1 = ecs_new(world, Position);
+    ecs_entity_t e_2 = ecs_new(world, Type);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 2);
+
+    ecs_set(world, e_2, Position, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 3);
+    test_int(ctx.count, 3);
+    test_int(ctx.e[2], e_2);
+
+    ecs_set(world, e_1, Position, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 4);
+    test_int(ctx.count, 4);
+    test_int(ctx.e[3], e_1);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_skip_unwatched_column() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position, [out] Velocity);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_entity_t e = ecs_new(world, Type);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_set(world, e, Velocity, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_container_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] CONTAINER.Position, [in] Velocity);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_entity_t parent = ecs_set(world, 0, Position, {1, 2});
+    ecs_entity_t child = ecs_new_child(world, parent, Velocity);
+    test_assert(child != 0);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_set(world, parent, Position, {10, 20});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.e[1], child);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_staged_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, SetPosition, EcsPreUpdate, Velocity, .Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_new(world, Velocity);
+    ecs_set_system_context(world, SetPosition, &e);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    /* SetPosition sets the component every frame */
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+
+    ecs_enable(world, SetPosition, false);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 2);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_disable_changed_only() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new(world, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+
+    ecs_set_system_changed_only(world, Read, false);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 3);
+
+    ecs_fini(world);
+}
+
+void SystemChanged_run_after_out_system_w_threads() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Write, EcsPreUpdate, [out] Position, Velocity);
+    ECS_SYSTEM(world, Read, EcsOnUpdate, [in] Position);
+    ecs_set_system_changed_only(world, Read, true);
+
+    ecs_new_w_count(world, Position, 10);
+    ecs_new_w_count(world, Type, 10);
+
+    ecs_set_threads(world, 2);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    int invoked = ctx.invoked;
+    test_assert(invoked >= 2);
+    test_int(ctx.count, 20);
+
+    /* Only the table with Velocity is written */
+    ecs_progress(world, 1);
+    test_int(ctx.count, 30);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 40);
+
+    ecs_fini(world);
+}
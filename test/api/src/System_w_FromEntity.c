@@ -139,3 +139,87 @@ void System_w_FromEntity_task_not_from_entity() {
 
     ecs_fini(world);
 }
+
+void System_w_FromEntity_ref_after_realloc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_ENTITY(world, e_1, Mass);
+    ECS_ENTITY(world, e_2, Position);
+
+    ECS_SYSTEM(world, Iter, EcsManual, e_1.Mass, Position);
+
+    ecs_set(world, e_1, Mass, {5});
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_run(world, Iter, 1, NULL);
+
+    Position *p = ecs_get_ptr(world, e_2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 50);
+    test_int(p->y, 100);
+
+    /* Grow the table of e_1, which reallocs the column with its Mass. Ids are
+     * not copied, so they must outlive the world. */
+    static char ids[100][16];
+    int i;
+    for (i = 0; i < 100; i ++) {
+        sprintf(ids[i], "e_%d", i + 3);
+        ecs_new_entity(world, ids[i], "Mass");
+    }
+
+    ecs_set(world, e_1, Mass, {2});
+
+    /* The reference is valid without progressing the world */
+    ecs_run(world, Iter, 1, NULL);
+
+    p = ecs_get_ptr(world, e_2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 20);
+    test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void System_w_FromEntity_ref_after_delete() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+
+    /* Store e_1 last in its table, so it moves when e_3 is deleted */
+    ecs_entity_t e_3 = ecs_new_entity(world, "e_3", "Mass");
+    ECS_ENTITY(world, e_1, Mass);
+    ECS_ENTITY(world, e_2, Position);
+
+    ECS_SYSTEM(world, Iter, EcsOnUpdate, e_1.Mass, Position);
+
+    ecs_set(world, e_3, Mass, {3});
+    ecs_set(world, e_1, Mass, {5});
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+
+    Position *p = ecs_get_ptr(world, e_2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 50);
+    test_int(p->y, 100);
+
+    ecs_delete(world, e_3);
+    ecs_set(world, e_1, Mass, {2});
+
+    ecs_progress(world, 1);
+
+    p = ecs_get_ptr(world, e_2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 20);
+    test_int(p->y, 40);
+
+    ecs_fini(world);
+}
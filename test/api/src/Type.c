@@ -820,3 +820,137 @@ void Type_type_to_expr_childof() {
 
     ecs_fini(world);
 }
+
+void Type_type_find_same_array() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_entity_t a1[] = {ecs_entity(Velocity), ecs_entity(Position)};
+    ecs_entity_t a2[] = {ecs_entity(Position), ecs_entity(Velocity)};
+    ecs_entity_t a3[] = {ecs_entity(Position), ecs_entity(Mass)};
+
+    ecs_type_t t1 = ecs_type_find(world, a1, 2);
+    ecs_type_t t2 = ecs_type_find(world, a2, 2);
+    ecs_type_t t3 = ecs_type_find(world, a3, 2);
+
+    test_assert(t1 != NULL);
+    test_assert(t1 == t2);
+    test_assert(t1 != t3);
+    test_int(ecs_vector_count(t1), 2);
+    test_int(ecs_vector_count(t3), 2);
+
+    ecs_type_t t4 = ecs_type_merge(world, ecs_type(Position), ecs_type(Velocity), 0);
+    test_assert(t4 == t1);
+
+    ecs_fini(world);
+}
+
+void Type_type_find_hi_ids() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_new_w_count(world, 0, 1000);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_entity_t a1[] = {ecs_entity(Position), ecs_entity(Velocity), ecs_entity(Mass)};
+    ecs_entity_t a2[] = {ecs_entity(Mass), ecs_entity(Velocity), ecs_entity(Position)};
+
+    ecs_type_t t1 = ecs_type_find(world, a1, 3);
+    ecs_type_t t2 = ecs_type_find(world, a2, 3);
+
+    test_assert(t1 != NULL);
+    test_assert(t1 == t2);
+    test_int(ecs_vector_count(t1), 3);
+    test_assert(ecs_type_has_entity(world, t1, ecs_entity(Mass)));
+
+    ecs_fini(world);
+}
+
+void Type_type_has_entity_signature_collision() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e1 = ecs_new(world, 0);
+    ecs_new_w_count(world, 0, 127);
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_int(e2 - e1, 128);
+
+    ecs_type_t t = ecs_type_find(world, &e1, 1);
+    test_assert(t != NULL);
+    test_assert(ecs_type_has_entity(world, t, e1));
+    test_assert(!ecs_type_has_entity(world, t, e2));
+    test_assert(!ecs_type_has_entity(world, t, e2 + 128));
+
+    ecs_fini(world);
+}
+
+void Type_type_contains_signature_collision() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e1 = ecs_new(world, 0);
+    ecs_new_w_count(world, 0, 127);
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_int(e2 - e1, 128);
+
+    ecs_entity_t a1[] = {ecs_entity(Position), e1};
+    ecs_entity_t a2[] = {ecs_entity(Position), e2};
+
+    ecs_type_t t1 = ecs_type_find(world, a1, 2);
+    ecs_type_t t2 = ecs_type_find(world, a2, 2);
+    test_assert(t1 != t2);
+
+    ecs_entity_t e = _ecs_new(world, t1);
+    test_assert(_ecs_has(world, e, t1));
+    test_assert(!_ecs_has(world, e, t2));
+    test_assert(_ecs_has_any(world, e, t2));
+
+    ecs_fini(world);
+}
+
+void Type_type_has_any_signature_collision() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e1 = ecs_new(world, 0);
+    ecs_new_w_count(world, 0, 127);
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_int(e2 - e1, 128);
+
+    ecs_type_t t1 = ecs_type_find(world, &e1, 1);
+    ecs_type_t t2 = ecs_type_find(world, &e2, 1);
+
+    ecs_entity_t e = _ecs_new(world, t1);
+    test_assert(_ecs_has_any(world, e, t1));
+    test_assert(!_ecs_has_any(world, e, t2));
+
+    test_int(_ecs_count(world, t1), 1);
+    test_int(_ecs_count(world, t2), 0);
+
+    ecs_fini(world);
+}
+
+void Type_type_contains_prefab_signature() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_PREFAB(world, Base, Position);
+
+    ecs_entity_t e = ecs_new_instance(world, Base, Velocity);
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Velocity));
+    test_assert(!ecs_has_owned(world, e, Position));
+    test_assert(ecs_has_entity(world, e, ecs_entity(Position)));
+    test_assert(!ecs_has_entity_owned(world, e, ecs_entity(Position)));
+
+    ECS_TYPE(world, Movable, Position, Velocity);
+    test_assert(ecs_has(world, e, Movable));
+    test_assert(!ecs_has_owned(world, e, Movable));
+
+    ecs_fini(world);
+}
@@ -164,6 +164,153 @@ void World_entity_range_out_of_range_check_disabled() {
     ecs_fini(world);
 }
 
+void World_entity_range_far_offset() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_entity_range(world, 5000000, 0);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    test_int(e, 5000000);
+
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    test_int(e2, 5000001);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get_ptr(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    test_int(ecs_count(world, Position), 2);
+
+    ecs_fini(world);
+}
+
+void World_entity_stale_generation() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    test_assert(e != 0);
+
+    ecs_entity_t stale = e | ((ecs_entity_t)1 << 32);
+    test_assert(!ecs_has(world, stale, Position));
+    test_assert(ecs_get_ptr(world, stale, Position) == NULL);
+    test_assert(ecs_is_empty(world, stale));
+
+    test_assert(ecs_has(world, e, Position));
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
+
+void World_entity_id_above_generation() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ((ecs_entity_t)1 << 50) | 10;
+    ecs_set(world, e, Position, {10, 20});
+    test_assert(ecs_has(world, e, Position));
+    test_assert(!ecs_has(world, 10, Position));
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_delete(world, e);
+    test_assert(!ecs_has(world, e, Position));
+
+    ecs_fini(world);
+}
+
+void World_entity_id_above_32_bits() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    test_assert(e != 0);
+
+    /* Id has the lower 32 bits of e, but is not a recycled handle of e */
+    ecs_entity_t e_hi = ((ecs_entity_t)1 << 33) | e;
+    ecs_set(world, e_hi, Position, {30, 40});
+    test_assert(ecs_has(world, e_hi, Position));
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get_ptr(world, e_hi, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_delete(world, e_hi);
+    test_assert(!ecs_has(world, e_hi, Position));
+    test_assert(ecs_has(world, e, Position));
+
+    ecs_fini(world);
+}
+
+void World_entity_range_above_32_bits() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e_lo = ecs_set(world, 0, Position, {1, 2});
+    test_assert(e_lo != 0);
+
+    ecs_entity_t start = (ecs_entity_t)1 << 33;
+    ecs_set_entity_range(world, start, 0);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    test_assert(e1 == start);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+    test_assert(e2 == start + 1);
+
+    ecs_entity_t e3 = start + 100;
+    ecs_set(world, e3, Position, {30, 40});
+
+    Position *p = ecs_get_ptr(world, e1, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get_ptr(world, e3, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    p = ecs_get_ptr(world, e_lo, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 1);
+    test_int(p->y, 2);
+
+    /* Ids above 2^32 are not recycled */
+    ecs_delete(world, e1);
+    test_assert(!ecs_has(world, e1, Position));
+
+    ecs_entity_t e4 = ecs_new(world, Position);
+    test_assert(e4 == start + 2);
+    test_assert(ecs_has(world, e2, Position));
+
+    ecs_fini(world);
+}
+
 void AddToExisting(ecs_rows_t *rows) {
     ECS_COLUMN_COMPONENT(rows, Velocity, 2);
 
@@ -329,13 +476,13 @@ void World_dim_type() {
 
     ecs_new_w_count(world, Position, 500);
 
-    test_int(malloc_count, 2);
+    test_int(malloc_count, 1);
 
     malloc_count = 0;
 
     ecs_new_w_count(world, Position, 400);
 
-    test_int(malloc_count, 2);
+    test_int(malloc_count, 1);
 
     ecs_fini(world);
 }
@@ -1082,3 +1229,290 @@ void World_is_entity_enabled() {
 
     ecs_fini(world);
 }
+
+void World_compact_release_empty_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, Velocity);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_new(world, Type);
+    ecs_set(world, e2, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {3, 4});
+
+    ecs_entity_t e3 = ecs_set(world, 0, Velocity, {5, 6});
+    ecs_delete(world, e3);
+
+    test_assert(ecs_world_compact(world) > 0);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+
+    test_int(ctx.count, 2);
+    test_int(ctx.invoked, 1);
+
+    Position *p = ecs_get_ptr(world, e1, Position);
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = ecs_get_ptr(world, e2, Position);
+    test_int(p->x, 33);
+    test_int(p->y, 44);
+
+    /* Remove all entities from the table the system is matched with */
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+
+    test_assert(ecs_world_compact(world) > 0);
+
+    ctx = (SysTestData){0};
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 0);
+
+    /* Recreating an entity creates the table and matches it with the system */
+    ecs_entity_t e4 = ecs_new(world, Type);
+    ecs_set(world, e4, Position, {50, 60});
+    ecs_set(world, e4, Velocity, {5, 6});
+
+    ecs_progress(world, 1);
+
+    test_int(ctx.count, 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.e[0], e4);
+
+    p = ecs_get_ptr(world, e4, Position);
+    test_int(p->x, 55);
+    test_int(p->y, 66);
+
+    e3 = ecs_set(world, 0, Velocity, {7, 8});
+    test_assert( ecs_has(world, e3, Velocity));
+    test_assert( !ecs_has(world, e3, Position));
+
+    ecs_fini(world);
+}
+
+void World_compact_shrink_columns() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+    test_assert(e != 0);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    for (i = 10; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    test_assert(ecs_world_compact(world) >= 990 * sizeof(Position));
+
+    test_int( ecs_count(world, Position), 10);
+
+    for (i = 0; i < 10; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    /* Table can grow again after shrinking */
+    ecs_entity_t e2 = ecs_new_w_count(world, Position, 100);
+    test_assert(e2 != 0);
+    test_int( ecs_count(world, Position), 110);
+
+    ecs_fini(world);
+}
+
+void World_compact_w_query() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_new(world, Type);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Position)
+    });
+    test_assert(q != NULL);
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_delete(world, e2);
+
+    test_assert(ecs_world_compact(world) > 0);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_query_iter_t it = ecs_query_iter(q);
+    int table_count = 0;
+    int entity_count = 0;
+
+    while (ecs_query_next(&it)) {
+        table_count ++;
+        entity_count += it.rows.count;
+        test_assert(it.rows.entities[0] == e1);
+    }
+
+    test_int(table_count, 1);
+    test_int(entity_count, 1);
+
+    ecs_new(world, Type);
+    test_int(ecs_query_table_count(q), 2);
+
+    ecs_fini(world);
+}
+
+void World_compact_w_inactive_system() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Type);
+    ecs_delete(world, e);
+
+    /* System only has an empty table, and is inactive */
+    test_assert(ecs_world_compact(world) > 0);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 0);
+
+    e = ecs_new(world, Type);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_progress(world, 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_int(ctx.e[0], e);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    ecs_fini(world);
+}
+
+void World_compact_interval() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_IMPORT(world, FlecsStats, 0);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    /* Make sure that stats are collected by requiring EcsMemoryStats */
+    ecs_new_system(world, "CollectMemoryStats", EcsManual, "[in] EcsMemoryStats", NULL);
+
+    ecs_progress(world, 1);
+
+    EcsMemoryStats stats = ecs_get(world, EcsWorld, EcsMemoryStats);
+    test_int(stats.reclaimed_bytes_total, 0);
+
+    ecs_query_t *q = ecs_query_new(world, &(ecs_filter_t){
+        .include = ecs_type(Velocity)
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e = ecs_new(world, Type);
+    ecs_delete(world, e);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_set_compact_interval(world, 2);
+
+    /* First compaction marks the table as empty, but does not release it */
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ecs_query_table_count(q), 1);
+
+    stats = ecs_get(world, EcsWorld, EcsMemoryStats);
+    uint64_t reclaimed = stats.reclaimed_bytes_total;
+
+    /* Table is released if it is still empty at the next compaction */
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ecs_query_table_count(q), 0);
+
+    ecs_progress(world, 1);
+    stats = ecs_get(world, EcsWorld, EcsMemoryStats);
+    test_assert(stats.reclaimed_bytes_total > reclaimed);
+
+    /* Table is not released if it was used in between compactions */
+    e = ecs_new(world, Type);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    ecs_delete(world, e);
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ecs_query_table_count(q), 1);
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(ecs_query_table_count(q), 0);
+
+    ecs_fini(world);
+}
+
+static
+void ReadSharedPosition(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    test_assert(ecs_is_shared(rows, 1));
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v[i].x = p->x;
+        v[i].y = p->y;
+    }
+}
+
+void World_compact_w_prefab_ref() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_PREFAB(world, Prefab, Position);
+    ECS_TYPE(world, Type, INSTANCEOF | Prefab, Velocity);
+    ECS_SYSTEM(world, ReadSharedPosition, EcsManual, Position, Velocity);
+
+    ecs_set(world, Prefab, Position, {10, 20});
+    ecs_entity_t e = ecs_new(world, Type);
+
+    ecs_run(world, ReadSharedPosition, 1, NULL);
+    test_int(ecs_get(world, e, Velocity).x, 10);
+
+    /* The table of the prefab is empty after the prefab moves, and is kept
+     * with its columns freed when the world is compacted */
+    ecs_add(world, Prefab, Mass);
+    ecs_set(world, Prefab, Position, {11, 21});
+    test_assert(ecs_world_compact(world) > 0);
+
+    ecs_run(world, ReadSharedPosition, 1, NULL);
+    test_int(ecs_get(world, e, Velocity).x, 11);
+    test_int(ecs_get(world, e, Velocity).y, 21);
+
+    ecs_fini(world);
+}
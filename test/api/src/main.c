@@ -21,6 +21,9 @@ void New_type_w_tag(void);
 void New_type_w_2_tags(void);
 void New_type_w_tag_mixed(void);
 void New_redefine_component(void);
+void New_component_column_aligned(void);
+void New_aligned_component(void);
+void New_aligned_component_w_count(void);
 
 // Testsuite 'New_w_Count'
 void New_w_Count_empty(void);
@@ -103,6 +106,8 @@ void Add_add_2_remove(void);
 void Add_on_add_after_new_type_in_progress(void);
 void Add_add_entity(void);
 void Add_remove_entity(void);
+void Add_add_remove_preserves_values(void);
+void Add_add_same_type_2_entities(void);
 
 // Testsuite 'Remove'
 void Remove_zero(void);
@@ -199,6 +204,13 @@ void Delete_delete_2nd_of_3(void);
 void Delete_delete_2_of_3(void);
 void Delete_delete_3_of_3(void);
 void Delete_delete_w_on_remove(void);
+void Delete_delete_recycle_id(void);
+void Delete_delete_recycle_stale_handle(void);
+void Delete_delete_recycle_in_progress(void);
+void Delete_delete_recycle_w_entity_range(void);
+void Delete_delete_recycle_w_id_above_32_bits(void);
+void Delete_delete_many_in_progress(void);
+void Delete_delete_many_in_progress_w_on_remove(void);
 
 // Testsuite 'Delete_w_filter'
 void Delete_w_filter_delete_1(void);
@@ -228,6 +240,8 @@ void Set_set_remove_other(void);
 void Set_set_remove_twice(void);
 void Set_set_and_new(void);
 void Set_set_null(void);
+void Set_set_hi_component_id(void);
+void Set_set_many_components(void);
 
 // Testsuite 'Lookup'
 void Lookup_lookup(void);
@@ -481,6 +495,23 @@ void SystemManual_disabled(void);
 void SystemManual_activate_status(void);
 void SystemManual_no_automerge(void);
 
+// Testsuite 'SystemChanged'
+void SystemChanged_run_first_frame(void);
+void SystemChanged_skip_unchanged(void);
+void SystemChanged_run_after_set(void);
+void SystemChanged_run_after_new(void);
+void SystemChanged_run_after_add(void);
+void SystemChanged_run_after_out_system(void);
+void SystemChanged_skip_after_in_system(void);
+void SystemChanged_run_after_write_in_later_phase(void);
+void SystemChanged_skip_own_write(void);
+void SystemChanged_skip_other_table(void);
+void SystemChanged_skip_unwatched_column(void);
+void SystemChanged_run_after_container_set(void);
+void SystemChanged_run_after_staged_set(void);
+void SystemChanged_disable_changed_only(void);
+void SystemChanged_run_after_out_system_w_threads(void);
+
 // Testsuite 'Tasks'
 void Tasks_no_components(void);
 void Tasks_one_tag(void);
@@ -583,6 +614,9 @@ void Prefab_clone_after_inherit_in_on_add(void);
 void Prefab_override_from_nested(void);
 void Prefab_create_multiple_nested_w_on_add(void);
 void Prefab_create_multiple_nested_w_on_add_in_progress(void);
+void Prefab_ref_after_realloc(void);
+void Prefab_ref_after_prefab_moved(void);
+void Prefab_ref_after_prefab_moved_from_own_table(void);
 
 // Testsuite 'System_w_FromContainer'
 void System_w_FromContainer_1_column_from_container(void);
@@ -623,6 +657,8 @@ void System_w_FromSystem_auto_add_tag(void);
 void System_w_FromEntity_2_column_1_from_entity(void);
 void System_w_FromEntity_task_from_entity(void);
 void System_w_FromEntity_task_not_from_entity(void);
+void System_w_FromEntity_ref_after_realloc(void);
+void System_w_FromEntity_ref_after_delete(void);
 
 // Testsuite 'World'
 void World_progress_w_0(void);
@@ -658,6 +694,17 @@ void World_init_w_args_enable_dbg(void);
 void World_no_threading(void);
 void World_no_time(void);
 void World_is_entity_enabled(void);
+void World_entity_range_far_offset(void);
+void World_entity_stale_generation(void);
+void World_entity_id_above_generation(void);
+void World_entity_id_above_32_bits(void);
+void World_entity_range_above_32_bits(void);
+void World_compact_release_empty_tables(void);
+void World_compact_shrink_columns(void);
+void World_compact_w_query(void);
+void World_compact_w_inactive_system(void);
+void World_compact_interval(void);
+void World_compact_w_prefab_ref(void);
 
 // Testsuite 'Type'
 void Type_type_of_1_tostr(void);
@@ -708,6 +755,12 @@ void Type_type_to_expr_1_comp(void);
 void Type_type_to_expr_2_comp(void);
 void Type_type_to_expr_instanceof(void);
 void Type_type_to_expr_childof(void);
+void Type_type_find_same_array(void);
+void Type_type_find_hi_ids(void);
+void Type_type_has_entity_signature_collision(void);
+void Type_type_contains_signature_collision(void);
+void Type_type_has_any_signature_collision(void);
+void Type_type_contains_prefab_signature(void);
 
 // Testsuite 'Run'
 void Run_run(void);
@@ -770,6 +823,32 @@ void MultiThread_change_thread_count(void);
 void MultiThread_multithread_quit(void);
 void MultiThread_schedule_w_tasks(void);
 void MultiThread_reactive_system(void);
+void MultiThread_2_thread_20_systems(void);
+void MultiThread_6_thread_uneven_tables(void);
+void MultiThread_task_on_main_thread(void);
+void MultiThread_6_thread_conflicting_systems(void);
+void MultiThread_6_thread_nonconflicting_systems(void);
+void MultiThread_6_thread_system_activated_between_phases(void);
+void MultiThread_4_thread_200_systems(void);
+void MultiThread_6_thread_no_spin(void);
+void MultiThread_6_thread_unbalanced_cost(void);
+void MultiThread_6_thread_small_and_large_tables(void);
+void MultiThread_6_thread_no_min_rows(void);
+void MultiThread_6_thread_reserve_main_thread(void);
+void MultiThread_2_thread_reserve_main_thread(void);
+void MultiThread_4_thread_affinity(void);
+void MultiThread_4_thread_affinity_after_start(void);
+void MultiThread_6_thread_parallel_merge(void);
+void MultiThread_2_thread_parallel_merge(void);
+void MultiThread_6_thread_deferred_set(void);
+void MultiThread_6_thread_deferred_delete(void);
+void MultiThread_6_thread_deferred_delete_then_set(void);
+void MultiThread_6_thread_pipelined_merge(void);
+void MultiThread_6_thread_pipelined_merge_conflict(void);
+void MultiThread_6_thread_pipelined_merge_not_operator(void);
+void MultiThread_8_thread_create_types(void);
+void MultiThread_6_thread_deferred_delete_w_data(void);
+void MultiThread_6_thread_set_min_rows_after_schedule(void);
 
 // Testsuite 'SingleThreadStaging'
 void SingleThreadStaging_new_empty(void);
@@ -867,6 +946,7 @@ void Snapshot_snapshot_activate_table_w_filter(void);
 void Snapshot_snapshot_copy(void);
 void Snapshot_snapshot_copy_filtered(void);
 void Snapshot_snapshot_copy_w_filter(void);
+void Snapshot_snapshot_restore_after_compact(void);
 
 // Testsuite 'ReaderWriter'
 void ReaderWriter_simple(void);
@@ -901,6 +981,18 @@ void FilterIter_iter_snapshot_one_table(void);
 void FilterIter_iter_snapshot_two_tables(void);
 void FilterIter_iter_snapshot_two_comps(void);
 void FilterIter_iter_snapshot_filtered_table(void);
+void FilterIter_iter_w_prefab(void);
+void FilterIter_iter_rarest_component(void);
+
+// Testsuite 'Query'
+void Query_query_one_table(void);
+void Query_query_two_tables(void);
+void Query_query_new_table(void);
+void Query_query_skip_empty_table(void);
+void Query_query_table_becomes_empty(void);
+void Query_query_exclude(void);
+void Query_query_free(void);
+void Query_query_new_table_after_merge(void);
 
 // Testsuite 'Modules'
 void Modules_simple_module(void);
@@ -917,6 +1009,22 @@ void Internals_activate_deactivate_reactive(void);
 void Internals_activate_deactivate_activate_other(void);
 void Internals_no_double_system_table_after_merge(void);
 
+// Testsuite 'Sparse'
+void Sparse_add_remove_tag(void);
+void Sparse_type_unchanged(void);
+void Sparse_count(void);
+void Sparse_system_w_sparse_tag(void);
+void Sparse_system_w_not_sparse_tag(void);
+void Sparse_system_w_sparse_tag_and_component(void);
+void Sparse_toggle_in_progress(void);
+void Sparse_delete_removes_tag(void);
+void Sparse_snapshot_restore(void);
+void Sparse_clone(void);
+void Sparse_add_remove_w_filter(void);
+void Sparse_2_threads_toggle(void);
+void Sparse_set_sparse_after_system(void);
+void Sparse_set_sparse_after_not_system(void);
+
 // Testsuite 'Error'
 void Error_setup(void);
 void Error_abort(void);
@@ -934,7 +1042,7 @@ void Error_log_error(void);
 static bake_test_suite suites[] = {
     {
         .id = "New",
-        .testcase_count = 12,
+        .testcase_count = 15,
         .testcases = (bake_test_case[]){
             {
                 .id = "empty",
@@ -983,6 +1091,18 @@ static bake_test_suite suites[] = {
             {
                 .id = "redefine_component",
                 .function = New_redefine_component
+            },
+            {
+                .id = "component_column_aligned",
+                .function = New_component_column_aligned
+            },
+            {
+                .id = "aligned_component",
+                .function = New_aligned_component
+            },
+            {
+                .id = "aligned_component_w_count",
+                .function = New_aligned_component_w_count
             }
         }
     },
@@ -1180,7 +1300,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Add",
-        .testcase_count = 31,
+        .testcase_count = 33,
         .testcases = (bake_test_case[]){
             {
                 .id = "zero",
@@ -1305,6 +1425,14 @@ static bake_test_suite suites[] = {
             {
                 .id = "remove_entity",
                 .function = Add_remove_entity
+            },
+            {
+                .id = "add_remove_preserves_values",
+                .function = Add_add_remove_preserves_values
+            },
+            {
+                .id = "add_same_type_2_entities",
+                .function = Add_add_same_type_2_entities
             }
         }
     },
@@ -1640,7 +1768,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Delete",
-        .testcase_count = 9,
+        .testcase_count = 16,
         .testcases = (bake_test_case[]){
             {
                 .id = "delete_1",
@@ -1677,6 +1805,34 @@ static bake_test_suite suites[] = {
             {
                 .id = "delete_w_on_remove",
                 .function = Delete_delete_w_on_remove
+            },
+            {
+                .id = "delete_recycle_id",
+                .function = Delete_delete_recycle_id
+            },
+            {
+                .id = "delete_recycle_stale_handle",
+                .function = Delete_delete_recycle_stale_handle
+            },
+            {
+                .id = "delete_recycle_in_progress",
+                .function = Delete_delete_recycle_in_progress
+            },
+            {
+                .id = "delete_recycle_w_entity_range",
+                .function = Delete_delete_recycle_w_entity_range
+            },
+            {
+                .id = "delete_recycle_w_id_above_32_bits",
+                .function = Delete_delete_recycle_w_id_above_32_bits
+            },
+            {
+                .id = "delete_many_in_progress",
+                .function = Delete_delete_many_in_progress
+            },
+            {
+                .id = "delete_many_in_progress_w_on_remove",
+                .function = Delete_delete_many_in_progress_w_on_remove
             }
         }
     },
@@ -1736,7 +1892,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Set",
-        .testcase_count = 13,
+        .testcase_count = 15,
         .testcases = (bake_test_case[]){
             {
                 .id = "set_empty",
@@ -1789,6 +1945,14 @@ static bake_test_suite suites[] = {
             {
                 .id = "set_null",
                 .function = Set_set_null
+            },
+            {
+                .id = "set_hi_component_id",
+                .function = Set_set_hi_component_id
+            },
+            {
+                .id = "set_many_components",
+                .function = Set_set_many_components
             }
         }
     },
@@ -2778,6 +2942,72 @@ static bake_test_suite suites[] = {
             }
         }
     },
+    {
+        .id = "SystemChanged",
+        .testcase_count = 15,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "run_first_frame",
+                .function = SystemChanged_run_first_frame
+            },
+            {
+                .id = "skip_unchanged",
+                .function = SystemChanged_skip_unchanged
+            },
+            {
+                .id = "run_after_set",
+                .function = SystemChanged_run_after_set
+            },
+            {
+                .id = "run_after_new",
+                .function = SystemChanged_run_after_new
+            },
+            {
+                .id = "run_after_add",
+                .function = SystemChanged_run_after_add
+            },
+            {
+                .id = "run_after_out_system",
+                .function = SystemChanged_run_after_out_system
+            },
+            {
+                .id = "skip_after_in_system",
+                .function = SystemChanged_skip_after_in_system
+            },
+            {
+                .id = "run_after_write_in_later_phase",
+                .function = SystemChanged_run_after_write_in_later_phase
+            },
+            {
+                .id = "skip_own_write",
+                .function = SystemChanged_skip_own_write
+            },
+            {
+                .id = "skip_other_table",
+                .function = SystemChanged_skip_other_table
+            },
+            {
+                .id = "skip_unwatched_column",
+                .function = SystemChanged_skip_unwatched_column
+            },
+            {
+                .id = "run_after_container_set",
+                .function = SystemChanged_run_after_container_set
+            },
+            {
+                .id = "run_after_staged_set",
+                .function = SystemChanged_run_after_staged_set
+            },
+            {
+                .id = "disable_changed_only",
+                .function = SystemChanged_disable_changed_only
+            },
+            {
+                .id = "run_after_out_system_w_threads",
+                .function = SystemChanged_run_after_out_system_w_threads
+            }
+        }
+    },
     {
         .id = "Tasks",
         .testcase_count = 7,
@@ -2928,7 +3158,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Prefab",
-        .testcase_count = 63,
+        .testcase_count = 66,
         .testcases = (bake_test_case[]){
             {
                 .id = "new_w_prefab",
@@ -3181,6 +3411,18 @@ static bake_test_suite suites[] = {
             {
                 .id = "create_multiple_nested_w_on_add_in_progress",
                 .function = Prefab_create_multiple_nested_w_on_add_in_progress
+            },
+            {
+                .id = "ref_after_realloc",
+                .function = Prefab_ref_after_realloc
+            },
+            {
+                .id = "ref_after_prefab_moved",
+                .function = Prefab_ref_after_prefab_moved
+            },
+            {
+                .id = "ref_after_prefab_moved_from_own_table",
+                .function = Prefab_ref_after_prefab_moved_from_own_table
             }
         }
     },
@@ -3320,7 +3562,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "System_w_FromEntity",
-        .testcase_count = 3,
+        .testcase_count = 5,
         .testcases = (bake_test_case[]){
             {
                 .id = "2_column_1_from_entity",
@@ -3333,12 +3575,20 @@ static bake_test_suite suites[] = {
             {
                 .id = "task_not_from_entity",
                 .function = System_w_FromEntity_task_not_from_entity
+            },
+            {
+                .id = "ref_after_realloc",
+                .function = System_w_FromEntity_ref_after_realloc
+            },
+            {
+                .id = "ref_after_delete",
+                .function = System_w_FromEntity_ref_after_delete
             }
         }
     },
     {
         .id = "World",
-        .testcase_count = 33,
+        .testcase_count = 44,
         .testcases = (bake_test_case[]){
             {
                 .id = "progress_w_0",
@@ -3471,12 +3721,56 @@ static bake_test_suite suites[] = {
             {
                 .id = "is_entity_enabled",
                 .function = World_is_entity_enabled
+            },
+            {
+                .id = "entity_range_far_offset",
+                .function = World_entity_range_far_offset
+            },
+            {
+                .id = "entity_stale_generation",
+                .function = World_entity_stale_generation
+            },
+            {
+                .id = "entity_id_above_generation",
+                .function = World_entity_id_above_generation
+            },
+            {
+                .id = "entity_id_above_32_bits",
+                .function = World_entity_id_above_32_bits
+            },
+            {
+                .id = "entity_range_above_32_bits",
+                .function = World_entity_range_above_32_bits
+            },
+            {
+                .id = "compact_release_empty_tables",
+                .function = World_compact_release_empty_tables
+            },
+            {
+                .id = "compact_shrink_columns",
+                .function = World_compact_shrink_columns
+            },
+            {
+                .id = "compact_w_query",
+                .function = World_compact_w_query
+            },
+            {
+                .id = "compact_w_inactive_system",
+                .function = World_compact_w_inactive_system
+            },
+            {
+                .id = "compact_interval",
+                .function = World_compact_interval
+            },
+            {
+                .id = "compact_w_prefab_ref",
+                .function = World_compact_w_prefab_ref
             }
         }
     },
     {
         .id = "Type",
-        .testcase_count = 48,
+        .testcase_count = 54,
         .testcases = (bake_test_case[]){
             {
                 .id = "type_of_1_tostr",
@@ -3669,6 +3963,30 @@ static bake_test_suite suites[] = {
             {
                 .id = "type_to_expr_childof",
                 .function = Type_type_to_expr_childof
+            },
+            {
+                .id = "type_find_same_array",
+                .function = Type_type_find_same_array
+            },
+            {
+                .id = "type_find_hi_ids",
+                .function = Type_type_find_hi_ids
+            },
+            {
+                .id = "type_has_entity_signature_collision",
+                .function = Type_type_has_entity_signature_collision
+            },
+            {
+                .id = "type_contains_signature_collision",
+                .function = Type_type_contains_signature_collision
+            },
+            {
+                .id = "type_has_any_signature_collision",
+                .function = Type_type_has_any_signature_collision
+            },
+            {
+                .id = "type_contains_prefab_signature",
+                .function = Type_type_contains_prefab_signature
             }
         }
     },
@@ -3776,7 +4094,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "MultiThread",
-        .testcase_count = 34,
+        .testcase_count = 60,
         .testcases = (bake_test_case[]){
             {
                 .id = "2_thread_1_entity",
@@ -3913,6 +4231,110 @@ static bake_test_suite suites[] = {
             {
                 .id = "reactive_system",
                 .function = MultiThread_reactive_system
+            },
+            {
+                .id = "2_thread_20_systems",
+                .function = MultiThread_2_thread_20_systems
+            },
+            {
+                .id = "6_thread_uneven_tables",
+                .function = MultiThread_6_thread_uneven_tables
+            },
+            {
+                .id = "task_on_main_thread",
+                .function = MultiThread_task_on_main_thread
+            },
+            {
+                .id = "6_thread_conflicting_systems",
+                .function = MultiThread_6_thread_conflicting_systems
+            },
+            {
+                .id = "6_thread_nonconflicting_systems",
+                .function = MultiThread_6_thread_nonconflicting_systems
+            },
+            {
+                .id = "6_thread_system_activated_between_phases",
+                .function = MultiThread_6_thread_system_activated_between_phases
+            },
+            {
+                .id = "4_thread_200_systems",
+                .function = MultiThread_4_thread_200_systems
+            },
+            {
+                .id = "6_thread_no_spin",
+                .function = MultiThread_6_thread_no_spin
+            },
+            {
+                .id = "6_thread_unbalanced_cost",
+                .function = MultiThread_6_thread_unbalanced_cost
+            },
+            {
+                .id = "6_thread_small_and_large_tables",
+                .function = MultiThread_6_thread_small_and_large_tables
+            },
+            {
+                .id = "6_thread_no_min_rows",
+                .function = MultiThread_6_thread_no_min_rows
+            },
+            {
+                .id = "6_thread_reserve_main_thread",
+                .function = MultiThread_6_thread_reserve_main_thread
+            },
+            {
+                .id = "2_thread_reserve_main_thread",
+                .function = MultiThread_2_thread_reserve_main_thread
+            },
+            {
+                .id = "4_thread_affinity",
+                .function = MultiThread_4_thread_affinity
+            },
+            {
+                .id = "4_thread_affinity_after_start",
+                .function = MultiThread_4_thread_affinity_after_start
+            },
+            {
+                .id = "6_thread_parallel_merge",
+                .function = MultiThread_6_thread_parallel_merge
+            },
+            {
+                .id = "2_thread_parallel_merge",
+                .function = MultiThread_2_thread_parallel_merge
+            },
+            {
+                .id = "6_thread_deferred_set",
+                .function = MultiThread_6_thread_deferred_set
+            },
+            {
+                .id = "6_thread_deferred_delete",
+                .function = MultiThread_6_thread_deferred_delete
+            },
+            {
+                .id = "6_thread_deferred_delete_then_set",
+                .function = MultiThread_6_thread_deferred_delete_then_set
+            },
+            {
+                .id = "6_thread_pipelined_merge",
+                .function = MultiThread_6_thread_pipelined_merge
+            },
+            {
+                .id = "6_thread_pipelined_merge_conflict",
+                .function = MultiThread_6_thread_pipelined_merge_conflict
+            },
+            {
+                .id = "6_thread_pipelined_merge_not_operator",
+                .function = MultiThread_6_thread_pipelined_merge_not_operator
+            },
+            {
+                .id = "8_thread_create_types",
+                .function = MultiThread_8_thread_create_types
+            },
+            {
+                .id = "6_thread_deferred_delete_w_data",
+                .function = MultiThread_6_thread_deferred_delete_w_data
+            },
+            {
+                .id = "6_thread_set_min_rows_after_schedule",
+                .function = MultiThread_6_thread_set_min_rows_after_schedule
             }
         }
     },
@@ -4226,7 +4648,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Snapshot",
-        .testcase_count = 17,
+        .testcase_count = 18,
         .testcases = (bake_test_case[]){
             {
                 .id = "simple_snapshot",
@@ -4295,6 +4717,10 @@ static bake_test_suite suites[] = {
             {
                 .id = "snapshot_copy_w_filter",
                 .function = Snapshot_snapshot_copy_w_filter
+            },
+            {
+                .id = "snapshot_restore_after_compact",
+                .function = Snapshot_snapshot_restore_after_compact
             }
         }
     },
@@ -4398,7 +4824,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "FilterIter",
-        .testcase_count = 7,
+        .testcase_count = 9,
         .testcases = (bake_test_case[]){
             {
                 .id = "iter_one_table",
@@ -4427,6 +4853,52 @@ static bake_test_suite suites[] = {
             {
                 .id = "iter_snapshot_filtered_table",
                 .function = FilterIter_iter_snapshot_filtered_table
+            },
+            {
+                .id = "iter_w_prefab",
+                .function = FilterIter_iter_w_prefab
+            },
+            {
+                .id = "iter_rarest_component",
+                .function = FilterIter_iter_rarest_component
+            }
+        }
+    },
+    {
+        .id = "Query",
+        .testcase_count = 8,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "query_one_table",
+                .function = Query_query_one_table
+            },
+            {
+                .id = "query_two_tables",
+                .function = Query_query_two_tables
+            },
+            {
+                .id = "query_new_table",
+                .function = Query_query_new_table
+            },
+            {
+                .id = "query_skip_empty_table",
+                .function = Query_query_skip_empty_table
+            },
+            {
+                .id = "query_table_becomes_empty",
+                .function = Query_query_table_becomes_empty
+            },
+            {
+                .id = "query_exclude",
+                .function = Query_query_exclude
+            },
+            {
+                .id = "query_free",
+                .function = Query_query_free
+            },
+            {
+                .id = "query_new_table_after_merge",
+                .function = Query_query_new_table_after_merge
             }
         }
     },
@@ -4486,6 +4958,68 @@ static bake_test_suite suites[] = {
             }
         }
     },
+    {
+        .id = "Sparse",
+        .testcase_count = 14,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "add_remove_tag",
+                .function = Sparse_add_remove_tag
+            },
+            {
+                .id = "type_unchanged",
+                .function = Sparse_type_unchanged
+            },
+            {
+                .id = "count",
+                .function = Sparse_count
+            },
+            {
+                .id = "system_w_sparse_tag",
+                .function = Sparse_system_w_sparse_tag
+            },
+            {
+                .id = "system_w_not_sparse_tag",
+                .function = Sparse_system_w_not_sparse_tag
+            },
+            {
+                .id = "system_w_sparse_tag_and_component",
+                .function = Sparse_system_w_sparse_tag_and_component
+            },
+            {
+                .id = "toggle_in_progress",
+                .function = Sparse_toggle_in_progress
+            },
+            {
+                .id = "delete_removes_tag",
+                .function = Sparse_delete_removes_tag
+            },
+            {
+                .id = "snapshot_restore",
+                .function = Sparse_snapshot_restore
+            },
+            {
+                .id = "clone",
+                .function = Sparse_clone
+            },
+            {
+                .id = "add_remove_w_filter",
+                .function = Sparse_add_remove_w_filter
+            },
+            {
+                .id = "2_threads_toggle",
+                .function = Sparse_2_threads_toggle
+            },
+            {
+                .id = "set_sparse_after_system",
+                .function = Sparse_set_sparse_after_system
+            },
+            {
+                .id = "set_sparse_after_not_system",
+                .function = Sparse_set_sparse_after_not_system
+            }
+        }
+    },
     {
         .id = "Error",
         .testcase_count = 11,
@@ -4541,5 +5075,5 @@ static bake_test_suite suites[] = {
 
 int main(int argc, char *argv[]) {
     ut_init(argv[0]);
-    return bake_test_run("api", argc, argv, suites, 42);
+    return bake_test_run("api", argc, argv, suites, 45);
 }
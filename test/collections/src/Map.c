@@ -75,14 +75,14 @@ void Map_set_rehash() {
     ecs_map_t *map = ecs_map_new(8, sizeof(char*));
     fill_map(map);
 
-    test_int(ecs_map_bucket_count(map), 10);
+    test_int(ecs_map_bucket_count(map), 16);
 
     int i;
-    for (i = 5; i < 10; i ++) {
+    for (i = 5; i < 16; i ++) {
         ecs_map_set(map, i, &(char*){"zzz"});
     }
 
-    test_int(ecs_map_bucket_count(map), 20);
+    test_int(ecs_map_bucket_count(map), 32);
     test_str(*(char**)ecs_map_get_ptr(map, 1), "hello");
     test_str(*(char**)ecs_map_get_ptr(map, 2), "world");
     test_str(*(char**)ecs_map_get_ptr(map, 3), "foo");
@@ -224,5 +224,83 @@ void Map_grow() {
 
     ecs_map_set(map, i, &v);
 
-    test_int(malloc_count, 2);
+    test_int(malloc_count, 1);
+}
+
+void Map_set_remove_many() {
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+
+    uint64_t i;
+    for (i = 0; i < 10000; i ++) {
+        uint64_t v = i * 2;
+        ecs_map_set(map, i << 8, &v);
+    }
+
+    test_int(ecs_map_count(map), 10000);
+
+    for (i = 0; i < 10000; i += 2) {
+        test_assert(ecs_map_remove(map, i << 8) == 0);
+    }
+
+    test_int(ecs_map_count(map), 5000);
+
+    for (i = 0; i < 10000; i ++) {
+        uint64_t *v = ecs_map_get_ptr(map, i << 8);
+        if (i % 2) {
+            test_assert(v != NULL);
+            test_int(*v, i * 2);
+        } else {
+            test_assert(v == NULL);
+        }
+    }
+
+    ecs_map_free(map);
+}
+
+void Map_remove_all_reinsert() {
+    ecs_map_t *map = ecs_map_new(16, sizeof(char*));
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        fill_map(map);
+        test_assert(ecs_map_remove(map, 1) == 0);
+        test_assert(ecs_map_remove(map, 2) == 0);
+        test_assert(ecs_map_remove(map, 3) == 0);
+        test_assert(ecs_map_remove(map, 4) == 0);
+        test_int(ecs_map_count(map), 0);
+    }
+
+    fill_map(map);
+    test_int(ecs_map_count(map), 4);
+    test_int(ecs_map_bucket_count(map), 32);
+    test_str(*(char**)ecs_map_get_ptr(map, 1), "hello");
+    test_str(*(char**)ecs_map_get_ptr(map, 2), "world");
+    test_str(*(char**)ecs_map_get_ptr(map, 3), "foo");
+    test_str(*(char**)ecs_map_get_ptr(map, 4), "bar");
+
+    ecs_map_free(map);
+}
+
+void Map_iter_after_remove() {
+    ecs_map_t *map = ecs_map_new(16, sizeof(char*));
+    fill_map(map);
+    test_assert(ecs_map_remove(map, 2) == 0);
+
+    uint64_t key;
+    ecs_map_iter_t it = ecs_map_iter(map);
+    test_assert(ecs_map_hasnext(&it) == true);
+    test_str(*(char**)ecs_map_next_w_key(&it, &key), "hello");
+    test_int(key, 1);
+
+    test_assert(ecs_map_hasnext(&it) == true);
+    test_str(*(char**)ecs_map_next_w_key(&it, &key), "bar");
+    test_int(key, 4);
+
+    test_assert(ecs_map_hasnext(&it) == true);
+    test_str(*(char**)ecs_map_next_w_key(&it, &key), "foo");
+    test_int(key, 3);
+
+    test_assert(ecs_map_hasnext(&it) == false);
+
+    ecs_map_free(map);
 }
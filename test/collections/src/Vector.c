@@ -328,3 +328,131 @@ void Vector_pop_elements() {
 
     ecs_vector_free(array);
 }
+
+static
+ecs_vector_params_t aligned_params = {
+    .element_size = sizeof(int),
+    .alignment = 64
+};
+
+void Vector_aligned_new() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 4);
+    test_assert(array != NULL);
+    test_int(ecs_vector_size(array), 4);
+    test_int(ecs_vector_count(array), 0);
+    test_assert((uintptr_t)ecs_vector_first(array) % 64 == 0);
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_add() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 1);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        int *elem = ecs_vector_add(&array, &aligned_params);
+        *elem = i;
+        test_assert((uintptr_t)ecs_vector_first(array) % 64 == 0);
+    }
+
+    test_int(ecs_vector_count(array), 1000);
+
+    int *buffer = ecs_vector_first(array);
+    for (i = 0; i < 1000; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_set_size() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 4);
+    array = fill_array(array);
+
+    ecs_vector_set_size(&array, &aligned_params, 100);
+    test_int(ecs_vector_size(array), 100);
+    test_assert((uintptr_t)ecs_vector_first(array) % 64 == 0);
+
+    int *buffer = ecs_vector_first(array);
+    test_int(buffer[0], 0);
+    test_int(buffer[3], 3);
+
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_reclaim() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 100);
+    int i;
+    for (i = 0; i < 10; i ++) {
+        int *elem = ecs_vector_add(&array, &aligned_params);
+        *elem = i;
+    }
+
+    ecs_vector_reclaim(&array, &aligned_params);
+    test_int(ecs_vector_size(array), 10);
+    test_assert((uintptr_t)ecs_vector_first(array) % 64 == 0);
+
+    int *buffer = ecs_vector_first(array);
+    for (i = 0; i < 10; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_copy() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 4);
+    int i;
+    for (i = 0; i < 4; i ++) {
+        int *elem = ecs_vector_add(&array, &aligned_params);
+        *elem = i;
+    }
+
+    ecs_vector_t *copy = ecs_vector_copy(array, &aligned_params);
+    test_assert(copy != NULL);
+    test_int(ecs_vector_count(copy), 4);
+    test_assert((uintptr_t)ecs_vector_first(copy) % 64 == 0);
+
+    int *buffer = ecs_vector_first(copy);
+    for (i = 0; i < 4; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(array);
+    ecs_vector_free(copy);
+}
+
+void Vector_aligned_from_unaligned() {
+    ecs_vector_t *array = ecs_vector_new(&arr_params, 4);
+    array = fill_array(array);
+
+    /* Growing with aligned parameters moves the buffer to an aligned offset */
+    ecs_vector_set_size(&array, &aligned_params, 100);
+    test_assert((uintptr_t)ecs_vector_first(array) % 64 == 0);
+
+    int *buffer = ecs_vector_first(array);
+    int i;
+    for (i = 0; i < 4; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(array);
+}
+
+void Vector_flags() {
+    ecs_vector_t *array = ecs_vector_new(&arr_params, 4);
+    test_int(ecs_vector_flags(array), 0);
+
+    ecs_vector_set_flags(array, 1);
+    test_int(ecs_vector_flags(array), 1);
+
+    /* Flags are kept when the vector is resized */
+    ecs_vector_set_size(&array, &arr_params, 100);
+    test_int(ecs_vector_flags(array), 1);
+
+    /* Flags are not copied */
+    ecs_vector_t *copy = ecs_vector_copy(array, &arr_params);
+    test_int(ecs_vector_flags(copy), 0);
+
+    ecs_vector_free(array);
+    ecs_vector_free(copy);
+}
@@ -33,6 +33,13 @@ void Vector_size_of_null(void);
 void Vector_remove_index_w_move(void);
 void Vector_set_size_smaller_than_count(void);
 void Vector_pop_elements(void);
+void Vector_aligned_new(void);
+void Vector_aligned_add(void);
+void Vector_aligned_set_size(void);
+void Vector_aligned_reclaim(void);
+void Vector_aligned_copy(void);
+void Vector_aligned_from_unaligned(void);
+void Vector_flags(void);
 
 // Testsuite 'Map'
 void Map_setup(void);
@@ -52,6 +59,9 @@ void Map_remove(void);
 void Map_remove_empty(void);
 void Map_remove_unknown(void);
 void Map_grow(void);
+void Map_set_remove_many(void);
+void Map_remove_all_reinsert(void);
+void Map_iter_after_remove(void);
 
 // Testsuite 'Chunked'
 void Chunked_setup(void);
@@ -74,7 +84,7 @@ void Chunked_memory_null(void);
 static bake_test_suite suites[] = {
     {
         .id = "Vector",
-        .testcase_count = 23,
+        .testcase_count = 30,
         .setup = Vector_setup,
         .testcases = (bake_test_case[]){
             {
@@ -168,12 +178,40 @@ static bake_test_suite suites[] = {
             {
                 .id = "pop_elements",
                 .function = Vector_pop_elements
+            },
+            {
+                .id = "aligned_new",
+                .function = Vector_aligned_new
+            },
+            {
+                .id = "aligned_add",
+                .function = Vector_aligned_add
+            },
+            {
+                .id = "aligned_set_size",
+                .function = Vector_aligned_set_size
+            },
+            {
+                .id = "aligned_reclaim",
+                .function = Vector_aligned_reclaim
+            },
+            {
+                .id = "aligned_copy",
+                .function = Vector_aligned_copy
+            },
+            {
+                .id = "aligned_from_unaligned",
+                .function = Vector_aligned_from_unaligned
+            },
+            {
+                .id = "flags",
+                .function = Vector_flags
             }
         }
     },
     {
         .id = "Map",
-        .testcase_count = 16,
+        .testcase_count = 19,
         .setup = Map_setup,
         .testcases = (bake_test_case[]){
             {
@@ -239,6 +277,18 @@ static bake_test_suite suites[] = {
             {
                 .id = "grow",
                 .function = Map_grow
+            },
+            {
+                .id = "set_remove_many",
+                .function = Map_set_remove_many
+            },
+            {
+                .id = "remove_all_reinsert",
+                .function = Map_remove_all_reinsert
+            },
+            {
+                .id = "iter_after_remove",
+                .function = Map_iter_after_remove
             }
         }
     },